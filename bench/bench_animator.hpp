@@ -0,0 +1,45 @@
+#ifndef BENCH_ANIMATOR_HPP
+#define BENCH_ANIMATOR_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "Animator.hpp"
+#include "Effects.hpp"
+
+/****************************************************************************/
+// Frame evaluation cost of a full bank: every LED plays a track (a third
+// each breathing, chasing phase-stepped and pulsing, so all easing paths
+// and segment lookups run), rendered at successive LED_FRAME_MS ticks.
+// Prints the mean and worst cost per frame and per LED, and the share of
+// the 20 ms frame budget it takes.
+template<size_t MaxLEDs>
+void benchAnimator(uint32_t frames = 500, Stream& stream = Serial) {
+    static Animator<MaxLEDs> animator;
+    const size_t third = MaxLEDs / 3;
+    animator.playRange(0, third, Effects::BREATHING_RAINBOW, 0, 50);
+    animator.playRange(third, third, Effects::CHASE, 0, 100);
+    animator.playRange(2 * third, MaxLEDs - 2 * third, Effects::PULSE_BLUE, 0, 30);
+    animator.resetStats();
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    for (uint32_t n = 0; n < frames; n++) {
+        const uint32_t tic = ESP.getCycleCount();
+        animator.render(n * LED_FRAME_MS);
+        const uint32_t spent = ESP.getCycleCount() - tic;
+        cycles += spent;
+        maxCycles = max(maxCycles, spent);
+    }
+    const float mean = static_cast<float>(cycles) / max(frames, static_cast<uint32_t>(1));
+    stream.printf("Animator benchmark: %u LEDs, %lu frames, mean %.0f / max %lu cycles per frame (%.1f per LED), %lu us max, %.2f%% of a frame\n",
+        static_cast<unsigned>(MaxLEDs), frames, mean, maxCycles, mean / MaxLEDs,
+        animator.maxFrameMicros(), mean / (ESP.getCpuFreqMHz() * 10.f * LED_FRAME_MS));
+    animator.clear();
+}
+
+// One TLC5947 bank (8 RGB buttons) and a 100-LED exterior strip
+inline void benchAnimator(Stream& stream = Serial) {
+    benchAnimator<8>(500, stream);
+    benchAnimator<100>(500, stream);
+}
+/****************************************************************************/
+#endif
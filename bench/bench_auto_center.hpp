@@ -0,0 +1,48 @@
+#ifndef BENCH_AUTO_CENTER_HPP
+#define BENCH_AUTO_CENTER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "AutoCenter.hpp"
+
+/****************************************************************************/
+// Half-hour session: the rest tilt drifts by (0.8, -0.5) deg, with sensor
+// noise on top, and the player nudges every few seconds. Reports the zero
+// error left at the end with and without auto-centering, the share of
+// windows found still, and the cost per sample.
+inline void benchAutoCenter(Stream& stream = Serial, float minutes = 30.f, float rate = SMPL_FREQ) {
+    AutoCenter center(2.f, 0.3f, 0.02f, 2.f, rate);
+    const uint32_t samples = static_cast<uint32_t>(minutes * 60.f * rate);
+    const Vec2f totalDrift(0.8f, -0.5f);
+    Vec2f zero;
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    uint32_t seed = 2024;
+    uint32_t nudgeLeft = 0;
+    float nudgeAmp = 0.f;
+    const uint32_t nudgeOdds = static_cast<uint32_t>(3.f * rate) + 1;
+    for (uint32_t n = 0; n < samples; n++) {
+        const Vec2f truth = totalDrift * (static_cast<float>(n) / samples);
+        seed = seed * 1664525u + 1013904223u;
+        const float noiseX = ((seed >> 8) & 0xFFFF) / 65535.f - 0.5f;
+        const float noiseY = ((seed >> 16) & 0xFFFF) / 65535.f - 0.5f;
+        if (nudgeLeft == 0 && (seed >> 4) % nudgeOdds == 0) {   // One every ~3 s
+            nudgeLeft = static_cast<uint32_t>(0.3f * rate) + 1;
+            nudgeAmp = 2.f + (seed & 0x7);
+        }
+        Vec2f tilt = truth + Vec2f(0.3f * noiseX, 0.3f * noiseY);
+        if (nudgeLeft) { tilt[0] += nudgeAmp * sinf(PI * nudgeLeft / (0.3f * rate + 1)); nudgeLeft--; }
+
+        const uint32_t tic = ESP.getCycleCount();
+        center.update(tilt, zero);
+        const uint32_t spent = ESP.getCycleCount() - tic;
+        cycles += spent;
+        maxCycles = max(maxCycles, spent);
+    }
+    const Vec2f left = totalDrift - zero;
+    stream.printf("AutoCenter benchmark: %.0f min, zero error %.3f deg uncorrected / %.3f deg corrected, %lu of %lu windows still, mean %lu / max %lu cycles per sample\n",
+        minutes, totalDrift.magnitude(), left.magnitude(), center.stillWindows(), center.windows(),
+        static_cast<uint32_t>(cycles / max(samples, static_cast<uint32_t>(1))), maxCycles);
+}
+/****************************************************************************/
+#endif
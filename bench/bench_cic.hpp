@@ -0,0 +1,108 @@
+#ifndef BENCH_CIC_HPP
+#define BENCH_CIC_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "CicDecimator.hpp"
+#include "CicFrontEnd.hpp"
+
+/**********************************************************************************/
+// What decimating buys over reading one sample in Ratio, as the polled
+// driver does, on synthetic data. Input: a slow 0.5 Hz tilt plus a 2 Hz
+// nudge, with white noise of `noiseLsb` rms on every sample and rounding to
+// whole LSB. Prints the output noise (rms error against the clean signal)
+// for picking vs CIC + FIR, the improvement in dB, and the cycles per input
+// sample spent decimating. Arithmetic only; see benchCicFrontEnd() for the
+// cost with the FIFO reads.
+template<uint8_t Ratio, uint8_t Stages = 3>
+void benchCic(float outRate = 100.f, float noiseLsb = 4.f, uint32_t outputs = 2000, Stream& stream = Serial) {
+    CicDecimator<Ratio, Stages, 1> cic;
+    const float inRate = outRate * Ratio;
+    // Output is late by the CIC and FIR group delay; compare against the
+    // clean signal that far back
+    const float delay = (Stages * (Ratio - 1) / 2.f + Ratio) / inRate;
+    uint32_t seed = 99;
+    auto gauss = [&]() {                        // Irwin-Hall, 12 uniforms
+        float s = -6.f;
+        for (uint8_t i = 0; i < 12; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            s += (seed >> 8) / 16777216.f;
+        }
+        return s;
+    };
+    auto clean = [&](float t) {
+        return 200.f * sinf(2.f * PI * 0.5f * t) + 40.f * sinf(2.f * PI * 2.f * t);
+    };
+
+    double pickErr = 0, cicErr = 0;
+    uint32_t counted = 0;
+    uint64_t cycles = 0;
+    const uint32_t inputs = outputs * Ratio;
+    for (uint32_t n = 0; n < inputs; n++) {
+        const float t = n / inRate;
+        const float x = clean(t) + noiseLsb * gauss();
+        const int16_t in[1] = { static_cast<int16_t>(lroundf(x)) };
+        float out[1];
+        const uint32_t tic = ESP.getCycleCount();
+        const bool ready = cic.push(in, out);
+        cycles += ESP.getCycleCount() - tic;
+        if (!ready || n < inputs / 10) { continue; }
+        const double p = in[0] - clean(t);
+        const double c = out[0] - clean(t - delay);
+        pickErr += p * p;
+        cicErr += c * c;
+        counted++;
+    }
+    if (counted == 0) { return; }
+    const float pickRms = sqrtf(pickErr / counted), cicRms = sqrtf(cicErr / counted);
+    stream.printf("CIC benchmark: ratio %u, %u stages, %.0f -> %.0f Hz, noise %.2f LSB picked / %.2f LSB decimated (%.1f dB), %.1f cycles per input sample\n",
+        Ratio, Stages, inRate, outRate, pickRms, cicRms, 20.f * log10f(pickRms / cicRms),
+        static_cast<float>(cycles) / inputs);
+}
+
+// Cost of the front end on the sensor, as Joystick::read() pays it: polled
+// at the output rate, each read() that finds its queue empty drains the
+// FIFO in one I2C burst and decimates it. Prints the drain time and the
+// time per decimated sample, I2C included, and how much of each output
+// period the bus is busy draining.
+template<uint8_t Ratio>
+void benchCicFrontEnd(Accelerometer& accel, uint32_t outputs = 200, Stream& stream = Serial) {
+    static CicFrontEnd<Ratio> frontEnd;
+    if (!accel.attachDecimator(frontEnd)) { return; }
+    delay(4 * getInterval());
+    while (accel.read()) {}                     // Entries left from the previous rate
+    accel.resetStats();
+    uint32_t got = 0;
+    for (uint32_t polls = 0; got < outputs && polls < 4 * outputs; polls++) {
+        delay(getInterval());
+        do {
+            if (accel.read()) { got++; }
+        } while (accel.available());
+    }
+    stream.printf("CIC front end benchmark: ratio %u, %lu samples from %lu FIFO entries in %lu drains (%lu overruns), drain mean %.0f / max %lu us, %.1f us per sample (I2C included, %.1f%% of the output period)\n",
+        Ratio, accel.decimatedSamples(), accel.fifoEntries(), accel.drains(), accel.overruns(), accel.meanDrainMicros(),
+        accel.maxDrainMicros(), accel.microsPerSample(), accel.microsPerSample() * SMPL_FREQ * 1e-4f);
+}
+
+// Every ratio the ADXL345 data rates allow at a 100 Hz output, offline and
+// then on the sensor
+inline void benchCic(Stream& stream = Serial) {
+    benchCic<2>(100.f, 4.f, 2000, stream);
+    benchCic<4>(100.f, 4.f, 2000, stream);
+    benchCic<8>(100.f, 4.f, 2000, stream);
+    benchCic<16>(100.f, 4.f, 2000, stream);
+    benchCic<32>(100.f, 4.f, 2000, stream);
+
+    static Accelerometer accel;
+    if (!accel.begin()) {
+        stream.println("CIC front end benchmark: no ADXL345");
+        return;
+    }
+    benchCicFrontEnd<2>(accel, 200, stream);
+    benchCicFrontEnd<4>(accel, 200, stream);
+    benchCicFrontEnd<8>(accel, 200, stream);
+    benchCicFrontEnd<16>(accel, 200, stream);
+    benchCicFrontEnd<32>(accel, 200, stream);
+}
+/**********************************************************************************/
+#endif
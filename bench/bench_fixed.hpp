@@ -0,0 +1,51 @@
+#ifndef BENCH_FIXED_HPP
+#define BENCH_FIXED_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "Fixed.hpp"
+
+/****************************************************************************/
+// The joystick shaping chain in float and in Q15.16: offset, tilt
+// projection (CORDIC for Q15.16), zero, clip, scale, cubic response.
+// Prints cycles per sample for each and the largest difference in the
+// output, so the two can be weighed on the target's FPU.
+inline void benchFixed(Stream& stream = Serial, uint32_t samples = 5000) {
+    constexpr float MAX_TILT = 12.5f;
+    const Vec3f offsetF(0.12f, -0.08f, 0.21f);
+    const Vec2f zeroF(0.4f, -0.3f);
+    const Vec3x offsetX(Fix16(0.12f), Fix16(-0.08f), Fix16(0.21f));
+    const Vec2x zeroX(Fix16(0.4f), Fix16(-0.3f));
+    const Fix16 maxTiltX(MAX_TILT), invTiltX(1.f / MAX_TILT);
+
+    uint64_t floatCycles = 0, fixedCycles = 0;
+    float worst = 0.f;
+    for (uint32_t n = 0; n < samples; n++) {
+        const float a = 0.35f * sinf(n * 0.01f);
+        const Vec3f coords(9.81f * sinf(a), 9.81f * sinf(0.5f * a), 9.81f * cosf(a));
+        const Vec3x coordsX{Fix16(coords[0]), Fix16(coords[1]), Fix16(coords[2])};
+
+        uint32_t tic = ESP.getCycleCount();
+        Vec2f f = tiltProjection(coords - offsetF) - zeroF;
+        for (size_t k = 0; k < 2; k++) {
+            const float c = constrain(f[k], -MAX_TILT, MAX_TILT) / MAX_TILT;
+            f[k] = c * c * c;
+        }
+        floatCycles += ESP.getCycleCount() - tic;
+
+        tic = ESP.getCycleCount();
+        Vec2x x = tiltProjection(coordsX - offsetX) - zeroX;
+        for (size_t k = 0; k < 2; k++) {
+            const Fix16 c = (x[k] > maxTiltX ? maxTiltX : x[k] < -maxTiltX ? -maxTiltX : x[k]) * invTiltX;
+            x[k] = c * c * c;
+        }
+        fixedCycles += ESP.getCycleCount() - tic;
+
+        for (size_t k = 0; k < 2; k++) { worst = max(worst, fabsf(static_cast<float>(x[k]) - f[k])); }
+    }
+    samples = max(samples, static_cast<uint32_t>(1));
+    stream.printf("Fixed benchmark: %lu samples, float %lu / Q15.16 %lu cycles per sample, max difference %.2e\n",
+        samples, static_cast<uint32_t>(floatCycles / samples), static_cast<uint32_t>(fixedCycles / samples), worst);
+}
+/****************************************************************************/
+#endif
@@ -0,0 +1,47 @@
+#ifndef BENCH_GRAVITY_TRACKER_HPP
+#define BENCH_GRAVITY_TRACKER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "GravityTracker.hpp"
+
+/****************************************************************************/
+// Synthetic cabinet: the pitch walks slowly between +-5 deg and every 2 s
+// it is shoved with a 40 ms, 12 m/s^2 half-sine along X. Reports the worst
+// tilt error during the shoves for the raw vector and for the tracked
+// gravity, how much of the shove came through in nudge(), and the cost
+// per sample.
+inline void benchGravityTracker(Stream& stream = Serial, uint32_t samples = 6000, float rate = SMPL_FREQ) {
+    constexpr float G = 9.81f;
+    GravityTracker tracker(0.5f, 1.5f, rate);
+    const uint32_t shoveEvery = static_cast<uint32_t>(2.f * rate);
+    const uint32_t shoveLen = static_cast<uint32_t>(0.04f * rate) + 2;
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    float rawErr = 0.f, trackedErr = 0.f, peakShove = 0.f, peakNudge = 0.f;
+    for (uint32_t n = 0; n < samples; n++) {
+        const float pitch = 5.f * DEG_TO_RAD * sinf(2.f * PI * 0.05f * n / rate);
+        const uint32_t phase = n % shoveEvery;
+        const float shove = phase < shoveLen ? 12.f * sinf(PI * phase / shoveLen) : 0.f;
+        const Vec3f a(-G * sinf(pitch) + shove, 0.02f * sinf(n * 1.7f), G * cosf(pitch));
+
+        const uint32_t tic = ESP.getCycleCount();
+        tracker.update(a);
+        const uint32_t spent = ESP.getCycleCount() - tic;
+        cycles += spent;
+        maxCycles = max(maxCycles, spent);
+
+        if (shove != 0.f && n > shoveEvery) {
+            const float truth = pitch * RAD_TO_DEG;
+            rawErr = max(rawErr, fabsf(tiltProjection(a)[0] - truth));
+            trackedErr = max(trackedErr, fabsf(tracker.tilt()[0] - truth));
+            peakShove = max(peakShove, shove);
+            peakNudge = max(peakNudge, tracker.nudge()[0]);
+        }
+    }
+    stream.printf("GravityTracker benchmark: %lu samples, tilt error in shoves raw %.2f / tracked %.2f deg, nudge %.1f of %.1f m/s², mean %lu / max %lu cycles per sample\n",
+        samples, rawErr, trackedErr, peakNudge, peakShove,
+        static_cast<uint32_t>(cycles / samples), maxCycles);
+}
+/****************************************************************************/
+#endif
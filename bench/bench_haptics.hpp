@@ -0,0 +1,37 @@
+#ifndef BENCH_HAPTICS_HPP
+#define BENCH_HAPTICS_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "HapticPlayer.hpp"
+
+/****************************************************************************/
+// Per-tick cost of the haptic mixer with every voice busy: plays `env` on
+// all voices spread over the player's coils (at half gain, so the coils do
+// move) and ticks by hand. The player must not be begun.
+template<uint8_t MaxVoices>
+void benchHapticPlayer(HapticPlayer<MaxVoices>& player, const HapticEnvelope& env = Haptic::DRAIN_RUMBLE,
+                       uint32_t ticks = 1000, Stream& stream = Serial) {
+    if (!player.size()) return;
+    for (uint8_t k = 0; k < MaxVoices; k++) player.play(k % player.size(), env, 128);
+    player.resetStats();
+    const uint32_t t0 = micros();
+    for (uint32_t k = 0; k < ticks; k++) player.tick(t0 + k * HAPTIC_TICK_US);
+    stream.printf("HapticPlayer benchmark: %d voices, %d coils, %lu ticks, mean %.2f us, max %lu us per tick\n",
+        MaxVoices, player.size(), player.ticks(), player.meanTickMicros(), player.maxTickMicros());
+    player.stopAll();
+    player.tick(micros());
+    player.resetStats();
+}
+
+inline void benchHaptics(Stream& stream = Serial) {
+    static Solenoid coil(1, 0);
+    static HapticPlayer<8> player;
+    if (!player.size()) {
+        coil.begin();
+        player.add(coil);
+    }
+    benchHapticPlayer(player, Haptic::DRAIN_RUMBLE, 1000, stream);
+}
+/****************************************************************************/
+#endif
@@ -0,0 +1,41 @@
+#ifndef BENCH_JOYSTICK_HPP
+#define BENCH_JOYSTICK_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "Joystick.hpp"
+
+/****************************************************************************/
+// Cost of Joystick::read() on the ADXL345 as the cabinet would run it:
+// I2C transfer, gravity tracking, auto-centering, smoothing and the tilt
+// response, per read. Reads back to back; without a decimator each one
+// is a single sensor event.
+inline void benchJoystick(Stream& stream = Serial, uint32_t reads = 1000) {
+    static Accelerometer accel;
+    static Joystick stick(accel);
+    static GravityTracker gravity;
+    static AutoCenter center;
+    static OneEuroFilter<2> smoother;
+    setWire();
+    if (!stick.begin()) {
+        stream.println("Joystick benchmark: no ADXL345");
+        return;
+    }
+    stick.attachGravity(gravity);
+    stick.attachAutoCenter(center);
+    stick.attachSmoother(smoother);
+
+    uint32_t total = 0, most = 0;
+    Vec2f sum;
+    for (uint32_t n = 0; n < reads; n++) {
+        const uint32_t tic = micros();
+        sum += stick.read();
+        const uint32_t spent = micros() - tic;
+        total += spent;
+        most = max(most, spent);
+    }
+    stream.printf("Joystick benchmark: %lu reads, mean %.1f / max %lu us per read (I2C included), check %.3f\n",
+        reads, static_cast<float>(total) / reads, most, sum[0] + sum[1]);
+}
+/****************************************************************************/
+#endif
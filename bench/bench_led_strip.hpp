@@ -0,0 +1,55 @@
+#ifndef BENCH_LED_STRIP_HPP
+#define BENCH_LED_STRIP_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "Compositor.hpp"
+#include "Effects.hpp"
+#include "LedStrip.hpp"
+
+/****************************************************************************/
+// Exterior strip frame cost: Compositor::render() (base effects, a flash
+// overlay and the current cap) and LedStrip::show() (quantise and RMT
+// encode), one frame every LED_FRAME_MS. Times are scaled to 100 LEDs so
+// strips of any length compare; the wire time is the fixed RMT clock-out
+// the CPU does not spend. A frame the RMT is still sending is skipped.
+template<size_t Count>
+void benchLedStrip(uint8_t pin, uint8_t rmtChannel, uint32_t frames = 200, Stream& stream = Serial) {
+    static Compositor<Count> comp;
+    static LedStrip<Count> strip(pin, rmtChannel);
+    static const bool ready = strip.begin();
+    if (!ready) return;
+    comp.base().playRange(0, Count / 2, Effects::BREATHING_RAINBOW, 0, 50);
+    comp.base().playRange(Count / 2, Count - Count / 2, Effects::CHASE, 0, 100);
+    comp.setCurrentLimit(2000);
+    uint64_t composeSum = 0, encodeSum = 0;
+    uint32_t composeMax = 0, encodeMax = 0, shown = 0;
+    for (uint32_t n = 0; n < frames; n++) {
+        const uint32_t nowMs = n * LED_FRAME_MS;
+        if (n % 25 == 0) comp.flash(RGB{255, 255, 255}, 300, nowMs);
+        comp.render(nowMs);
+        composeSum += comp.lastFrameMicros();
+        composeMax = max(composeMax, comp.lastFrameMicros());
+        if (strip.show(comp.frame())) {
+            shown++;
+            encodeSum += strip.renderMicros();
+            encodeMax = max(encodeMax, strip.renderMicros());
+        }
+        delay(LED_FRAME_MS);
+    }
+    const float per100 = 100.f / Count;
+    stream.printf("LedStrip benchmark: %u LEDs, %lu frames (%lu shown), per 100 LEDs compose %.1f / max %.1f us, encode %.1f / max %.1f us, wire %.0f us\n",
+        static_cast<unsigned>(Count), frames, shown,
+        per100 * composeSum / max(frames, static_cast<uint32_t>(1)), per100 * composeMax,
+        per100 * encodeSum / max(shown, static_cast<uint32_t>(1)), per100 * encodeMax,
+        per100 * LedStrip<Count>::transmitMicros());
+    comp.base().clear();
+}
+
+// One 100-LED strip and a 300-LED run, on their own RMT channels
+inline void benchLedStrip(Stream& stream = Serial) {
+    benchLedStrip<100>(2, 0, 200, stream);
+    benchLedStrip<300>(3, 1, 200, stream);
+}
+/****************************************************************************/
+#endif
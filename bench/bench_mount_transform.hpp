@@ -0,0 +1,28 @@
+#ifndef BENCH_MOUNT_TRANSFORM_HPP
+#define BENCH_MOUNT_TRANSFORM_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "MountTransform.hpp"
+
+/****************************************************************************/
+// Cycles per MountTransform::apply(): one seqlock read plus the 3x3 multiply
+inline void benchMountTransform(Stream& stream = Serial, uint32_t samples = 10000) {
+    static MountTransform mount;
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    Vec3f sum;
+    for (uint32_t n = 0; n < samples; n++) {
+        Vec3f v(0.3f * sinf(n * 0.01f), 0.2f * cosf(n * 0.013f), 9.81f);
+        const uint32_t tic = ESP.getCycleCount();
+        mount.apply(v);
+        const uint32_t spent = ESP.getCycleCount() - tic;
+        cycles += spent;
+        maxCycles = max(maxCycles, spent);
+        sum += v;
+    }
+    stream.printf("MountTransform benchmark: %lu samples, mean %lu / max %lu cycles per sample, check %.3f\n",
+        samples, static_cast<uint32_t>(cycles / samples), maxCycles, sum[2] / samples);
+}
+/****************************************************************************/
+#endif
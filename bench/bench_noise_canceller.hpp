@@ -0,0 +1,77 @@
+#ifndef BENCH_NOISE_CANCELLER_HPP
+#define BENCH_NOISE_CANCELLER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "utilities.hpp"
+#include "NoiseCanceller.hpp"
+
+/****************************************************************************/
+// Cost and cancellation of the canceller at SMPL_FREQ on a synthetic
+// mixture: each reference is a haptic style drive (bursts at random
+// levels), the cabinet turns every change of drive into a 5-15 Hz ring
+// that fits inside the filter, and a slow "player" tilt rides on top.
+// Cancellation is measured over the second half of the run.
+template<uint8_t Refs, uint8_t Taps = 16>
+void benchNoiseCanceller(uint32_t samples = 12000, Stream& stream = Serial) {
+    static NoiseCanceller<Refs, Taps> canceller;
+    canceller.reset();
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    double before = 0, after = 0;
+    static float h[3][Refs][Taps];
+    for (uint8_t a = 0; a < 3; a++) {
+        for (uint8_t r = 0; r < Refs; r++) {
+            for (uint8_t t = 0; t < Taps; t++) {
+                const float f = (1 + (a + r) % 3) * 5.f / SMPL_FREQ;
+                h[a][r][t] = 0.02f * expf(-4.f * t / Taps) * sinf(2.f * PI * f * t) / (1 + a);
+            }
+        }
+    }
+    int16_t hist[Refs][Taps] = {};
+    int16_t level[Refs] = {};
+    uint32_t seed = 12345;
+    for (uint32_t n = 0; n < samples; n++) {
+        int16_t refs[Refs];
+        for (uint8_t r = 0; r < Refs; r++) {
+            seed = seed * 1664525u + 1013904223u;
+            if ((seed >> 24) < 8) { level[r] = (seed >> 12) & 0x0FFF; }      // New burst level
+            else if ((seed >> 24) < 12) { level[r] = 0; }
+            refs[r] = level[r];
+            memmove(&hist[r][1], &hist[r][0], (Taps - 1) * sizeof(int16_t));
+            hist[r][0] = refs[r];
+        }
+        int32_t d[3], tilt[3], noise[3];
+        for (uint8_t a = 0; a < 3; a++) {
+            float v = 0.f;
+            for (uint8_t r = 0; r < Refs; r++) {
+                for (uint8_t t = 1; t < Taps; t++) { v += h[a][r][t] * (hist[r][t - 1] - hist[r][t]); }
+            }
+            noise[a] = static_cast<int32_t>(lroundf(v * ACCEL_Q8));
+            tilt[a] = static_cast<int32_t>(ACCEL_Q8 * (a == 2 ? 9.8f : 0.5f * sinf(2.f * PI * 0.05f * (a + 1) * n / SMPL_FREQ)));
+            d[a] = tilt[a] + noise[a];
+        }
+        canceller.process(refs, d);
+        cycles += canceller.lastCycles();
+        maxCycles = max(maxCycles, canceller.lastCycles());
+        if (n >= samples / 2) {
+            for (uint8_t a = 0; a < 3; a++) {
+                const double in = noise[a], out = d[a] - tilt[a];
+                before += in * in;
+                after += out * out;
+            }
+        }
+    }
+    const double db = after > 0 ? 10.0 * log10(before / after) : 99.0;
+    stream.printf("NoiseCanceller benchmark: %d refs x %d taps at %.0f Hz, %lu samples, cancellation %.1f dB, mean %lu / max %lu cycles per sample (%.1f us at %lu MHz)\n",
+        Refs, Taps, SMPL_FREQ, samples, db, static_cast<uint32_t>(cycles / samples), maxCycles,
+        static_cast<float>(cycles / samples) / ESP.getCpuFreqMHz(), ESP.getCpuFreqMHz());
+    canceller.reset();
+}
+
+inline void benchNoiseCanceller(Stream& stream = Serial) {
+    benchNoiseCanceller<2, 16>(12000, stream);
+    benchNoiseCanceller<4, 16>(12000, stream);
+}
+/****************************************************************************/
+#endif
@@ -0,0 +1,90 @@
+#ifndef BENCH_ONE_EURO_HPP
+#define BENCH_ONE_EURO_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "OneEuro.hpp"
+
+/****************************************************************************/
+// Offline comparison on one channel with the given tunables. The Butterworth
+// cutoff is chosen so both filters leave the same jitter on a resting,
+// noisy input; then each is run on a step and on a ramp. Prints the jitter
+// at rest, samples to settle within 10% of a step, the steady lag behind a
+// ramp (in samples), and cycles per sample for each.
+inline void benchOneEuro(Stream& stream = Serial, const OneEuroParams& params = OneEuroParams(),
+                         float rate = SMPL_FREQ, float noise = 0.05f, float stepSize = 1.f,
+                         float rampSpeed = 2.f) {
+    constexpr uint32_t SAMPLES = 2000;
+    uint32_t seed = 777;
+    auto jitter = [&]() {
+        seed = seed * 1664525u + 1013904223u;
+        return noise * (((seed >> 8) & 0xFFFF) / 32767.5f - 1.f);
+    };
+
+    // Rest jitter (std dev of the output) over the second half of a run
+    auto restJitter = [&](auto& filter) {
+        filter.reset();
+        seed = 777;
+        double sum = 0, sumSq = 0;
+        for (uint32_t n = 0; n < SAMPLES; n++) {
+            const float y = filter.apply(Vector<float, 1>(jitter()))[0];
+            if (n >= SAMPLES / 2) { sum += y; sumSq += static_cast<double>(y) * y; }
+        }
+        const double m = sum / (SAMPLES / 2);
+        return static_cast<float>(sqrt(max(sumSq / (SAMPLES / 2) - m * m, 0.0)));
+    };
+
+    // Samples after a clean step until the output stays within 10%
+    auto stepSettle = [&](auto& filter) {
+        filter.reset();
+        filter.apply(Vector<float, 1>(0.f));
+        uint32_t settled = 0;
+        for (uint32_t n = 1; n < SAMPLES; n++) {
+            const float y = filter.apply(Vector<float, 1>(stepSize))[0];
+            if (fabsf(y - stepSize) > 0.1f * stepSize) { settled = n; }
+        }
+        return settled;
+    };
+
+    // Lag behind a clean ramp once it has settled, in samples
+    auto rampLag = [&](auto& filter, uint64_t& cycles) {
+        filter.reset();
+        float y = 0.f, x = 0.f;
+        cycles = 0;
+        for (uint32_t n = 0; n < SAMPLES; n++) {
+            x = rampSpeed * n / rate;
+            const uint32_t tic = ESP.getCycleCount();
+            y = filter.apply(Vector<float, 1>(x))[0];
+            cycles += ESP.getCycleCount() - tic;
+        }
+        return (x - y) / (rampSpeed / rate);
+    };
+
+    OneEuroFilter<1> euro(rate, params);
+    const float euroJitter = restJitter(euro);
+
+    // Match the Butterworth's rest jitter by bisection on its cutoff
+    ButterworthFilter<1> butter(1.f, rate);
+    float lo = 0.01f, hi = 0.45f * rate;
+    for (uint8_t i = 0; i < 30; i++) {
+        const float mid = sqrtf(lo * hi);
+        butter.setCutoff(mid, rate);
+        if (restJitter(butter) > euroJitter) { hi = mid; } else { lo = mid; }
+    }
+    butter.setCutoff(lo, rate);
+    const float butterJitter = restJitter(butter);
+
+    uint64_t euroCycles = 0, butterCycles = 0;
+    const uint32_t euroStep = stepSettle(euro), butterStep = stepSettle(butter);
+    const float euroLag = rampLag(euro, euroCycles), butterLag = rampLag(butter, butterCycles);
+
+    stream.printf("OneEuro benchmark: %.0f Hz, min cutoff %.2f Hz, beta %.3f vs Butterworth %.2f Hz\n",
+        rate, params.minCutoff, params.beta, lo);
+    stream.printf("  rest jitter  %.4f / %.4f\n", euroJitter, butterJitter);
+    stream.printf("  step settle  %lu / %lu samples\n", euroStep, butterStep);
+    stream.printf("  ramp lag     %.1f / %.1f samples\n", euroLag, butterLag);
+    stream.printf("  cost         %lu / %lu cycles per sample\n",
+        static_cast<uint32_t>(euroCycles / SAMPLES), static_cast<uint32_t>(butterCycles / SAMPLES));
+}
+/****************************************************************************/
+#endif
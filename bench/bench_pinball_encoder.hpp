@@ -0,0 +1,37 @@
+#ifndef BENCH_PINBALL_ENCODER_HPP
+#define BENCH_PINBALL_ENCODER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "PinballHID.hpp"
+
+/****************************************************************************/
+// Cycles per PinballEncoder::encode() over a synthetic session: nudges, a
+// plunger pull and release, button presses, 1 ms apart
+inline void benchPinballEncoder(Stream& stream = Serial, uint32_t states = 10000) {
+    PinballEncoder encoder;
+    GamepadState state;
+    PinballReport report;
+    uint64_t cycles = 0;
+    uint32_t maxCycles = 0;
+    int32_t check = 0;
+    for (uint32_t n = 0; n < states; n++) {
+        const float t = n * 1e-3f;
+        state.sampled = n * 1000;
+        state.nudge[0] = toNudge(4.f * sinf(2.f * PI * 3.f * t));
+        state.nudge[1] = toNudge(2.f * sinf(2.f * PI * 5.f * t));
+        if (n % 10 == 0) { state.axis[AXIS_Z] = static_cast<int16_t>(n % 2000 < 1500 ? (n % 2000) * 20 : 0); }
+        state.buttons = (n / 250) & 0x3FF;
+        const uint32_t tic = ESP.getCycleCount();
+        encoder.encode(state, report);
+        const uint32_t spent = ESP.getCycleCount() - tic;
+        cycles += spent;
+        maxCycles = max(maxCycles, spent);
+        check += report.vxNudge + report.plungerSpeed;
+    }
+    stream.printf("PinballEncoder benchmark: %lu states, mean %lu / max %lu cycles per report (%.2f us at %lu MHz), check %ld\n",
+        states, static_cast<uint32_t>(cycles / states), maxCycles,
+        static_cast<float>(cycles / states) / ESP.getCpuFreqMHz(), ESP.getCpuFreqMHz(), check);
+}
+/****************************************************************************/
+#endif
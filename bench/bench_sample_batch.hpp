@@ -0,0 +1,75 @@
+#ifndef BENCH_SAMPLE_BATCH_HPP
+#define BENCH_SAMPLE_BATCH_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "SampleBatch.hpp"
+
+/**********************************************************************************/
+// Runs the joystick shaping chain (offset, scale, tilt projection, zero,
+// clip, cubic response) over the same synthetic samples one Vec3f at a
+// time and as one batch, and prints samples per microsecond for each plus
+// the largest difference between the two outputs.
+template<size_t Size>
+void benchSampleBatch(uint8_t rounds = 100, Stream& stream = Serial) {
+    const Vec3f offset(0.12f, -0.08f, 0.21f);
+    const Vec2f zero(0.4f, -0.3f);
+    constexpr float MAX_TILT = 12.5f;
+    Vec3f input[Size];
+    for (size_t i = 0; i < Size; i++) {
+        const float a = 0.35f * sinf(i * 0.2f);
+        input[i] = Vec3f(9.81f * sinf(a), 9.81f * sinf(0.5f * a), 9.81f * cosf(a));
+    }
+
+    Vec2f scalar[Size];
+    uint64_t scalarCycles = 0;
+    for (uint8_t r = 0; r < rounds; r++) {
+        const uint32_t tic = ESP.getCycleCount();
+        for (size_t i = 0; i < Size; i++) {
+            Vec2f t = tiltProjection((input[i] - offset) * 1.02f) - zero;
+            t[0] = constrain(t[0], -MAX_TILT, MAX_TILT);
+            t[1] = constrain(t[1], -MAX_TILT, MAX_TILT);
+            t /= MAX_TILT;
+            for (size_t k = 0; k < 2; k++) { t[k] = t[k] * t[k] * t[k]; }
+            scalar[i] = t;
+        }
+        scalarCycles += ESP.getCycleCount() - tic;
+    }
+
+    SampleBatch<float, 3, Size> raw;
+    SampleBatch<float, 2, Size> tilt;
+    uint64_t batchCycles = 0;
+    for (uint8_t r = 0; r < rounds; r++) {
+        raw.clear();
+        for (size_t i = 0; i < Size; i++) { raw.push(input[i]); }
+        const uint32_t tic = ESP.getCycleCount();
+        raw.subtract(offset);
+        raw.scale(1.02f);
+        tiltProjection(raw, tilt);
+        tilt.subtract(zero);
+        tilt.clip(-MAX_TILT, MAX_TILT);
+        tilt.scale(1.f / MAX_TILT);
+        tilt.cube();
+        batchCycles += ESP.getCycleCount() - tic;
+    }
+
+    float worst = 0.f;
+    for (size_t i = 0; i < Size; i++) {
+        const Vec2f d = tilt.get(i) - scalar[i];
+        worst = max(worst, max(fabsf(d[0]), fabsf(d[1])));
+    }
+    const float mhz = ESP.getCpuFreqMHz();
+    const float samples = static_cast<float>(Size) * rounds;
+    stream.printf("SampleBatch benchmark: batch of %u, scalar %.2f / batch %.2f samples/us (%s), max difference %.2e\n",
+        static_cast<unsigned>(Size), samples * mhz / scalarCycles, samples * mhz / batchCycles,
+        SAMPLE_BATCH_DSP ? "esp-dsp" : "plain loops", worst);
+}
+
+// The sizes a FIFO burst or replay chunk usually comes in
+inline void benchSampleBatch(Stream& stream = Serial) {
+    benchSampleBatch<8>(100, stream);
+    benchSampleBatch<16>(100, stream);
+    benchSampleBatch<32>(100, stream);
+}
+/**********************************************************************************/
+#endif
@@ -0,0 +1,49 @@
+#ifndef BENCH_STATE_CODEC_HPP
+#define BENCH_STATE_CODEC_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "StateCodec.hpp"
+
+/****************************************************************************/
+// Encodes and decodes a synthetic session (tilt wandering, plunger pulls,
+// button chords, 1 ms sampling) and prints throughput and mean record size.
+// Every decoded state is compared with its source, so a mismatch count
+// other than 0 means the codec is broken.
+inline void benchStateCodec(Stream& stream = Serial, uint32_t states = 10000) {
+    DeltaEncoder encoder;
+    DeltaDecoder decoder;
+    GamepadState state;
+    uint8_t record[DELTA_MAX];
+    uint32_t seed = 12345;
+    uint32_t bytes = 0, mismatches = 0;
+    uint64_t encCycles = 0, decCycles = 0;
+
+    for (uint32_t n = 0; n < states; n++) {
+        seed = seed * 1664525u + 1013904223u;
+        if ((seed >> 24) < 4) { state.buttons ^= 1u << ((seed >> 8) & 31); }
+        if ((seed >> 20) & 1) { state.axis[AXIS_X] += static_cast<int16_t>((seed >> 4) & 0x3F) - 32; }
+        if ((seed >> 21) & 1) { state.axis[AXIS_Y] += static_cast<int16_t>((seed >> 10) & 0x3F) - 32; }
+        if ((seed >> 24) < 16) { state.axis[AXIS_Z] = static_cast<int16_t>(seed & 0x7FFF); }
+        state.sampled += 1000;
+
+        uint32_t tic = ESP.getCycleCount();
+        const uint8_t len = encoder.encode(state, record);
+        encCycles += ESP.getCycleCount() - tic;
+        bytes += len;
+
+        GamepadState out = decoder.state();
+        tic = ESP.getCycleCount();
+        if (len && decoder.decode(record, len, out) != len) { mismatches++; continue; }
+        decCycles += ESP.getCycleCount() - tic;
+        if (memcmp(&out, &state, STATE_BYTES) != 0) { mismatches++; }
+    }
+
+    const float mhz = ESP.getCpuFreqMHz();
+    stream.printf("StateCodec benchmark: %lu states, %.2f bytes/record (vs %d packed), encode %lu / decode %lu cycles (%.2f / %.2f Mstates/s), %lu mismatches\n",
+        states, static_cast<float>(bytes) / states, STATE_BYTES,
+        static_cast<uint32_t>(encCycles / states), static_cast<uint32_t>(decCycles / states),
+        encCycles ? mhz * states / encCycles : 0.f, decCycles ? mhz * states / decCycles : 0.f, mismatches);
+}
+/****************************************************************************/
+#endif
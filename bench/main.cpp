@@ -0,0 +1,39 @@
+// On-target benchmarks: `pio run -e bench -t upload -t monitor`.
+// Each bench_<feature>.hpp times one pipeline stage; the classes themselves
+// only keep the stats counters they print from printStats().
+#include <Arduino.h>
+#include "bench_animator.hpp"
+#include "bench_auto_center.hpp"
+#include "bench_cic.hpp"
+#include "bench_fixed.hpp"
+#include "bench_gravity_tracker.hpp"
+#include "bench_haptics.hpp"
+#include "bench_joystick.hpp"
+#include "bench_led_strip.hpp"
+#include "bench_mount_transform.hpp"
+#include "bench_noise_canceller.hpp"
+#include "bench_one_euro.hpp"
+#include "bench_pinball_encoder.hpp"
+#include "bench_sample_batch.hpp"
+#include "bench_state_codec.hpp"
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);
+    benchAnimator();
+    benchAutoCenter();
+    benchCic();
+    benchFixed();
+    benchGravityTracker();
+    benchHaptics();
+    benchJoystick();
+    benchLedStrip();
+    benchMountTransform();
+    benchNoiseCanceller();
+    benchOneEuro();
+    benchPinballEncoder();
+    benchSampleBatch();
+    benchStateCodec();
+}
+
+void loop() {}
@@ -4,7 +4,9 @@
 // Simplified constructor
 Accelerometer::Accelerometer(int32_t sensor_id, range_t sensor_range, dataRate_t sensor_rate) 
     : sensor(sensor_id), range(sensor_range), rate(sensor_rate)
-{}
+{
+    resetStats();
+}
 /*************************************************************************************/
 bool Accelerometer::begin() {
     setWire();                                  // Define I2C specs
@@ -14,6 +16,12 @@ bool Accelerometer::begin() {
     sensor.setRange(range);                     // Configure sensor
     sensor.setDataRate(rate);
     _init = true;
+    if (decimator) {
+        if (!configureFifo()) { return false; }
+    } else {
+        // Bypass: a warm reset leaves the sensor as a decimating run set it
+        sensor.writeRegister(ADXL345_REG_FIFO_CTL, 0x00);
+    }
     Serial.println("ADXL345 initialized successfully");
     msgPause();
     return true;                         
@@ -22,7 +30,8 @@ bool Accelerometer::begin() {
 bool Accelerometer::readRaw(sensors_event_t* event){
     if(!_init){ return ErrorMsg("Run begin()"); }
     if(!sensor.getEvent(event)){ return ErrorMsg("No sensor event!"); }
-    _tic = 1e-6 * micros();
+    _sampledUs = micros();
+    _tic = 1e-6 * _sampledUs;
     coords = Vec3f({
         event->acceleration.x, 
         event->acceleration.y, 
@@ -31,11 +40,110 @@ bool Accelerometer::readRaw(sensors_event_t* event){
 }
 /*************************************************************************************/          
 bool Accelerometer::read(){
+    if (decimator) {
+        // One decimated sample per call, oldest first, so every stage
+        // downstream sees each exactly once. The FIFO is drained again only
+        // once the previous drain's samples are all handed out; a poll that
+        // lands between outputs gets nothing new.
+        if(!_init){ return ErrorMsg("Run begin()"); }
+        if (available() == 0 && !drain()) { return false; }
+        coords = queued[queuedNext];
+        _sampledUs = queuedUs[queuedNext++];
+        _tic = 1e-6 * _sampledUs;
+        return true;
+    }
     sensors_event_t event; 
     if(!readRaw(&event)){ return false; }
     return true; 
 }
 /*************************************************************************************/
+bool Accelerometer::attachDecimator(AccelDecimator& stage, float outRate) {
+    // The ADXL345 rates double from 100 Hz up, so ratio * outRate must land
+    // on one of them
+    const float full = stage.ratio() * outRate;
+    dataRate_t fullRate;
+    if (full == 3200.f) { fullRate = ADXL345_DATARATE_3200_HZ; }
+    else if (full == 1600.f) { fullRate = ADXL345_DATARATE_1600_HZ; }
+    else if (full == 800.f) { fullRate = ADXL345_DATARATE_800_HZ; }
+    else if (full == 400.f) { fullRate = ADXL345_DATARATE_400_HZ; }
+    else if (full == 200.f) { fullRate = ADXL345_DATARATE_200_HZ; }
+    else { return ErrorMsg("No ADXL345 data rate for that decimation!"); }
+    rate = fullRate;
+    decimator = &stage;
+    decimator->reset();
+    queuedCount = queuedNext = 0;
+    resetStats();
+    if (!_init) { return true; }                 // begin() finishes the setup
+    sensor.setDataRate(rate);
+    return configureFifo();
+}
+/*************************************************************************************/
+bool Accelerometer::configureFifo() {
+    // Stream mode: the FIFO keeps the newest 32 samples. At 3200 Hz that is
+    // 10 ms, so poll at least at the output rate or samples are lost.
+    sensor.writeRegister(ADXL345_REG_FIFO_CTL, 0x80 | (ADXL345_FIFO_DEPTH - 1));
+    if ((sensor.readRegister(ADXL345_REG_FIFO_CTL) & 0xC0) != 0x80) {
+        return ErrorMsg("ADXL345 FIFO not in stream mode!");
+    }
+    Serial.printf("ADXL345 FIFO at %.0f Hz, decimating by %d\n", getDataFreq(), decimator->ratio());
+    return true;
+}
+/*************************************************************************************/
+bool Accelerometer::drain() {
+    // Push everything the FIFO holds through the decimator. The newest
+    // entry was taken at most one period before the drain; the others one
+    // period apart before it.
+    int16_t raw[ADXL345_FIFO_DEPTH][3];
+    const uint32_t drained = micros();
+    bool full = false;
+    const uint8_t n = readFifo(raw, ADXL345_FIFO_DEPTH, full);
+    const float periodUs = 1e6f / getDataFreq();
+    queuedCount = queuedNext = 0;
+    // A full FIFO has been dropping its oldest entries (the part flags that
+    // as an overrun too): what it holds does not follow on from the last
+    // drain, so the decimator starts over on it
+    if (full) {
+        decimator->reset();
+        _overruns++;
+    }
+    for (uint8_t k = 0; k < n; k++) {
+        if (decimator->push(raw[k], queued[queuedCount])) {
+            queuedUs[queuedCount++] = drained - static_cast<uint32_t>((n - 1 - k) * periodUs);
+        }
+    }
+    _drainLast = micros() - drained;
+    _drainMax = max(_drainMax, _drainLast);
+    _drainSum += _drainLast;
+    _drains++;
+    _entries += n;
+    _samples += queuedCount;
+    return queuedCount > 0;
+}
+/*************************************************************************************/
+uint8_t Accelerometer::readFifo(int16_t (*raw)[3], uint8_t maxEntries, bool& full) {
+    // All entries in one burst: each is joined to the last by a repeated
+    // start, with a single stop after the last. An entry pops on a 6-byte
+    // read from DATAX0 and the pointer then runs on into FIFO_CTL, so each
+    // one is addressed again (which also gives the FIFO the >= 5 us it
+    // needs between pops).
+    constexpr uint8_t address = ADXL345_DEFAULT_ADDRESS;
+    const uint8_t status = sensor.readRegister(ADXL345_REG_FIFO_STATUS) & 0x3F;
+    full = status >= ADXL345_FIFO_DEPTH;
+    const uint8_t entries = min(status, maxEntries);
+    for (uint8_t k = 0; k < entries; k++) {
+        Wire.beginTransmission(address);
+        Wire.write(ADXL345_REG_DATAX0);
+        if (Wire.endTransmission(false) != 0 || Wire.requestFrom(address, static_cast<size_t>(6), k + 1 == entries) != 6) {
+            return k;
+        }
+        for (uint8_t a = 0; a < 3; a++) {
+            const uint8_t lo = Wire.read();
+            raw[k][a] = static_cast<int16_t>((Wire.read() << 8) | lo);
+        }
+    }
+    return entries;
+}
+/*************************************************************************************/
 float Accelerometer::getDataFreq() {
     switch(rate) {
         case ADXL345_DATARATE_3200_HZ: return 3200.0;
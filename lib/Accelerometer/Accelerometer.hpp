@@ -9,6 +9,18 @@
 #include "utilities.hpp"
 
 constexpr uint32_t DEVICE_IDENTIFER = 78810; 
+constexpr uint8_t ADXL345_FIFO_DEPTH = 32;
+
+/*************************************************************************************/
+// Turns the sensor's full-rate FIFO samples (raw 4 mg LSB) into the slower
+// samples the rest of the pipeline reads (m/s^2); see CicFrontEnd.hpp
+class AccelDecimator {
+public:
+    virtual ~AccelDecimator() = default;
+    virtual uint8_t ratio() const = 0;
+    virtual void reset() = 0;
+    virtual bool push(const int16_t (&raw)[3], Vec3f& out) = 0;
+};
 
 /*************************************************************************************/
 class Accelerometer {
@@ -18,11 +30,25 @@ private:
     Adafruit_ADXL345_Unified sensor;
     range_t range;      // Set on constructor
     dataRate_t rate;
+    AccelDecimator* decimator = nullptr;
+
+    // Decimated samples of the latest FIFO drain, handed out one per read()
+    Vec3f queued[ADXL345_FIFO_DEPTH];
+    uint32_t queuedUs[ADXL345_FIFO_DEPTH];
+    uint8_t queuedCount = 0, queuedNext = 0;
+
+    // Per-drain cost (us, I2C included) and counters
+    uint32_t _drains, _entries, _samples, _overruns, _drainLast, _drainMax, _drainSum;
+
+    bool configureFifo();
+    bool drain();
+    uint8_t readFifo(int16_t (*raw)[3], uint8_t maxEntries, bool& full);
            
 public:
 
     bool _init = false; 
     float _tic; 
+    uint32_t _sampledUs = 0;    // micros() the sensor took the sample in coords
     Vec3f coords; 
 
     Accelerometer(                                   // Simplified constructor
@@ -33,9 +59,28 @@ public:
     
     bool begin();
     bool readRaw(sensors_event_t* event);
-    bool read(); 
+    bool read();                    // true when coords holds a sample not read before
+    uint8_t available() const { return queuedCount - queuedNext; }
     float getDataFreq(); 
-    
+    bool attachDecimator(AccelDecimator& decimator, float outRate = SMPL_FREQ);
+
+    uint32_t drains() const { return _drains; }
+    uint32_t fifoEntries() const { return _entries; }
+    uint32_t decimatedSamples() const { return _samples; }
+    // Drains that found the FIFO full, i.e. polled too late to get every entry
+    uint32_t overruns() const { return _overruns; }
+    uint32_t lastDrainMicros() const { return _drainLast; }
+    uint32_t maxDrainMicros() const { return _drainMax; }
+    float meanDrainMicros() const { return _drains ? static_cast<float>(_drainSum) / _drains : 0.0f; }
+    // Drain time per decimated sample, I2C included
+    float microsPerSample() const { return _samples ? static_cast<float>(_drainSum) / _samples : 0.0f; }
+
+    void resetStats() { _drains = _entries = _samples = _overruns = _drainLast = _drainMax = _drainSum = 0; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("Accelerometer: %lu drains, %lu FIFO entries -> %lu samples, %lu overruns, drain last %lu us, mean %.1f us, max %lu us, %.1f us per sample (I2C included)\n",
+            _drains, _entries, _samples, _overruns, _drainLast, meanDrainMicros(), _drainMax, microsPerSample());
+    }
 
 };
 /*************************************************************************************/
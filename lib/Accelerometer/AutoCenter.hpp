@@ -0,0 +1,100 @@
+#ifndef AUTO_CENTER_HPP
+#define AUTO_CENTER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "vectors.hpp"
+#include "utilities.hpp"
+
+/****************************************************************************/
+// Background re-centering of the joystick zero. Uncalibrated tilt is
+// summed over back-to-back windows of a few seconds (running sums of x and
+// x^2, no sample buffer). A window whose spread stays under the stillness
+// threshold on both axes is a cabinet at rest, and the zero is stepped
+// towards that window's mean by at most maxRate deg/s. Temperature drift
+// and a cabinet settling on the floor are followed; a nudge or a player
+// leaning on the cabinet breaks the window and changes nothing.
+class AutoCenter {
+
+private:
+    uint32_t _window;               // Samples per stillness window
+    float _maxVar;                  // deg^2
+    float _maxStep;                 // deg per window
+    float _maxOffset;               // Ignore rest far from the current zero
+
+    // Sums are taken about the window's first sample, so a tilt of several
+    // degrees doesn't swamp the variance in float rounding
+    Vec2f _origin, _sum, _sumSq;
+    uint32_t _count = 0;
+
+    Vec2f _drift;                   // Correction applied since reset
+    uint32_t _stillWindows = 0, _windows = 0;
+
+public:
+    /**
+     * @param seconds Window length; rest must last this long to count
+     * @param maxStdDev Largest spread (deg) a window may show and be still
+     * @param maxRate Fastest the zero may move, deg/s
+     * @param maxOffset Windows resting further than this (deg) from the
+     * current zero are left alone; that is a lean, not drift
+     * @param rate Sample rate, Hz
+     */
+    AutoCenter(float seconds = 2.f, float maxStdDev = 0.3f, float maxRate = 0.02f,
+               float maxOffset = 2.f, float rate = SMPL_FREQ) {
+        const float s = max(seconds, 0.1f);
+        _window = max(static_cast<uint32_t>(s * rate), static_cast<uint32_t>(8));
+        _maxVar = maxStdDev * maxStdDev;
+        _maxStep = maxRate * s;
+        _maxOffset = maxOffset;
+    }
+
+    void reset() {
+        _count = 0;
+        _drift = Vec2f();
+        _stillWindows = _windows = 0;
+    }
+
+    // Drop the window in progress, e.g. while a coil kick is being masked
+    void interrupt() { _count = 0; }
+
+    /**
+     * @brief One uncalibrated tilt sample (deg); steps zero when a still
+     * window completes
+     */
+    void update(const Vec2f& tilt, Vec2f& zero) {
+        if (_count == 0) {
+            _origin = tilt;
+            _sum = _sumSq = Vec2f();
+        }
+        const Vec2f d = tilt - _origin;
+        _sum += d;
+        _sumSq += Vec2f(d[0] * d[0], d[1] * d[1]);
+        if (++_count < _window) { return; }
+
+        _windows++;
+        _count = 0;
+        const float n = static_cast<float>(_window);
+        const Vec2f mean = _sum / n;
+        for (uint8_t k = 0; k < 2; k++) {
+            if (_sumSq[k] / n - mean[k] * mean[k] > _maxVar) { return; }
+        }
+        Vec2f step = _origin + mean - zero;
+        if (fabsf(step[0]) > _maxOffset || fabsf(step[1]) > _maxOffset) { return; }
+        for (uint8_t k = 0; k < 2; k++) { step[k] = constrain(step[k], -_maxStep, _maxStep); }
+        zero += step;
+        _drift += step;
+        _stillWindows++;
+    }
+
+    const Vec2f& drift() const { return _drift; }
+    uint32_t stillWindows() const { return _stillWindows; }
+    uint32_t windows() const { return _windows; }
+
+    void print(Stream& stream = Serial) const {
+        stream.printf("AutoCenter: drift corrected = (%.3f, %.3f) deg, %lu of %lu windows still\n",
+            _drift[0], _drift[1], _stillWindows, _windows);
+    }
+};
+/****************************************************************************/
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef CIC_FRONT_END_HPP
+#define CIC_FRONT_END_HPP
+
+#pragma once
+#include "Accelerometer.hpp"
+#include "CicDecimator.hpp"
+
+/****************************************************************************/
+// Oversampling front end: the ADXL345 runs at Ratio * SMPL_FREQ through its
+// FIFO, and every sample is averaged in by a CIC decimator with droop
+// compensation, instead of polling one sample in Ratio and dropping the
+// rest. Each doubling of the ratio buys up to 3 dB of noise.
+//
+//   CicFrontEnd<8> frontEnd;           // 800 Hz in, 100 Hz out
+//   accel.attachDecimator(frontEnd);
+//
+// Ratio is 2..32 (the sensor's 200..3200 Hz rates at a 100 Hz output).
+// Latency grows with it: about (1.5 + 1 / Ratio) output samples plus the
+// FIR's one, so ~25 ms at 100 Hz.
+//
+// Accelerometer::read() hands out one decimated sample per call; Joystick
+// loops until none is left. Each drain is one I2C burst of 9 bytes per
+// FIFO entry: at 400 kHz about 1.7 ms of every 10 ms output period at
+// ratio 8 and 6.7 ms at ratio 32 (bench/bench_cic.hpp measures it).
+//
+// The FIFO holds 32 entries, so at ratio 32 it fills in exactly one output
+// period and any late poll loses samples. A drain that finds it full counts
+// an Accelerometer::overruns() and restarts the decimator, which then takes
+// its warm-up again; ratio 16 leaves a period of slack.
+template<uint8_t Ratio, uint8_t Stages = 3>
+class CicFrontEnd : public AccelDecimator {
+    static_assert(Ratio <= 32, "The ADXL345 tops out at 3200 Hz, 32x a 100 Hz output");
+
+private:
+    // Full resolution: 4 mg per LSB at every range
+    static constexpr float LSB_TO_MS2 = ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD;
+
+    CicDecimator<Ratio, Stages, 3> _cic;
+
+public:
+    uint8_t ratio() const override { return Ratio; }
+    void reset() override { _cic.reset(); }
+
+    bool push(const int16_t (&raw)[3], Vec3f& out) override {
+        float y[3];
+        if (!_cic.push(raw, y)) { return false; }
+        out = Vec3f(y[0], y[1], y[2]) * LSB_TO_MS2;
+        return true;
+    }
+};
+/****************************************************************************/
+
+#endif
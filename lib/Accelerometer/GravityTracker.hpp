@@ -0,0 +1,83 @@
+#ifndef GRAVITY_TRACKER_HPP
+#define GRAVITY_TRACKER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "vectors.hpp"
+#include "utilities.hpp"
+
+/****************************************************************************/
+// Splits each accelerometer sample into a slow gravity estimate and the
+// fast residual around it:
+//
+//   g += k * (a - g)    (only while |a| is close to 1 g)
+//   nudge = a - g
+//
+// Tilt comes from g, so a shove no longer reads as a momentary tilt, and
+// the shove itself is left in nudge. The estimate is a single one-pole
+// low-pass per axis; the only extra work is the |a|^2 check that freezes it
+// while the cabinet is being shoved, so a hard hit doesn't drag g along.
+class GravityTracker {
+
+private:
+    static constexpr float GRAVITY = 9.81f;
+
+    float _k;                       // Low-pass step, from the time constant
+    float _gate2Lo, _gate2Hi;       // |a|^2 band the estimate follows in
+    Vec3f _gravity;
+    Vec3f _nudge;
+    bool _primed = false;
+    uint32_t _frozen = 0;           // Samples the gate held the estimate
+
+public:
+    /**
+     * @param tau Gravity time constant, s. Longer rejects slower shoves but
+     * follows a real tilt more slowly.
+     * @param gate How far |a| may stray from 1 g (m/s^2) and still count
+     * as gravity
+     * @param rate Sample rate, Hz
+     */
+    GravityTracker(float tau = 0.5f, float gate = 1.5f, float rate = SMPL_FREQ) {
+        setTimeConstant(tau, rate);
+        setGate(gate);
+    }
+
+    void setTimeConstant(float tau, float rate = SMPL_FREQ) {
+        const float dt = 1.f / max(rate, 1.f);
+        _k = dt / (max(tau, 0.f) + dt);
+    }
+
+    void setGate(float gate) {
+        const float lo = max(GRAVITY - gate, 0.f), hi = GRAVITY + gate;
+        _gate2Lo = lo * lo;
+        _gate2Hi = hi * hi;
+    }
+
+    void reset() { _primed = false; _frozen = 0; }
+
+    // One sample, m/s^2
+    void update(const Vec3f& accel) {
+        if (!_primed) {
+            _gravity = accel;
+            _primed = true;
+        } else {
+            const float a2 = accel.magnitudeSquared();
+            if (a2 > _gate2Lo && a2 < _gate2Hi) { _gravity += (accel - _gravity) * _k; }
+            else { _frozen++; }
+        }
+        _nudge = accel - _gravity;
+    }
+
+    const Vec3f& gravity() const { return _gravity; }
+    const Vec3f& nudge() const { return _nudge; }
+    Vec2f tilt() const { return tiltProjection(_gravity); }
+    uint32_t frozen() const { return _frozen; }
+
+    void print(Stream& stream = Serial) const {
+        stream.printf("GravityTracker: g = (%.2f, %.2f, %.2f), nudge = (%.2f, %.2f, %.2f) m/s², frozen %lu\n",
+            _gravity[0], _gravity[1], _gravity[2], _nudge[0], _nudge[1], _nudge[2], _frozen);
+    }
+};
+/****************************************************************************/
+
+#endif
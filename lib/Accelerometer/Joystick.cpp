@@ -1,4 +1,5 @@
 #include "Joystick.hpp"
+#include "CoilScheduler.hpp"
 
 /****************************************************************************/
 Joystick::Joystick(Accelerometer& accelerometer, float maxTilt)
@@ -10,6 +11,13 @@ Joystick::Joystick(Accelerometer& accelerometer, float maxTilt)
         msgPause(Serial);
     }
     _zero = Vec2f();
+    _canceller = nullptr;
+    _mount = nullptr;
+    _gravity = nullptr;
+    _center = nullptr;
+    _smoother = nullptr;
+    _guard = nullptr;
+    _guarded = GuardMode::NONE;
     _init = true;
 }
 /****************************************************************************/
@@ -23,6 +31,7 @@ bool Joystick::calibrate(Vec2f manual){
     // Manual calibration - use provided offsets
     if (!manual.hasNaN()) {
         _zero = manual; 
+        if(_center) { _center->reset(); }
         Serial.printf(
             "📐 Manual Calibration: Pitch = %.2f°, Roll = %.2f°\n",
             manual[0], manual[1]
@@ -39,12 +48,14 @@ bool Joystick::calibrate(Vec2f manual){
         const uint32_t dt = getInterval();
         Vec2f vec; 
         for (uint16_t k = 0; k < samples; k++) {
-            _zero += readRaw() ? _tilt : Vec2f();
-            sampleCount += 1; 
+            do {
+                if(readRaw()) { _zero += _tilt; sampleCount += 1; }
+            } while(accel.available());
             delay(dt);
         }
         if(sampleCount >= 1){ 
             _zero /= static_cast<float>(sampleCount);
+            if(_center) { _center->reset(); }
             Serial.printf(
                 "✅ Calibration Done: Pitch = %.2f°, Roll = %.2f°, Samples = %d\n",
                 _zero[0], _zero[1], sampleCount
@@ -56,38 +67,150 @@ bool Joystick::calibrate(Vec2f manual){
     }
 }
 /****************************************************************************/
+void Joystick::attachCanceller(AccelStage& canceller){
+    _canceller = &canceller;
+}
+/****************************************************************************/
+void Joystick::attachGuard(VibrationGuard& guard){
+    _guard = &guard;
+}
+/****************************************************************************/
+void Joystick::attachMount(const MountTransform& mount){
+    _mount = &mount;
+}
+/****************************************************************************/
+void Joystick::attachGravity(GravityTracker& gravity){
+    _gravity = &gravity;
+    _gravity->reset();
+}
+/****************************************************************************/
+Vec3f Joystick::nudge() const {
+    // Same verdict as the tilt: a coil kick is not a player's shove
+    if(!_gravity || _guarded == GuardMode::BLANK || _guarded == GuardMode::HOLD) { return Vec3f(); }
+    return _gravity->nudge();
+}
+/****************************************************************************/
+uint32_t Joystick::sampledMicros() const {
+    return accel._sampledUs;
+}
+/****************************************************************************/
+void Joystick::attachAutoCenter(AutoCenter& center){
+    _center = &center;
+    _center->reset();
+}
+/****************************************************************************/
+Vec2f Joystick::drift() const {
+    return _center ? _center->drift() : Vec2f();
+}
+/****************************************************************************/
+void Joystick::attachSmoother(OneEuroFilter<2>& smoother){
+    _smoother = &smoother;
+    _smoother->reset();
+}
+/****************************************************************************/
+bool Joystick::calibrateCoil(CoilScheduler& coils, uint8_t coil, uint8_t repeats){
+    // Fire the coil (kick only) a few times from rest and let the guard
+    // average what the accelerometer sees after each kick
+    if(!_guard){ return ErrorMsg("No vibration guard attached!"); }
+    if(coil >= coils.size()){ return ErrorMsg("Unknown coil!"); }
+    const uint8_t id = coils.getDriver(coil).getChannel();
+    Serial.printf("🎯 Learning coil %d response...do not touch!\n", id);
+    Serial.flush(); delay(100);
+    const uint32_t dt = getInterval();
+    _guard->beginCapture(id);
+    for (uint8_t r = 0; r < repeats; r++) {
+        Vec3f rest;
+        uint8_t restCount = 0;
+        for (uint8_t k = 0; k < 8; k++) {
+            do {
+                if(accel.read()){ rest += accel.coords; restCount++; }
+            } while(accel.available());
+            delay(dt);
+        }
+        if(restCount == 0){ continue; }
+        _guard->setBaseline(rest / static_cast<float>(restCount));
+        coils.fire(coil, coils.getProfile(coil).kickUs);
+        for (uint8_t k = 0; k < GUARD_BINS + 2; k++) {
+            delay(dt);
+            do {
+                if(accel.read()){ _guard->process(accel.coords, accel._sampledUs); }
+            } while(accel.available());
+        }
+    }
+    if(!_guard->endCapture()){
+        return ErrorMsg("Coil calibration failed! No valid samples.");
+    }
+    Serial.printf(
+        "✅ Coil %d Response Learned: Peak = %.2f m/s², Fires = %d\n",
+        id, _guard->responsePeak(id), repeats
+    );
+    return true;
+}
+/****************************************************************************/
 bool Joystick::readRaw() {
-    String msg = "Joystick not reading raw!";
-    if(!accel.read()){ return ErrorMsg(msg); }
-    _tilt = tiltProjection(accel.coords);
+    // Nothing new from the accelerometer (it reports its own errors)
+    if(!accel.read()){ return false; }
+    if(_canceller) { _canceller->apply(accel.coords); }
+    _guarded = _guard ? _guard->process(accel.coords, accel._sampledUs) : GuardMode::NONE;
+    if(_mount) { _mount->apply(accel.coords); }
+    if(_gravity) {
+        // Tilt from the slow gravity estimate; shoves stay in nudge()
+        _gravity->update(accel.coords);
+        _tilt = _gravity->tilt();
+    } else {
+        _tilt = tiltProjection(accel.coords);
+    }
     return true; 
 }
 /****************************************************************************/
 bool Joystick::readCalibrated(){
-    String msg = "Joystick not reading calibrated!";
-    if(!readRaw()) { return ErrorMsg(msg); }
+    if(!readRaw()) { return false; }
+    if(_center) {
+        // A masked coil kick is not rest; start the window over
+        if(_guarded == GuardMode::NONE) { _center->update(_tilt, _zero); }
+        else { _center->interrupt(); }
+    }
     _tilt -= _zero;
     return true; 
 }
 /****************************************************************************/
 bool Joystick::readClipped(){
-    String msg = "Joystick not reading filtered!";
-    if(!readCalibrated()) { return ErrorMsg(msg); }
+    if(!readCalibrated()) { return false; }
+    // Smooth in degrees, before clipping, so the tunables are in deg & deg/s
+    if(_smoother) { _tilt = _smoother->apply(_tilt); }
+    clip();
+    return true;
+}
+/****************************************************************************/
+void Joystick::clip(){
     // 1. We clip first! 
     _tilt[0] = constrain(_tilt[0], -_maxTilt, _maxTilt);
     _tilt[1] = constrain(_tilt[1], -_maxTilt, _maxTilt);
     // 2. "Project" angles to XY via linar response
     _tilt /= _maxTilt;
-    return true;
 }
 /****************************************************************************/
-Vec2f Joystick::read(){
-    if(!readClipped()) { return Vec2f(); }
+void Joystick::respond(){
     // Cubic Response
     for( size_t k = 0; k<_tilt.size(); k++) {
         _tilt[k] = powf(_tilt[k], 3.f);
     }
-    return _tilt;
+}
+/****************************************************************************/
+Vec2f Joystick::read(){
+    // Every sample the accelerometer has ready goes through the stages once,
+    // oldest first; the output is the newest. A read with nothing new keeps
+    // the previous output.
+    do {
+        if(!readClipped()) { break; }
+        respond();
+        // Coil kick in progress: don't pass the cabinet shake on as a nudge
+        if(_guarded == GuardMode::BLANK) { _tilt = Vec2f(); }
+        else if(_guarded == GuardMode::HOLD) { _tilt = _held; }
+        else { _held = _tilt; }
+        _out = _tilt;
+    } while(accel.available());
+    return _out;
 }
 /****************************************************************************/
 void Joystick::print(Stream& stream){
@@ -100,4 +223,4 @@ void Joystick::print(Stream& stream){
     //float toc = 1e-3 * static_cast<float>(accel._tic);
     //stream.printf("%d\t%.2f\t%.2f\n", accel._tic, _tilt[0], _tilt[1]);
 }
-/****************************************************************************/
\ No newline at end of file
+/****************************************************************************/
@@ -3,6 +3,14 @@
 
 #pragma once
 #include "Accelerometer.hpp"
+#include "VibrationGuard.hpp"
+#include "NoiseCanceller.hpp"
+#include "MountTransform.hpp"
+#include "GravityTracker.hpp"
+#include "AutoCenter.hpp"
+#include "OneEuro.hpp"
+
+class CoilScheduler;
 
 /****************************************************************************/
 class Joystick {
@@ -14,10 +22,22 @@ private:
     Vec2f _tilt;                    // This is my pitch & roll! 
     Vec2f _zero;                    // Tilt Average for DC Offet to Zero
     bool _init; 
+
+    AccelStage* _canceller;         // Optional drive-correlated vibration removal
+    const MountTransform* _mount;   // Optional sensor -> cabinet rotation
+    GravityTracker* _gravity;       // Optional slow tilt / fast nudge split
+    AutoCenter* _center;            // Optional drift tracking of _zero
+    OneEuroFilter<2>* _smoother;    // Optional adaptive smoothing of the tilt
+    VibrationGuard* _guard;         // Optional coil-kick rejection
+    GuardMode _guarded;             // Verdict on the latest sample
+    Vec2f _held;                    // Last clean output, for GuardMode::HOLD
+    Vec2f _out;                     // Latest read() output
  
     bool readRaw(); 
     bool readCalibrated(); 
     bool readClipped(); 
+    void clip();
+    void respond();
 
 public:
 
@@ -26,6 +46,16 @@ public:
     bool begin();
     Vec2f read();
     bool calibrate(Vec2f manual = Vec2f(NAN));
+    void attachCanceller(AccelStage& canceller);
+    void attachGuard(VibrationGuard& guard);
+    void attachMount(const MountTransform& mount);
+    void attachGravity(GravityTracker& gravity);
+    Vec3f nudge() const;            // Cabinet acceleration of the latest read(), m/s^2
+    uint32_t sampledMicros() const; // micros() the sensor took the sample behind the latest read()
+    void attachAutoCenter(AutoCenter& center);
+    Vec2f drift() const;
+    void attachSmoother(OneEuroFilter<2>& smoother);
+    bool calibrateCoil(CoilScheduler& coils, uint8_t coil, uint8_t repeats = 8);
     void print(Stream& stream);
 };
 /****************************************************************************/
@@ -0,0 +1,64 @@
+#ifndef MOUNT_TRANSFORM_HPP
+#define MOUNT_TRANSFORM_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <Adafruit_Sensor.h>
+#include "utilities.hpp"
+#include "vectors.hpp"
+#include "Rotation.hpp"
+#include "Seqlock.hpp"
+
+// cabinet.md: the top rises 6.5 deg from the front face to the back
+constexpr double CABINET_SLOPE_DEG = 6.5;
+
+// Sensor flat on the sloped top, axes otherwise square to the cabinet
+inline constexpr Mat3 CABINET_MOUNT = mountMatrix(0, CABINET_SLOPE_DEG);
+static_assert(CABINET_MOUNT.m[1][1] == 1.f && CABINET_MOUNT.m[0][2] > 0.113f && CABINET_MOUNT.m[0][2] < 0.114f,
+              "CABINET_MOUNT should pitch by sin(6.5 deg) about Y only");
+
+/****************************************************************************/
+// Rotates each sample from the sensor's axes into the cabinet's before
+// tiltProjection(), so a sensor that sits on the sloped top or turned on
+// the PCB still reads zero tilt on a level cabinet.
+//
+// Fixed mounts pass a constexpr matrix (CABINET_MOUNT, mountMatrix()).
+// learn() replaces it at runtime from gravity measured at rest; the matrix
+// is published through a seqlock, so the acquisition task never sees half
+// of an update made from another core.
+class MountTransform {
+
+private:
+    Seqlock<Mat3> _matrix;
+
+public:
+
+    MountTransform(const Mat3& mount = CABINET_MOUNT) { _matrix.write(mount); }
+
+    void set(const Mat3& mount) { _matrix.write(mount); }
+    Mat3 get() const { return _matrix.read(); }
+
+    void apply(Vec3f& coords) const { coords = _matrix.read() * coords; }
+
+    // Level the sensor on gravity averaged at rest (m/s^2, sensor frame).
+    // Only roll and pitch are observable; yawDeg adds a known turn about
+    // the vertical.
+    bool learn(const Vec3f& restGravity, double yawDeg = 0) {
+        const float g = restGravity.magnitude();
+        if (g < 0.5f * SENSORS_GRAVITY_STANDARD || g > 1.5f * SENSORS_GRAVITY_STANDARD) {
+            return ErrorMsg("Mount learning needs the cabinet at rest!");
+        }
+        set(rotationZ(yawDeg) * alignToZ(restGravity));
+        return true;
+    }
+
+    void print(Stream& stream = Serial) const {
+        const Mat3 m = get();
+        for (uint8_t i = 0; i < 3; i++) {
+            stream.printf("  [%8.5f %8.5f %8.5f]\n", m.m[i][0], m.m[i][1], m.m[i][2]);
+        }
+    }
+};
+/****************************************************************************/
+
+#endif
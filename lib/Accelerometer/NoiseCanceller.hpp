@@ -0,0 +1,198 @@
+#ifndef NOISE_CANCELLER_HPP
+#define NOISE_CANCELLER_HPP
+
+#pragma once
+#include "vectors.hpp"
+#include "Solenoid.hpp"
+#include "ShakerMotor.hpp"
+
+/****************************************************************************/
+// Acceleration is handled as Q8 m/s^2 inside the canceller (1 LSB ~ 4 mm/s^2)
+constexpr int32_t ACCEL_Q8 = 256;
+
+// Anything in the accelerometer pipeline that can clean a sample in place
+class AccelStage {
+public:
+    virtual ~AccelStage() = default;
+    virtual void apply(Vec3f& coords) = 0;
+};
+
+/****************************************************************************/
+// Adaptive NLMS canceller for vibration driven by our own actuators.
+//
+// The references are the drive signals we already know (coil PWM duties,
+// shaker intensity), each kept in a Taps-long delay line. Per axis, an FIR
+// over all delay lines predicts how much of the sample the drives explain;
+// that prediction is subtracted and the weights follow the residual:
+//
+//   y = sum(w * x),  e = d - y,  w += mu * e * x / (eps + sum(x^2))
+//
+// Everything per sample is integer: references are zero-mean Q12 (DC is
+// tracked and removed), weights Q24, one 64-bit divide per axis. The
+// reference power is kept as a running sum, so a sample costs
+// 3 axes * Refs * Taps multiply-adds twice. Adaptation runs on the
+// residual with its own DC removed, so gravity and slow tilt don't drag the
+// weights around.
+//
+// It runs once per Joystick sample, at SMPL_FREQ: 16 taps span 160 ms at
+// 100 Hz, which covers the cabinet's sway after a drive change. Only what
+// rings below half that rate can be cancelled (the CIC front end keeps the
+// rest out), and drives are read once per sample, so the canceller is for
+// sustained drives (shakers, rumble envelopes). Single coil kicks are
+// shorter than a sample; VibrationGuard handles those from fire events.
+// The DC trackers run over 16 filter spans (2.56 s at 16 taps): any
+// faster and they high-pass the references inside the span the weights
+// model.
+template<uint8_t Refs, uint8_t Taps = 16>
+class NoiseCanceller : public AccelStage {
+    static_assert(Refs >= 1 && Taps >= 1, "Need at least one reference and one tap");
+
+private:
+    static constexpr uint8_t AXES = 3;
+
+    static constexpr uint8_t log2ceil(uint32_t v) {
+        uint8_t s = 0;
+        while ((1u << s) < v) { s++; }
+        return s;
+    }
+    static constexpr uint8_t DC_SHIFT = log2ceil(16u * Taps);  // DC trackers: 2^DC_SHIFT samples
+    static constexpr uint8_t W_SHIFT = 24;          // Weight fraction bits; small steps must not round away
+
+    // Drive references bound with addReference()
+    const Solenoid* _coils[Refs] = {};
+    const ShakerMotor* _motors[Refs] = {};
+    uint8_t _bound = 0;
+
+    int16_t _x[Refs][Taps] = {};        // Delay lines, newest at _head
+    uint8_t _head = 0;
+    int32_t _refMean[Refs] = {};        // Q8 of the Q12 reference
+    int64_t _power = 0;                 // sum of x^2 over all delay lines
+    int32_t _w[AXES][Refs][Taps] = {};  // Q24
+    int32_t _dMean[AXES] = {};          // Q8 of the Q8 input
+    bool _primed = false;               // DC trackers start from the first sample
+
+    int32_t _muQ15;
+    int64_t _eps;
+
+    uint32_t _samples = 0;
+    uint32_t _lastCycles = 0, _maxCycles = 0;
+
+    int16_t readReference(uint8_t r) const {
+        if (_coils[r]) { return static_cast<int16_t>(_coils[r]->getDuty()); }
+        if (_motors[r]) { return _motors[r]->getIntensity(); }
+        return 0;
+    }
+
+public:
+    /**
+     * @param mu Adaptation step, 0..1. Larger converges faster but is noisier.
+     * @param epsilon Regularisation of the power normalisation, in Q12^2
+     */
+    NoiseCanceller(float mu = 0.25f, uint32_t epsilon = 4096)
+        : _muQ15(static_cast<int32_t>(constrain(mu, 0.f, 1.f) * 32767.f)), _eps(epsilon) {}
+
+    // Bind a drive as the next reference. Returns its index, -1 when full.
+    int8_t addReference(const Solenoid& coil) {
+        if (_bound >= Refs) { return -1; }
+        _coils[_bound] = &coil;
+        return static_cast<int8_t>(_bound++);
+    }
+
+    int8_t addReference(const ShakerMotor& motor) {
+        if (_bound >= Refs) { return -1; }
+        _motors[_bound] = &motor;
+        return static_cast<int8_t>(_bound++);
+    }
+
+    void setStepSize(float mu) { _muQ15 = static_cast<int32_t>(constrain(mu, 0.f, 1.f) * 32767.f); }
+
+    void reset() {
+        memset(_x, 0, sizeof(_x));
+        memset(_w, 0, sizeof(_w));
+        memset(_refMean, 0, sizeof(_refMean));
+        memset(_dMean, 0, sizeof(_dMean));
+        _power = 0;
+        _head = 0;
+        _primed = false;
+    }
+
+    /**
+     * @brief Core update, fixed point
+     * @param refs Newest drive levels (duty 0..4095, or signed intensity)
+     * @param d Accelerometer sample, Q8 m/s^2, cleaned in place
+     */
+    void process(const int16_t (&refs)[Refs], int32_t (&d)[AXES]) {
+        const uint32_t tic = ESP.getCycleCount();
+
+        if (!_primed) {
+            for (uint8_t r = 0; r < Refs; r++) { _refMean[r] = static_cast<int32_t>(refs[r]) << DC_SHIFT; }
+            for (uint8_t a = 0; a < AXES; a++) { _dMean[a] = d[a] << DC_SHIFT; }
+            _primed = true;
+        }
+
+        // Push zero-mean references, keeping the power sum current
+        _head = _head ? _head - 1 : Taps - 1;
+        for (uint8_t r = 0; r < Refs; r++) {
+            // Rounded so a held drive settles to x = 0 exactly: the mean
+            // stops within (-half, half] of it
+            constexpr int32_t half = 1 << (DC_SHIFT - 1);
+            _refMean[r] += ((static_cast<int32_t>(refs[r]) << DC_SHIFT) - _refMean[r] + half) >> DC_SHIFT;
+            const int16_t x = static_cast<int16_t>(refs[r] - ((_refMean[r] + half - 1) >> DC_SHIFT));
+            const int16_t old = _x[r][_head];
+            _power += static_cast<int32_t>(x) * x - static_cast<int32_t>(old) * old;
+            _x[r][_head] = x;
+        }
+
+        for (uint8_t a = 0; a < AXES; a++) {
+            int64_t acc = 0;
+            for (uint8_t r = 0; r < Refs; r++) {
+                for (uint8_t t = 0, i = _head; t < Taps; t++, i = (i + 1 == Taps) ? 0 : i + 1) {
+                    acc += static_cast<int64_t>(_w[a][r][t]) * _x[r][i];
+                }
+            }
+            const int32_t y = static_cast<int32_t>((acc + (1ll << (W_SHIFT - 1))) >> W_SHIFT);
+
+            // Adapt on the AC part of the residual
+            _dMean[a] += ((d[a] << DC_SHIFT) - _dMean[a]) >> DC_SHIFT;
+            const int32_t e = (d[a] - (_dMean[a] >> DC_SHIFT)) - y;
+            d[a] -= y;
+
+            // w += mu e x / P in Q24: one divide per axis, then rounded shifts.
+            // Held drives leave x at quantisation noise, which explains
+            // nothing; adapting on it would only fit the player's motion.
+            if (_power < _eps) { continue; }
+            const int64_t step = (static_cast<int64_t>(_muQ15) * e * (1ll << (W_SHIFT + 5))) / (_power + _eps);
+            for (uint8_t r = 0; r < Refs; r++) {
+                for (uint8_t t = 0, i = _head; t < Taps; t++, i = (i + 1 == Taps) ? 0 : i + 1) {
+                    _w[a][r][t] += static_cast<int32_t>((step * _x[r][i] + (1ll << 19)) >> 20);
+                }
+            }
+        }
+
+        _lastCycles = ESP.getCycleCount() - tic;
+        _maxCycles = max(_maxCycles, _lastCycles);
+        _samples++;
+    }
+
+    // Pipeline stage: read the bound drives and clean one sample (m/s^2)
+    void apply(Vec3f& coords) override {
+        int16_t refs[Refs];
+        for (uint8_t r = 0; r < Refs; r++) { refs[r] = readReference(r); }
+        int32_t d[AXES];
+        for (uint8_t a = 0; a < AXES; a++) { d[a] = static_cast<int32_t>(lroundf(coords[a] * ACCEL_Q8)); }
+        process(refs, d);
+        for (uint8_t a = 0; a < AXES; a++) { coords[a] = static_cast<float>(d[a]) / ACCEL_Q8; }
+    }
+
+    uint32_t samples() const { return _samples; }
+    uint32_t lastCycles() const { return _lastCycles; }
+    uint32_t maxCycles() const { return _maxCycles; }
+
+    void print(Stream& stream = Serial) const {
+        stream.printf("NoiseCanceller: %d refs x %d taps, %lu samples, last %lu / max %lu cycles per sample\n",
+            Refs, Taps, _samples, _lastCycles, _maxCycles);
+    }
+};
+/****************************************************************************/
+
+#endif
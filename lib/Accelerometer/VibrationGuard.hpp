@@ -0,0 +1,193 @@
+#ifndef VIBRATION_GUARD_HPP
+#define VIBRATION_GUARD_HPP
+
+#pragma once
+#include "vectors.hpp"
+#include "utilities.hpp"
+#include "CoilEvents.hpp"
+
+/****************************************************************************/
+// What to do with accelerometer output while a coil kick rings the cabinet
+enum class GuardMode : uint8_t {
+    NONE,           // Pass through
+    HOLD,           // Repeat the last clean output for the window
+    BLANK,          // Output zero for the window
+    SUBTRACT        // Remove the learned response; HOLD until it is learned
+};
+
+constexpr uint8_t GUARD_COILS = 8;                                  // By LEDC channel
+constexpr uint8_t GUARD_BINS = 32;                                  // Response length, in samples
+constexpr uint32_t GUARD_BIN_US = static_cast<uint32_t>(1e6f / SMPL_FREQ);
+
+/****************************************************************************/
+// Sits between the ADXL345 and the tilt projection. Fire events arrive from
+// the coil drivers through a CoilEventQueue; each sample is then corrected
+// (SUBTRACT) or flagged (HOLD/BLANK) according to the coils still ringing.
+//
+// Responses are captured per coil as the mean deviation from a resting
+// baseline, one bin per sample period after the kick, averaged over
+// several fires (see Joystick::calibrateCoil). Subtraction can only undo
+// ringing below half the sample rate (SMPL_FREQ); use HOLD or BLANK for
+// coils that ring faster than that.
+class VibrationGuard {
+
+private:
+    struct CoilGuard {
+        GuardMode mode;
+        uint32_t windowUs;
+        uint32_t lastFire;
+        bool ringing;
+        bool learned;
+        Vec3f response[GUARD_BINS];
+    };
+
+    CoilEventQueue& _events;
+    CoilGuard _coils[GUARD_COILS];
+
+    // Capture state, one coil at a time
+    int8_t _capture = -1;
+    Vec3f _baseline;
+    Vec3f _sum[GUARD_BINS];
+    float _weight[GUARD_BINS];
+
+    uint32_t _samples = 0, _suppressed = 0, _subtracted = 0, _fires = 0;
+
+public:
+
+    VibrationGuard(CoilEventQueue& events) : _events(events) {
+        for (uint8_t k = 0; k < GUARD_COILS; k++) {
+            _coils[k] = CoilGuard{GuardMode::NONE, 0, 0, false, false, {}};
+        }
+    }
+
+    // Window is how long after a kick the coil counts as ringing
+    void configure(uint8_t coil, GuardMode mode, uint32_t windowUs = 60000) {
+        if (coil >= GUARD_COILS) { return; }
+        _coils[coil].mode = mode;
+        _coils[coil].windowUs = windowUs;
+    }
+
+    // Apply to one fresh sample (m/s^2, sensor frame) taken at sampledUs
+    // (micros() at acquisition, not now: the sample may sit in the FIFO or
+    // wait for the poll while fire events come in). Corrects coords in
+    // place for SUBTRACT and returns the strongest suppression requested by
+    // a ringing coil: BLANK over HOLD over NONE.
+    GuardMode process(Vec3f& coords, uint32_t sampledUs) {
+        CoilEvent ev;
+        while (_events.pop(ev)) {
+            if (ev.coil >= GUARD_COILS) { continue; }
+            _coils[ev.coil].lastFire = ev.us;
+            _coils[ev.coil].ringing = true;
+            _fires++;
+        }
+        _samples++;
+
+        GuardMode out = GuardMode::NONE;
+        for (uint8_t k = 0; k < GUARD_COILS; k++) {
+            CoilGuard& c = _coils[k];
+            if (!c.ringing) { continue; }
+            const uint32_t age = sampledUs - c.lastFire;
+            if (static_cast<int32_t>(age) < 0) { continue; }          // Event stamped after the sample
+
+            // Samples rarely land on bin centres: split each one between the
+            // two neighbouring bins on capture, interpolate on playback
+            const float pos = static_cast<float>(age) / GUARD_BIN_US;
+            const uint32_t bin = static_cast<uint32_t>(pos);
+            const float frac = pos - bin;
+
+            if (k == _capture) {
+                if (bin + 1 < GUARD_BINS) {
+                    const Vec3f dev = coords - _baseline;
+                    _sum[bin] += dev * (1.f - frac);
+                    _weight[bin] += 1.f - frac;
+                    _sum[bin + 1] += dev * frac;
+                    _weight[bin + 1] += frac;
+                } else {
+                    c.ringing = false;
+                }
+                continue;
+            }
+
+            const bool inWindow = age < c.windowUs;
+            switch (c.mode) {
+                case GuardMode::SUBTRACT:
+                    if (c.learned) {
+                        if (bin + 1 < GUARD_BINS) {
+                            coords -= c.response[bin] * (1.f - frac) + c.response[bin + 1] * frac;
+                            _subtracted++;
+                        }
+                        break;
+                    }
+                    // fall through - nothing learned yet
+                case GuardMode::HOLD:
+                    if (inWindow && out == GuardMode::NONE) { out = GuardMode::HOLD; }
+                    break;
+                case GuardMode::BLANK:
+                    if (inWindow) { out = GuardMode::BLANK; }
+                    break;
+                case GuardMode::NONE:
+                    break;
+            }
+            if (!inWindow && age >= GUARD_BINS * GUARD_BIN_US) { c.ringing = false; }
+        }
+        if (out != GuardMode::NONE) { _suppressed++; }
+        return out;
+    }
+
+    // Capture: begin, then for each fire set the resting baseline just
+    // before kicking and keep feeding samples through process()
+    void beginCapture(uint8_t coil) {
+        if (coil >= GUARD_COILS) { return; }
+        _capture = coil;
+        for (uint8_t b = 0; b < GUARD_BINS; b++) { _sum[b] = Vec3f(); _weight[b] = 0.f; }
+    }
+
+    void setBaseline(const Vec3f& rest) { _baseline = rest; }
+
+    // Averages the captured bins into the coil's response. Bins that no
+    // fire reached are left at zero.
+    bool endCapture() {
+        if (_capture < 0) { return false; }
+        CoilGuard& c = _coils[_capture];
+        uint16_t filled = 0;
+        for (uint8_t b = 0; b < GUARD_BINS; b++) {
+            const bool hit = _weight[b] > 0.25f;
+            c.response[b] = hit ? _sum[b] / _weight[b] : Vec3f();
+            filled += hit ? 1 : 0;
+        }
+        c.learned = filled > 0;
+        c.ringing = false;
+        _capture = -1;
+        return c.learned;
+    }
+
+    bool learned(uint8_t coil) const { return coil < GUARD_COILS && _coils[coil].learned; }
+    const Vec3f* response(uint8_t coil) const { return coil < GUARD_COILS ? _coils[coil].response : nullptr; }
+
+    // Peak magnitude of a learned response, m/s^2
+    float responsePeak(uint8_t coil) const {
+        float peak = 0.f;
+        if (coil >= GUARD_COILS) { return peak; }
+        for (uint8_t b = 0; b < GUARD_BINS; b++) { peak = max(peak, _coils[coil].response[b].magnitude()); }
+        return peak;
+    }
+
+    uint32_t fires() const { return _fires; }
+    uint32_t samples() const { return _samples; }
+    uint32_t suppressed() const { return _suppressed; }
+    uint32_t subtracted() const { return _subtracted; }
+
+    void print(Stream& stream = Serial) const {
+        stream.printf("VibrationGuard: %lu fires, %lu samples, %lu suppressed, %lu corrected, %lu events dropped\n",
+            _fires, _samples, _suppressed, _subtracted, _events.dropped());
+        for (uint8_t k = 0; k < GUARD_COILS; k++) {
+            if (_coils[k].mode == GuardMode::NONE) { continue; }
+            stream.printf("  coil %d: mode %d, window %lu us, %s (peak %.2f m/s^2)\n", k,
+                static_cast<int>(_coils[k].mode), _coils[k].windowUs,
+                _coils[k].learned ? "learned" : "not learned", responsePeak(k));
+        }
+    }
+};
+/****************************************************************************/
+
+#endif
@@ -1,7 +1,9 @@
 #pragma once
 #include <Arduino.h>
 #include "LED.hpp"
+#include "FadeLED.hpp"
 #include "Switch.hpp"
+#include "Effects.hpp"
 
 /******************************************************************************/
 class ArcadeButton
@@ -11,6 +13,7 @@ private:
     PulseLED redLED;
     PulseLED greenLED;
     PulseLED blueLED;
+    RGBFadeLED pwmLED; // Used instead of the PulseLEDs once beginPWM() succeeds
 
 public:
     enum LEDMode
@@ -43,6 +46,7 @@ public:
           redLED(redPin, pulseOnTime, pulseOffTime),
           greenLED(greenPin, pulseOnTime, pulseOffTime),
           blueLED(bluePin, pulseOnTime, pulseOffTime),
+          pwmLED(redPin, greenPin, bluePin),
           currentMode(PULSE_BLUE),
           colorCycleIndex(0)
     {
@@ -54,6 +58,11 @@ public:
 private:
     void allLEDsOff()
     {
+        if (pwmLED.attached())
+        {
+            pwmLED.write(RGB12{0, 0, 0});
+            return;
+        }
         redLED.off();
         greenLED.off();
         blueLED.off();
@@ -61,6 +70,13 @@ private:
 
     void setSolidColor(bool red, bool green, bool blue)
     {
+        if (pwmLED.attached())
+        {
+            pwmLED.write(RGB12{red ? LEVEL_MAX : uint16_t(0),
+                               green ? LEVEL_MAX : uint16_t(0),
+                               blue ? LEVEL_MAX : uint16_t(0)});
+            return;
+        }
         redLED.stopPulse();
         greenLED.stopPulse();
         blueLED.stopPulse();
@@ -81,6 +97,15 @@ private:
 
     void setPulseColor(bool red, bool green, bool blue)
     {
+        // On LEDC the pulse becomes a hardware breathe with the same timing
+        if (pwmLED.attached())
+        {
+            pwmLED.breathe(RGB12{red ? LEVEL_MAX : uint16_t(0),
+                                 green ? LEVEL_MAX : uint16_t(0),
+                                 blue ? LEVEL_MAX : uint16_t(0)},
+                           redLED.getOnTime(), redLED.getOffTime());
+            return;
+        }
         // Use current timing for each LED
         if (red)
         {
@@ -108,87 +133,42 @@ private:
         }
     }
 
-    void cycleToNextColor()
+    // Full colour on LEDC, otherwise threshold onto the on/off channels
+    void showColor(const RGB &color)
     {
-        colorCycleIndex = (colorCycleIndex + 1) % 7;
-        switch (colorCycleIndex)
+        if (pwmLED.attached())
         {
-        case 0:
-            setSolidColor(0, 0, 0);
-            break; // Off
-        case 1:
-            setSolidColor(1, 0, 0);
-            break; // Red
-        case 2:
-            setSolidColor(0, 1, 0);
-            break; // Green
-        case 3:
-            setSolidColor(0, 0, 1);
-            break; // Blue
-        case 4:
-            setSolidColor(1, 1, 0);
-            break; // Yellow
-        case 5:
-            setSolidColor(1, 0, 1);
-            break; // Magenta
-        case 6:
-            setSolidColor(0, 1, 1);
-            break; // Cyan
+            pwmLED.write(gammaCorrect(color));
+            return;
         }
+        setSolidColor(color.r >= 128, color.g >= 128, color.b >= 128);
     }
 
-    void setRainbowColor(int step)
+    template <size_t K>
+    void showPaletteColor(const RGB (&palette)[K], int index)
     {
-        switch (step % 6)
-        {
-        case 0:
-            setSolidColor(1, 0, 0);
-            break; // Red
-        case 1:
-            setSolidColor(1, 1, 0);
-            break; // Yellow
-        case 2:
-            setSolidColor(0, 1, 0);
-            break; // Green
-        case 3:
-            setSolidColor(0, 1, 1);
-            break; // Cyan
-        case 4:
-            setSolidColor(0, 0, 1);
-            break; // Blue
-        case 5:
-            setSolidColor(1, 0, 1);
-            break; // Magenta
-        }
+        showColor(palette[index % K]);
     }
 
-    void setRandomColor()
+    // Track for each mode; nullptr for modes driven by button events
+    static const Effect *modeEffect(LEDMode mode)
     {
-        int color = random(7);
-        switch (color)
-        {
-        case 0:
-            setSolidColor(1, 0, 0);
-            break; // Red
-        case 1:
-            setSolidColor(0, 1, 0);
-            break; // Green
-        case 2:
-            setSolidColor(0, 0, 1);
-            break; // Blue
-        case 3:
-            setSolidColor(1, 1, 0);
-            break; // Yellow
-        case 4:
-            setSolidColor(1, 0, 1);
-            break; // Magenta
-        case 5:
-            setSolidColor(0, 1, 1);
-            break; // Cyan
-        case 6:
-            setSolidColor(1, 1, 1);
-            break; // White
-        }
+        static const Effect *const table[MODE_COUNT] = {
+            &Effects::OFF,               // OFF
+            &Effects::SOLID_RED,         // SOLID_RED
+            &Effects::SOLID_GREEN,       // SOLID_GREEN
+            &Effects::SOLID_BLUE,        // SOLID_BLUE
+            &Effects::PULSE_RED,         // PULSE_RED
+            &Effects::PULSE_GREEN,       // PULSE_GREEN
+            &Effects::PULSE_BLUE,        // PULSE_BLUE
+            nullptr,                     // PRESS_COLOR_CYCLE
+            nullptr,                     // PRESS_RAINBOW
+            nullptr,                     // STATUS_INDICATOR
+            &Effects::BREATHING_RAINBOW, // BREATHING_RAINBOW
+            &Effects::CHASE,             // CHASE
+            nullptr                      // RANDOM_COLOR_PRESS
+        };
+        return (mode < MODE_COUNT) ? table[mode] : nullptr;
     }
 
 public:
@@ -204,61 +184,45 @@ public:
 
         allLEDsOff();
 
-        // Set up mode-specific behavior
+        // Timed modes play a keyframe track; the rest react to presses
+        effect.stop();
+        const Effect *fx = modeEffect(currentMode);
+        if (fx)
+        {
+            effect.play(*fx, millis());
+            showColor(effect.evaluate(millis()));
+        }
+
         switch (currentMode)
         {
-        case OFF:
-            setSolidColor(0, 0, 0);
-            break;
-        case SOLID_RED:
-            setSolidColor(1, 0, 0);
-            break;
-        case SOLID_GREEN:
-            setSolidColor(0, 1, 0);
-            break;
-        case SOLID_BLUE:
-            setSolidColor(0, 0, 1);
-            break;
-        case PULSE_RED:
-            setPulseColor(1, 0, 0);
-            break;
-        case PULSE_GREEN:
-            setPulseColor(0, 1, 0);
-            break;
-        case PULSE_BLUE:
-            setPulseColor(0, 0, 1);
-            break;
         case PRESS_COLOR_CYCLE:
-            setSolidColor(0, 0, 0);
+            showColor(Effects::BLACK);
             button.onPress([this]()
-                           { cycleToNextColor(); });
+                           {
+        colorCycleIndex = (colorCycleIndex + 1) % Effects::paletteSize(Effects::CYCLE_PALETTE);
+        showPaletteColor(Effects::CYCLE_PALETTE, colorCycleIndex); });
             break;
         case PRESS_RAINBOW:
-            setSolidColor(1, 0, 0);
             colorCycleIndex = 0;
+            showPaletteColor(Effects::RAINBOW_PALETTE, colorCycleIndex);
             button.onPress([this]()
                            {
-        colorCycleIndex = (colorCycleIndex + 1) % 6;
-        setRainbowColor(colorCycleIndex); });
+        colorCycleIndex = (colorCycleIndex + 1) % Effects::paletteSize(Effects::RAINBOW_PALETTE);
+        showPaletteColor(Effects::RAINBOW_PALETTE, colorCycleIndex); });
             break;
         case STATUS_INDICATOR:
-            setSolidColor(0, 1, 0);
+            showColor(Effects::GREEN);
             button.onPress([this]()
-                           { setSolidColor(1, 0, 0); });
+                           { showColor(Effects::RED); });
             button.onRelease([this]()
-                             { setSolidColor(0, 1, 0); });
-            break;
-        case BREATHING_RAINBOW:
-            colorCycleIndex = 0;
-            setRainbowColor(0);
-            break;
-        case CHASE:
-            setSolidColor(1, 0, 0);
+                             { showColor(Effects::GREEN); });
             break;
         case RANDOM_COLOR_PRESS:
-            setSolidColor(0, 0, 0);
+            showColor(Effects::BLACK);
             button.onPress([this]()
-                           { setRandomColor(); });
+                           { showPaletteColor(Effects::RANDOM_PALETTE, random(Effects::paletteSize(Effects::RANDOM_PALETTE))); });
+            break;
+        default:
             break;
         }
 
@@ -306,43 +270,23 @@ public:
         redLED.update();
         greenLED.update();
         blueLED.update();
+        pwmLED.update();
         updateAutomaticModes();
     }
 
 private:
-    unsigned long lastAutoUpdate = 0;
-    const unsigned long AUTO_UPDATE_INTERVAL = 1000;
+    EffectPlayer effect;
+    unsigned long lastFrame = 0;
 
     void updateAutomaticModes()
     {
+        if (!effect.playing())
+            return;
         unsigned long currentMillis = millis();
-        if (currentMillis - lastAutoUpdate >= AUTO_UPDATE_INTERVAL)
+        if (currentMillis - lastFrame >= LED_FRAME_MS)
         {
-            lastAutoUpdate = currentMillis;
-
-            switch (currentMode)
-            {
-            case BREATHING_RAINBOW:
-                colorCycleIndex = (colorCycleIndex + 1) % 6;
-                setRainbowColor(colorCycleIndex);
-                break;
-
-            case CHASE:
-                colorCycleIndex = (colorCycleIndex + 1) % 3;
-                switch (colorCycleIndex)
-                {
-                case 0:
-                    setSolidColor(1, 0, 0);
-                    break;
-                case 1:
-                    setSolidColor(0, 1, 0);
-                    break;
-                case 2:
-                    setSolidColor(0, 0, 1);
-                    break;
-                }
-                break;
-            }
+            lastFrame = currentMillis;
+            showColor(effect.evaluate(currentMillis));
         }
     }
 
@@ -401,6 +345,7 @@ public:
 
     void setColor(bool red, bool green, bool blue)
     {
+        effect.stop();
         setSolidColor(red, green, blue);
     }
 
@@ -410,11 +355,57 @@ public:
         redLED.setPulseTiming(onTime, offTime);
         greenLED.setPulseTiming(onTime, offTime);
         blueLED.setPulseTiming(onTime, offTime);
+        effect.stop();
         setPulseColor(red, green, blue);
     }
 
+    // Move the lamp onto three LEDC channels for 12-bit colour and hardware
+    // fades. Returns false (and stays on GPIO) if the channels are taken;
+    // at most LED_PWM_RGB_MAX buttons get them.
+    bool beginPWM()
+    {
+        if (!pwmLED.begin())
+            return false;
+        setupModeCallbacks();
+        return true;
+    }
+
+    bool isPWM() const { return pwmLED.attached(); }
+
+    // Arbitrary colour; needs beginPWM(), otherwise thresholded to on/off
+    void setRGB(const RGB &color)
+    {
+        effect.stop();
+        showColor(color);
+    }
+
+    void fadeTo(const RGB &color, uint16_t ms)
+    {
+        effect.stop();
+        if (pwmLED.attached())
+            pwmLED.fadeTo(gammaCorrect(color), ms);
+        else
+            showColor(color);
+    }
+
+    void breathe(const RGB &color, uint16_t riseMs, uint16_t fallMs)
+    {
+        effect.stop();
+        if (pwmLED.attached())
+            pwmLED.breathe(gammaCorrect(color), riseMs, fallMs);
+        else
+            showColor(color);
+    }
+
+    // Play any keyframe effect, overriding the current mode's output
+    void play(const Effect &fx, uint16_t phaseMs = 0)
+    {
+        effect.play(fx, millis(), phaseMs);
+    }
+
     void allOff()
     {
+        effect.stop();
         allLEDsOff();
     }
 
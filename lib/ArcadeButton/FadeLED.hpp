@@ -0,0 +1,178 @@
+#pragma once
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include "LedcAllocator.hpp"
+#include "Color.hpp"
+
+constexpr uint32_t LED_PWM_FREQ = 4000;         // Same as Solenoid, so timers can be shared
+constexpr uint8_t LED_PWM_BITS = 12;            // 0..LEVEL_MAX
+// RGB lamps that fit on LEDC next to the solenoid's channel (3 channels
+// each, no shaker); see LedcAllocator for the full budget
+constexpr uint8_t LED_PWM_RGB_MAX = (LedcAllocator::CHANNELS - 1) / 3;
+
+/******************************************************************************/
+// Single LED channel on the LEDC peripheral with hardware fades. Fades run
+// entirely in the peripheral; the fade-end interrupt only raises a flag, and
+// update() starts the next leg of a breathe cycle when it sees it.
+class FadeLED {
+private:
+  int pin;
+  int8_t chan;
+  uint16_t level;
+  uint16_t low, high;
+  uint16_t riseTime, fallTime;
+  bool breathing;
+  bool rising;
+  volatile bool fadeDone;
+
+  ledc_mode_t mode() const {
+#ifdef SOC_LEDC_SUPPORT_HS_MODE
+    return chan < 8 ? LEDC_HIGH_SPEED_MODE : LEDC_LOW_SPEED_MODE;
+#else
+    return LEDC_LOW_SPEED_MODE;
+#endif
+  }
+
+  ledc_channel_t channel() const { return static_cast<ledc_channel_t>(chan % 8); }
+
+  static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t *param, void *arg) {
+    if (param->event == LEDC_FADE_END_EVT) {
+      static_cast<FadeLED *>(arg)->fadeDone = true;
+    }
+    return false;
+  }
+
+  void startFade(uint16_t target, uint16_t ms) {
+    fadeDone = false;
+    level = target;
+    ledc_set_fade_with_time(mode(), channel(), target, ms);
+    ledc_fade_start(mode(), channel(), LEDC_FADE_NO_WAIT);
+  }
+
+public:
+  FadeLED(int ledPin)
+    : pin(ledPin), chan(-1), level(0), low(0), high(LEVEL_MAX),
+      riseTime(0), fallTime(0), breathing(false), rising(false), fadeDone(true) {}
+
+  // Claim a channel and attach the pin. false when LEDC is exhausted,
+  // in which case the caller should fall back to plain GPIO.
+  bool begin() {
+    if (chan >= 0) return true;
+    chan = LedcAllocator::claim(LED_PWM_FREQ, LED_PWM_BITS);
+    if (chan < 0) return false;
+    ledcSetup(chan, LED_PWM_FREQ, LED_PWM_BITS);
+    ledcAttachPin(pin, chan);
+    ledcWrite(chan, 0);
+    ledc_fade_func_install(0);                  // Returns an error once installed; harmless
+    ledc_cbs_t callbacks = {.fade_cb = onFadeEnd};
+    ledc_cb_register(mode(), channel(), &callbacks, this);
+    return true;
+  }
+
+  void end() {
+    if (chan < 0) return;
+    ledcWrite(chan, 0);
+    ledcDetachPin(pin);
+    LedcAllocator::release(chan);
+    chan = -1;
+  }
+
+  // Immediate level, cancelling any fade. A running hardware fade would
+  // otherwise go on stepping the duty and end on its own target.
+  void set(uint16_t value) {
+    if (chan < 0) return;
+    breathing = false;
+    ledc_fade_stop(mode(), channel());
+    fadeDone = true;
+    level = min<uint16_t>(value, LEVEL_MAX);
+    ledc_set_duty(mode(), channel(), level);
+    ledc_update_duty(mode(), channel());
+  }
+
+  void on() { set(LEVEL_MAX); }
+  void off() { set(0); }
+
+  // One hardware fade from the current level
+  void fadeTo(uint16_t value, uint16_t ms) {
+    if (chan < 0) return;
+    breathing = false;
+    startFade(min<uint16_t>(value, LEVEL_MAX), ms);
+  }
+
+  // Endless low/high ramps; the CPU is only involved at the endpoints
+  void breathe(uint16_t lo, uint16_t hi, uint16_t riseMs, uint16_t fallMs) {
+    if (chan < 0) return;
+    low = min<uint16_t>(lo, LEVEL_MAX);
+    high = min<uint16_t>(hi, LEVEL_MAX);
+    riseTime = riseMs;
+    fallTime = fallMs;
+    set(low);
+    if (low == high) return;                    // Nothing to fade; no end event would come
+    breathing = true;
+    rising = true;
+    startFade(high, riseTime);
+  }
+
+  // Update method - call this in loop(); cheap unless a fade has ended
+  void update() {
+    if (!breathing || !fadeDone) return;
+    rising = !rising;
+    startFade(rising ? high : low, rising ? riseTime : fallTime);
+  }
+
+  uint16_t getLevel() const { return level; }
+  bool attached() const { return chan >= 0; }
+  bool fading() const { return !fadeDone; }
+  int8_t getChannel() const { return chan; }
+};
+/******************************************************************************/
+// Three FadeLEDs driven together as one RGB button lamp
+class RGBFadeLED {
+private:
+  FadeLED red, green, blue;
+
+public:
+  RGBFadeLED(int redPin, int greenPin, int bluePin)
+    : red(redPin), green(greenPin), blue(bluePin) {}
+
+  // All three channels or none, so a lamp never ends up half on LEDC
+  bool begin() {
+    if (red.begin() && green.begin() && blue.begin()) return true;
+    end();
+    return false;
+  }
+
+  void end() {
+    red.end();
+    green.end();
+    blue.end();
+  }
+
+  void write(const RGB12 &c) {
+    red.set(c.r);
+    green.set(c.g);
+    blue.set(c.b);
+  }
+
+  void fadeTo(const RGB12 &c, uint16_t ms) {
+    red.fadeTo(c.r, ms);
+    green.fadeTo(c.g, ms);
+    blue.fadeTo(c.b, ms);
+  }
+
+  void breathe(const RGB12 &c, uint16_t riseMs, uint16_t fallMs) {
+    red.breathe(0, c.r, riseMs, fallMs);
+    green.breathe(0, c.g, riseMs, fallMs);
+    blue.breathe(0, c.b, riseMs, fallMs);
+  }
+
+  void update() {
+    red.update();
+    green.update();
+    blue.update();
+  }
+
+  bool attached() const { return red.attached(); }
+  RGB12 getLevel() const { return RGB12{red.getLevel(), green.getLevel(), blue.getLevel()}; }
+};
+/******************************************************************************/
@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <functional>
+#include <atomic>
 
 /******************************************************************************/
 class CallbackSwitch {
@@ -11,6 +12,13 @@ private:
   bool previousState;
   unsigned long lastDebounceTime;
   unsigned long debounceDelay;
+
+  // Debounced edges, counted by debounce() and turned into callbacks by
+  // dispatch(), which may run on another task
+  std::atomic<uint32_t> edges{0};
+  uint32_t dispatched = 0;
+  bool dispatchedLow = false;
+  bool external = false;
   
   // Change to std::function to support lambdas with captures
   std::function<void()> pressCallback;
@@ -33,8 +41,17 @@ public:
     releaseCallback = callback;
   }
 
-  // Update switch state and trigger callbacks
+  // Update switch state and trigger callbacks. A switch debounced
+  // elsewhere (ButtonManager) only has its callbacks run here.
   void update() {
+    if (!external) {
+      debounce();
+    }
+    dispatch();
+  }
+
+  // Debounce only, recording edges for dispatch()
+  void debounce() {
     bool reading = digitalRead(pin);
     
     if (reading != lastRawState) {
@@ -46,19 +63,30 @@ public:
       
       if (reading != currentState) {
         currentState = reading;
-        
-        // Trigger callbacks
-        if (currentState == LOW && pressCallback) {
-          pressCallback();
-        } else if (currentState == HIGH && releaseCallback) {
-          releaseCallback();
-        }
+        edges.fetch_add(1, std::memory_order_release);
       }
     }
     
     lastRawState = reading;
   }
 
+  // Trigger callbacks for the edges debounced since the last call, in order
+  void dispatch() {
+    const uint32_t n = edges.load(std::memory_order_acquire);
+    while (dispatched != n) {
+      dispatched++;
+      dispatchedLow = !dispatchedLow;
+      if (dispatchedLow && pressCallback) {
+        pressCallback();
+      } else if (!dispatchedLow && releaseCallback) {
+        releaseCallback();
+      }
+    }
+  }
+
+  // Another task calls debounce(); update() then only dispatches
+  void debounceElsewhere(bool on = true) { external = on; }
+
   // Basic state checks
   bool isPressed() { return currentState == LOW; }
   bool isReleased() { return currentState == HIGH; }
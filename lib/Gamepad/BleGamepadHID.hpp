@@ -0,0 +1,151 @@
+#ifndef BLE_GAMEPAD_HID_HPP
+#define BLE_GAMEPAD_HID_HPP
+
+#pragma once
+#ifdef BLE_GAMEPAD
+
+#include <Arduino.h>
+#include <BleGamepad.h>
+#include <NimBLEDevice.h>
+#include "Gamepad.hpp"
+
+// Connection parameters asked of the central, in BLE units
+constexpr uint16_t BLE_CONN_MIN = 6;            // 7.5 ms (x1.25 ms), the spec minimum
+constexpr uint16_t BLE_CONN_MAX = 12;           // 15 ms, for hosts that refuse 7.5
+constexpr uint16_t BLE_CONN_LATENCY = 0;        // Peripheral answers every event
+constexpr uint16_t BLE_CONN_TIMEOUT = 400;      // 4 s supervision timeout (x10 ms)
+
+/****************************************************************************/
+// BLE HID gamepad mode, built by the `ble` env (-DBLE_GAMEPAD). A task wakes once per
+// connection interval, takes the newest Gamepad state and sends it as one
+// notification carrying every button and axis. States published since the
+// last notification are superseded, never queued, so a congested radio
+// costs resolution in time but not latency.
+class BleGamepadHID {
+
+private:
+    BleGamepad _pad;
+    Gamepad& _source;
+    ReportFilter _filter;
+    Coalescer _coalescer;
+    TaskHandle_t _task = nullptr;
+
+    bool _paramsRequested = false;
+    uint16_t _interval = 0;                     // Negotiated, x1.25 ms
+
+    uint32_t _sent = 0, _skipped = 0;
+    uint32_t _latMin = UINT32_MAX, _latMax = 0;
+    uint64_t _latSum = 0;
+    uint32_t _statsTic = 0, _statsSent = 0;
+
+    static void run(void* arg) {
+        BleGamepadHID& self = *static_cast<BleGamepadHID*>(arg);
+        TickType_t wake = xTaskGetTickCount();
+        for (;;) {
+            // Track the negotiated interval; 7.5 ms rounds down to 7 ticks
+            const uint32_t us = self._interval ? self._interval * 1250u : BLE_CONN_MIN * 1250u;
+            vTaskDelayUntil(&wake, max<TickType_t>(pdMS_TO_TICKS(us / 1000), 1));
+            self.pump();
+        }
+    }
+
+    void requestConnParams() {
+        NimBLEServer* server = NimBLEDevice::getServer();
+        if (!server || server->getConnectedCount() == 0) { return; }
+        const NimBLEConnInfo peer = server->getPeerInfo(0);
+        server->updateConnParams(peer.getConnHandle(), BLE_CONN_MIN, BLE_CONN_MAX, BLE_CONN_LATENCY, BLE_CONN_TIMEOUT);
+        _paramsRequested = true;
+    }
+
+    void readInterval() {
+        NimBLEServer* server = NimBLEDevice::getServer();
+        if (server && server->getConnectedCount()) { _interval = server->getPeerInfo(0).getConnInterval(); }
+    }
+
+public:
+
+    BleGamepadHID(Gamepad& source, const char* name = "Pinball Controller", uint16_t threshold = 64)
+        : _pad(name), _source(source), _filter(threshold) {}
+
+    ReportFilter& filter() { return _filter; }
+
+    bool begin(UBaseType_t priority = 5, uint8_t core = OUTPUT_CORE) {
+        BleGamepadConfiguration config;
+        config.setAutoReport(false);                // One notification per pump
+        config.setControllerType(CONTROLLER_TYPE_GAMEPAD);
+        config.setButtonCount(32);
+        config.setHatSwitchCount(0);
+        config.setWhichAxes(true, true, true, false, false, false, false, false);
+        config.setAxesMin(-AXIS_MAX);
+        config.setAxesMax(AXIS_MAX);
+        _pad.begin(&config);
+
+        if (_task) { return true; }
+        if (xTaskCreatePinnedToCore(&BleGamepadHID::run, "ble_pump", 4096, this, priority, &_task, core) != pdPASS) {
+            _task = nullptr;
+            return ErrorMsg("BleGamepadHID task create failed!");
+        }
+        return true;
+    }
+
+    bool isConnected() { return _pad.isConnected(); }
+
+    // One connection event's worth of work. Called by the task.
+    void pump() {
+        if (!_pad.isConnected()) {
+            _paramsRequested = false;
+            _interval = 0;
+            _filter.reset();
+            _coalescer.reset();
+            return;
+        }
+        if (!_paramsRequested) { requestConnParams(); }
+        readInterval();
+
+        const uint32_t version = _source.version();
+        const GamepadState state = _source.getState();
+        if (!_filter.changed(state)) {
+            _coalescer.skip(version);
+            _skipped++;
+            return;
+        }
+        _coalescer.take(version);
+
+        for (uint8_t b = 0; b < 32; b++) {
+            if ((state.buttons >> b) & 1) { _pad.press(b + 1); } else { _pad.release(b + 1); }
+        }
+        _pad.setAxes(state.axis[AXIS_X], state.axis[AXIS_Y], state.axis[AXIS_Z], 0, 0, 0, 0, 0);
+        _pad.sendReport();
+
+        _filter.sent(state);
+        const uint32_t latency = micros() - state.sampled;
+        _latMin = min(_latMin, latency);
+        _latMax = max(_latMax, latency);
+        _latSum += latency;
+        _sent++;
+    }
+
+    // Event-to-notification latency: input sampled -> notification queued
+    uint32_t latencyMin() const { return _sent ? _latMin : 0; }
+    uint32_t latencyMax() const { return _latMax; }
+    uint32_t latencyMean() const { return _sent ? static_cast<uint32_t>(_latSum / _sent) : 0; }
+    uint32_t sent() const { return _sent; }
+    uint32_t superseded() const { return _coalescer.superseded(); }
+    float intervalMs() const { return _interval * 1.25f; }
+
+    // Prints notifications/s since the last call
+    void printStats(Stream& stream = Serial) {
+        const uint32_t now = millis();
+        const uint32_t dt = now - _statsTic;
+        stream.printf("BleGamepad: %s, interval %.2f ms, %lu notify/s, %lu sent, %lu unchanged, %lu superseded, latency min %lu / mean %lu / max %lu us\n",
+            _pad.isConnected() ? "connected" : "advertising", intervalMs(),
+            dt ? (_sent - _statsSent) * 1000 / dt : 0, _sent, _skipped, superseded(),
+            latencyMin(), latencyMean(), latencyMax());
+        _statsTic = now;
+        _statsSent = _sent;
+    }
+};
+/****************************************************************************/
+
+#endif // BLE_GAMEPAD
+#endif
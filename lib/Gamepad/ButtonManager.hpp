@@ -0,0 +1,52 @@
+#ifndef BUTTON_MANAGER_HPP
+#define BUTTON_MANAGER_HPP
+
+#pragma once
+#include "Switch.hpp"
+
+/****************************************************************************/
+// Maps debounced switches onto gamepad button bits. Every switch is
+// debounced here, by update() on the acquisition task. Switches that belong
+// to an ArcadeButton keep their callbacks on its update() (the LEDs' core):
+// pass dispatch = false for those. The rest have theirs run here.
+template<uint8_t N = 32>
+class ButtonManager {
+    static_assert(N <= 32, "Gamepad reports carry 32 buttons");
+
+private:
+    CallbackSwitch* _switches[N] = {};
+    uint8_t _bits[N] = {};
+    bool _dispatch[N] = {};
+    uint8_t _count = 0;
+    uint32_t _state = 0;
+
+public:
+
+    // Returns false if full or the bit is out of range
+    bool add(CallbackSwitch& sw, uint8_t bit, bool dispatch = true) {
+        if (_count >= N || bit >= 32) { return false; }
+        sw.debounceElsewhere();
+        _switches[_count] = &sw;
+        _bits[_count] = bit;
+        _dispatch[_count] = dispatch;
+        _count++;
+        return true;
+    }
+
+    uint32_t update() {
+        uint32_t state = 0;
+        for (uint8_t k = 0; k < _count; k++) {
+            _switches[k]->debounce();
+            if (_dispatch[k]) { _switches[k]->dispatch(); }
+            if (_switches[k]->isPressed()) { state |= 1u << _bits[k]; }
+        }
+        _state = state;
+        return state;
+    }
+
+    uint32_t getState() const { return _state; }
+    uint8_t size() const { return _count; }
+};
+/****************************************************************************/
+
+#endif
@@ -1,47 +1,297 @@
-#ifdef USB_GAMEPAD
-    #include <USBHIDGamepad.h>
-    USBHIDGamepad usbGamepad;
-#endif
+#ifndef GAMEPAD_HPP
+#define GAMEPAD_HPP
 
-#ifdef BLE_GAMEPAD  
-    #include <BleGamepad.h>
-    BleGamepad bleGamepad("Pinball Controller");
-#endif
+#pragma once
+#include <Arduino.h>
+#include "GamepadState.hpp"
+#include "GamepadHID.hpp"
+#include "KeyboardHID.hpp"
+#include "ButtonManager.hpp"
+#include "Joystick.hpp"
+#include "RangeLaser.hpp"
+#include "Seqlock.hpp"
+
+constexpr uint32_t HID_REPORT_US = 1000;        // Full-speed interrupt endpoint, bInterval 1
 
+/****************************************************************************/
 class Gamepad {
-protected:
-    Accelerometer accel;
-    ButtonManager buttons;
-    Joystick joystick;
-    uint32_t lastSampleTime;
-    
 public:
-    virtual void update() = 0;
-    virtual GamepadState getState() = 0;
+    virtual ~Gamepad() = default;
+    virtual void update() = 0;                  // loop() or AcquisitionTask: sample whatever is due
+    virtual GamepadState getState() = 0;        // Newest state, safe from any task
+    virtual uint32_t version() const { return 0; }  // Bumped by every new state, 0 if untracked
 };
 
+/****************************************************************************/
+// Runs a Gamepad's update() at a fixed period from a task pinned to the
+// acquisition core, so sensor I/O never waits behind USB or LED work.
+class AcquisitionTask {
+
+private:
+    Gamepad& _pad;
+    uint32_t _periodMs;
+    TaskHandle_t _task = nullptr;
+    uint32_t _cycles = 0, _busyMax = 0;
+    uint64_t _busySum = 0;
+
+    static void run(void* arg) {
+        AcquisitionTask& self = *static_cast<AcquisitionTask*>(arg);
+        TickType_t wake = xTaskGetTickCount();
+        const TickType_t period = max<TickType_t>(pdMS_TO_TICKS(self._periodMs), 1);
+        for (;;) {
+            vTaskDelayUntil(&wake, period);
+            const uint32_t tic = micros();
+            self._pad.update();
+            const uint32_t busy = micros() - tic;
+            self._busyMax = max(self._busyMax, busy);
+            self._busySum += busy;
+            self._cycles++;
+        }
+    }
+
+public:
+
+    AcquisitionTask(Gamepad& pad, uint32_t periodMs = 1) : _pad(pad), _periodMs(periodMs) {}
+
+    bool begin(UBaseType_t priority = 6, uint8_t core = ACQUIRE_CORE) {
+        if (_task) { return true; }
+        if (xTaskCreatePinnedToCore(&AcquisitionTask::run, "acquire", 4096, this, priority, &_task, core) != pdPASS) {
+            _task = nullptr;
+            return ErrorMsg("AcquisitionTask create failed!");
+        }
+        return true;
+    }
+
+    void end() {
+        if (_task) { vTaskDelete(_task); _task = nullptr; }
+    }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("AcquisitionTask: %lu cycles, busy mean %lu / max %lu us per cycle\n",
+            _cycles, _cycles ? static_cast<uint32_t>(_busySum / _cycles) : 0, _busyMax);
+    }
+};
+
+/****************************************************************************/
+// Buttons every update(), tilt joystick at SMPL_FREQ (with the cabinet
+// nudge, when the Joystick has a GravityTracker), plunger whenever the
+// VL6180X has a new continuous-mode range. Each source stamps the state
+// with the time it was sampled (the tilt with the accelerometer's own
+// sample time, which may be a FIFO period old; buttons and plunger with
+// when they were read), and the state keeps the newest. The report pump
+// turns that into latency.
+// The state is published through a seqlock: update() (acquisition core)
+// never waits for getState() readers (output core), nor they for it.
 class MotionGamepad : public Gamepad {
+
 private:
-    struct Sample {
-        int16_t x, y, z;
-        uint32_t timestamp;
-    };
-    
-    CircularBuffer<Sample, 64> sampleBuffer;
-    
+    Joystick& joystick;
+    ButtonManager<>& buttons;
+    RangeLaser* plunger;
+
+    float _restMm, _pulledMm;                   // Plunger travel mapped onto Z
+    uint32_t _lastTilt = 0;
+    uint32_t _lastPlunge = 0;
+    uint32_t _plungeInterval = 0;
+    TaskHandle_t _edgeTask = nullptr;           // Woken on every button edge
+
+    GamepadState _state;                        // Writer's copy
+    Seqlock<GamepadState> _published;
+
+    static int16_t toAxis(float v) {
+        return static_cast<int16_t>(lroundf(constrain(v, -1.f, 1.f) * AXIS_MAX));
+    }
+
 public:
+
+    MotionGamepad(Joystick& stick, ButtonManager<>& manager, RangeLaser* laser = nullptr,
+                  float restMm = 10.f, float pulledMm = 60.f)
+        : joystick(stick), buttons(manager), plunger(laser), _restMm(restMm), _pulledMm(pulledMm) {}
+
+    // Wakes `task` (e.g. ReportPump::task()) as soon as a button edge is
+    // published instead of leaving it to the task's next slot
+    void notifyOnEdge(TaskHandle_t task) { _edgeTask = task; }
+
+    // Puts the plunger in continuous mode at intervalMs
+    bool begin(uint16_t plungerIntervalMs = 10) {
+        if (!joystick.begin()) { return false; }
+        if (plunger) {
+            if (!plunger->begin()) { return ErrorMsg("Plunger not found: " + plunger->getLastError()); }
+            plunger->startContinuousMode(plungerIntervalMs);
+            _plungeInterval = plungerIntervalMs;
+        }
+        return true;
+    }
+
     void update() override {
-        // Strategy depends on your timing approach
-        accel.update();
-        buttons.update();
-        joystick.update();
-    }
-    
-    GamepadState getState() override {
-        GamepadState state;
-        state.acceleration = accel.getLatest();
-        state.buttons = buttons.getState();
-        state.timestamp = micros();
-        return state;
-    }
-};
\ No newline at end of file
+        const uint32_t now = millis();
+        const uint32_t polled = micros();
+        const uint32_t pressed = buttons.update();
+        GamepadState next = _state;
+        bool changed = false;
+        // Newest sample time wins, so the stamp never runs backwards
+        // (PinballEncoder counts micros() wraps off it)
+        uint32_t sampled = next.sampled;
+        auto stamp = [&](uint32_t t) {
+            const uint32_t at = micros();
+            if (at - t < at - sampled) { sampled = t; }
+            changed = true;
+        };
+        if (pressed != next.buttons) { stamp(polled); }
+        next.buttons = pressed;
+
+        if (now - _lastTilt >= getInterval()) {
+            _lastTilt = now;
+            const Vec2f tilt = joystick.read();
+            next.axis[AXIS_X] = toAxis(tilt[0]);
+            next.axis[AXIS_Y] = toAxis(tilt[1]);
+            const Vec3f nudge = joystick.nudge();
+            next.nudge[0] = toNudge(nudge[0]);
+            next.nudge[1] = toNudge(nudge[1]);
+            stamp(joystick.sampledMicros());
+        }
+        if (plunger && now - _lastPlunge >= _plungeInterval) {
+            _lastPlunge = now;
+            const float mm = plunger->readDistanceContinuous();
+            if (mm >= 0.f) {
+                next.axis[AXIS_Z] = toAxis((mm - _restMm) / (_pulledMm - _restMm));
+                stamp(micros());
+            }
+        }
+        if (!changed) { return; }
+
+        const bool edge = next.buttons != _state.buttons;
+        next.sampled = sampled;
+        _state = next;
+        _published.write(next);
+        if (edge && _edgeTask) { xTaskNotifyGive(_edgeTask); }
+    }
+
+    GamepadState getState() override { return _published.read(); }
+
+    uint32_t version() const override { return _published.version() >> 1; }
+    uint32_t readRetries() const { return _published.retries(); }
+};
+
+/****************************************************************************/
+// Sends the newest Gamepad state at a fixed HID_REPORT_US cadence from its
+// own task. States that arrive between two slots coalesce into one report,
+// and a slot is skipped when ReportFilter sees nothing worth sending. Since
+// a send returns once the host has collected the report, the slots settle
+// onto the host's polling frames.
+//
+// With a KeyboardHID attached, a button edge is sent as a key report first
+// in the slot that sees it, ahead of the gamepad report, and the keyed
+// buttons are left out of the gamepad report. A gamepad that wakes the
+// task on edges (MotionGamepad::notifyOnEdge) gets the key report queued
+// for the very next USB frame.
+class ReportPump {
+
+private:
+    Gamepad& _source;
+    GamepadHID& _hid;
+    KeyboardHID* _keyboard = nullptr;
+    ReportFilter _filter;
+    TaskHandle_t _task = nullptr;
+
+    uint32_t _slots = 0, _sent = 0, _skipped = 0, _failed = 0;
+    uint32_t _latMin = UINT32_MAX, _latMax = 0;
+    uint64_t _latSum = 0;
+
+    uint32_t _keys = 0;                         // Buttons in the last key report
+    bool _keysPrimed = false;
+    uint32_t _keySent = 0, _keyLatMax = 0;
+
+    static void run(void* arg) {
+        ReportPump& self = *static_cast<ReportPump*>(arg);
+        const TickType_t period = max<TickType_t>(pdMS_TO_TICKS(HID_REPORT_US / 1000), 1);
+        for (;;) {
+            ulTaskNotifyTake(pdTRUE, period);   // A slot per period, or at once on an edge
+            self.pump();
+        }
+    }
+
+    void pumpKeys(const GamepadState& state) {
+        if (_keysPrimed && state.buttons == _keys) { return; }
+        if (!_keyboard->send(state.buttons)) { _failed++; return; }
+        _keys = state.buttons;
+        _keysPrimed = true;
+        const uint32_t latency = micros() - state.sampled;
+        _keyLatMax = max(_keyLatMax, latency);
+        _keySent++;
+    }
+
+public:
+
+    ReportPump(Gamepad& source, GamepadHID& hid, uint16_t threshold = 64)
+        : _source(source), _hid(hid), _filter(threshold) {}
+
+    ReportFilter& filter() { return _filter; }
+
+    // Sends the buttons as keys too; pass nullptr to detach
+    void attachKeyboard(KeyboardHID* keyboard) {
+        _keyboard = keyboard;
+        _keysPrimed = false;
+    }
+
+    // For MotionGamepad::notifyOnEdge(); nullptr before begin()
+    TaskHandle_t task() const { return _task; }
+
+    bool begin(UBaseType_t priority = 5, uint8_t core = OUTPUT_CORE) {
+        if (_task) { return true; }
+        if (xTaskCreatePinnedToCore(&ReportPump::run, "hid_pump", 4096, this, priority, &_task, core) != pdPASS) {
+            _task = nullptr;
+            return ErrorMsg("ReportPump task create failed!");
+        }
+        return true;
+    }
+
+    void end() {
+        if (_task) { vTaskDelete(_task); _task = nullptr; }
+    }
+
+    // One report slot. Called by the task; public for driving by hand.
+    void pump() {
+        _slots++;
+        GamepadState state = _source.getState();
+        if (_keyboard) {
+            pumpKeys(state);
+            state.buttons &= ~_keyboard->mapped();
+        }
+        if (!_filter.changed(state)) { _skipped++; return; }
+        if (!_hid.ready() || !_hid.send(state)) { _failed++; return; }
+        _filter.sent(state);
+        const uint32_t latency = micros() - state.sampled;
+        _latMin = min(_latMin, latency);
+        _latMax = max(_latMax, latency);
+        _latSum += latency;
+        _sent++;
+    }
+
+    // Sample-to-report latency: input sampled -> host collected the report
+    uint32_t latencyMin() const { return _sent ? _latMin : 0; }
+    uint32_t latencyMax() const { return _latMax; }
+    uint32_t latencyMean() const { return _sent ? static_cast<uint32_t>(_latSum / _sent) : 0; }
+    uint32_t sent() const { return _sent; }
+    uint32_t skipped() const { return _skipped; }
+    uint32_t failed() const { return _failed; }
+    uint32_t keySent() const { return _keySent; }
+    uint32_t keyLatencyMax() const { return _keyLatMax; }
+
+    void resetStats() {
+        _slots = _sent = _skipped = _failed = 0;
+        _latMin = UINT32_MAX;
+        _latMax = 0;
+        _latSum = 0;
+        _keySent = _keyLatMax = 0;
+    }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("ReportPump: %lu slots, %lu sent, %lu unchanged, %lu failed, latency min %lu / mean %lu / max %lu us\n",
+            _slots, _sent, _skipped, _failed, latencyMin(), latencyMean(), latencyMax());
+        if (_keyboard) { stream.printf("ReportPump: %lu key reports, edge latency max %lu us\n", _keySent, _keyLatMax); }
+    }
+};
+/****************************************************************************/
+
+#endif
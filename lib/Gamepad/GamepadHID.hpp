@@ -0,0 +1,86 @@
+#ifndef GAMEPAD_HID_HPP
+#define GAMEPAD_HID_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <USB.h>
+#include <USBHID.h>
+#include "GamepadState.hpp"
+#include "HidDescriptor.hpp"
+
+constexpr uint8_t GAMEPAD_REPORT_ID = 0x01;
+
+/****************************************************************************/
+// USB HID gamepad: 32 buttons and three 16-bit axes. The stock
+// USBHIDGamepad only has 8-bit axes, too coarse for tilt and plunger.
+class GamepadHID : public USBHIDDevice {
+
+private:
+    USBHID _hid;
+
+    struct __attribute__((packed)) Report {
+        uint32_t buttons;
+        int16_t axis[GAMEPAD_AXES];
+    };
+
+    static constexpr uint8_t DESCRIPTOR[] = {
+        0x05, 0x01,                             // Usage Page (Generic Desktop)
+        0x09, 0x05,                             // Usage (Gamepad)
+        0xA1, 0x01,                             // Collection (Application)
+        0x85, GAMEPAD_REPORT_ID,                //   Report ID
+        0x05, 0x09,                             //   Usage Page (Button)
+        0x19, 0x01,                             //   Usage Minimum (1)
+        0x29, 0x20,                             //   Usage Maximum (32)
+        0x15, 0x00,                             //   Logical Minimum (0)
+        0x25, 0x01,                             //   Logical Maximum (1)
+        0x75, 0x01,                             //   Report Size (1)
+        0x95, 0x20,                             //   Report Count (32)
+        0x81, 0x02,                             //   Input (Data, Var, Abs)
+        0x05, 0x01,                             //   Usage Page (Generic Desktop)
+        0x09, 0x30,                             //   Usage (X)
+        0x09, 0x31,                             //   Usage (Y)
+        0x09, 0x32,                             //   Usage (Z)
+        0x16, 0x01, 0x80,                       //   Logical Minimum (-32767)
+        0x26, 0xFF, 0x7F,                       //   Logical Maximum (32767)
+        0x75, 0x10,                             //   Report Size (16)
+        0x95, GAMEPAD_AXES,                     //   Report Count
+        0x81, 0x02,                             //   Input (Data, Var, Abs)
+        0xC0                                    // End Collection
+    };
+
+public:
+
+    GamepadHID() {
+        static_assert(hidReportMatches(DESCRIPTOR, sizeof(DESCRIPTOR), GAMEPAD_REPORT_ID, sizeof(Report)),
+                      "Gamepad descriptor does not match Report");
+        static bool initialized = false;
+        if (!initialized) {
+            initialized = true;
+            _hid.addDevice(this, sizeof(DESCRIPTOR));
+        }
+    }
+
+    void begin() {
+        _hid.begin();
+        USB.begin();
+    }
+
+    bool ready() { return _hid.ready(); }
+
+    // Blocks until the host has collected the report (at most timeoutMs),
+    // so back-to-back calls fall into step with the host's polling
+    bool send(const GamepadState& state, uint32_t timeoutMs = 2) {
+        Report report;
+        report.buttons = state.buttons;
+        for (uint8_t a = 0; a < GAMEPAD_AXES; a++) { report.axis[a] = state.axis[a]; }
+        return _hid.SendReport(GAMEPAD_REPORT_ID, &report, sizeof(report), timeoutMs);
+    }
+
+    uint16_t _onGetDescriptor(uint8_t* buffer) override {
+        memcpy(buffer, DESCRIPTOR, sizeof(DESCRIPTOR));
+        return sizeof(DESCRIPTOR);
+    }
+};
+/****************************************************************************/
+
+#endif
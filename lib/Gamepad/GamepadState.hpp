@@ -0,0 +1,126 @@
+#ifndef GAMEPAD_STATE_HPP
+#define GAMEPAD_STATE_HPP
+
+#pragma once
+#include <Arduino.h>
+
+/****************************************************************************/
+enum GamepadAxis : uint8_t {
+    AXIS_X,                     // Tilt joystick, left/right
+    AXIS_Y,                     // Tilt joystick, forward/back
+    AXIS_Z,                     // Plunger, 0 at rest
+    GAMEPAD_AXES
+};
+
+constexpr int16_t AXIS_MAX = 32767;
+
+// Cabinet acceleration in GamepadState::nudge, as the Open Pinball Device
+// report carries it: +-AXIS_MAX is +-2 g
+constexpr float NUDGE_FULL_MS2 = 2.f * 9.80665f;
+
+inline int16_t toNudge(float ms2) {
+    const float v = ms2 * (AXIS_MAX / NUDGE_FULL_MS2);
+    return static_cast<int16_t>(lroundf(constrain(v, -AXIS_MAX, AXIS_MAX)));
+}
+
+// Button bits for the default cabinet layout; add each ArcadeButton's
+// switch to the ButtonManager at its bit (dispatch = false)
+enum PinballButton : uint8_t {
+    BTN_LEFT_FLIPPER,
+    BTN_RIGHT_FLIPPER,
+    BTN_LEFT_MAGNA,
+    BTN_RIGHT_MAGNA,
+    BTN_LAUNCH,
+    BTN_START,
+    BTN_COIN,
+    BTN_EXIT,
+    BTN_FIRE,                                   // Lockbar
+    BTN_TILT,
+    PINBALL_BUTTONS
+};
+
+// One snapshot of every input, as it goes into a HID report. Fields are
+// ordered widest first so the 18 bytes of payload sit back to back with
+// no interior padding; StateCodec serialises them straight from memory.
+struct GamepadState {
+    uint32_t buttons = 0;               // Bit k = button k+1
+    uint32_t sampled = 0;               // micros() of the newest input in it
+    int16_t axis[GAMEPAD_AXES] = {};
+    int16_t nudge[2] = {};              // Cabinet X/Y acceleration, toNudge() units
+};
+
+/****************************************************************************/
+// Decides whether a state is worth a report: any button edge, or an axis
+// that moved more than its threshold since the last report actually sent.
+// Comparing against the last sent state (not the last seen one) means slow
+// drifts still get reported once they add up.
+class ReportFilter {
+
+private:
+    GamepadState _sent;
+    uint16_t _threshold[GAMEPAD_AXES];
+    bool _primed = false;
+
+public:
+
+    ReportFilter(uint16_t threshold = 64) {
+        for (uint8_t a = 0; a < GAMEPAD_AXES; a++) { _threshold[a] = threshold; }
+    }
+
+    void setThreshold(GamepadAxis axis, uint16_t threshold) {
+        if (axis < GAMEPAD_AXES) { _threshold[axis] = threshold; }
+    }
+
+    bool changed(const GamepadState& next) const {
+        if (!_primed || next.buttons != _sent.buttons) { return true; }
+        for (uint8_t a = 0; a < GAMEPAD_AXES; a++) {
+            if (abs(static_cast<int32_t>(next.axis[a]) - _sent.axis[a]) > _threshold[a]) { return true; }
+        }
+        return false;
+    }
+
+    // Call once the report for `state` is on its way
+    void sent(const GamepadState& state) {
+        _sent = state;
+        _primed = true;
+    }
+
+    void reset() { _primed = false; }
+    const GamepadState& last() const { return _sent; }
+};
+/****************************************************************************/
+// Bookkeeping for a link slower than the producer (BLE): each send takes
+// only the newest state, and every state published since the previous
+// send that never went out is counted as superseded rather than queued.
+class Coalescer {
+
+private:
+    uint32_t _lastVersion = 0;
+    uint32_t _superseded = 0;
+    bool _primed = false;
+
+public:
+
+    // Version of the state being sent; returns how many were dropped for it
+    uint32_t take(uint32_t version) {
+        uint32_t dropped = 0;
+        if (_primed && version - _lastVersion > 1) { dropped = version - _lastVersion - 1; }
+        _superseded += dropped;
+        _lastVersion = version;
+        _primed = true;
+        return dropped;
+    }
+
+    // Nothing was sent for a new version (e.g. below the change threshold);
+    // it is not superseded, just unneeded
+    void skip(uint32_t version) {
+        _lastVersion = version;
+        _primed = true;
+    }
+
+    void reset() { _primed = false; }
+    uint32_t superseded() const { return _superseded; }
+};
+/****************************************************************************/
+
+#endif
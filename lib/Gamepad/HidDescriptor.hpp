@@ -0,0 +1,60 @@
+#ifndef HID_DESCRIPTOR_HPP
+#define HID_DESCRIPTOR_HPP
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************/
+// Compile-time walk over a HID report descriptor's short items, enough to
+// catch the usual hand-editing slips: an item cut short, unbalanced
+// collections, or a report whose Input fields don't add up to the struct
+// sent for it.
+struct HidCheck {
+    bool parsed = true;                         // Every item complete
+    bool balanced = true;                       // Collections closed, never over-closed
+    uint32_t inputBits = 0;                     // Input bits for the report ID asked for
+};
+
+constexpr HidCheck checkHidDescriptor(const uint8_t* desc, size_t len, uint8_t reportId) {
+    HidCheck check;
+    int depth = 0;
+    uint32_t size = 0, count = 0;
+    uint8_t id = 0;
+    size_t i = 0;
+    while (i < len) {
+        const uint8_t prefix = desc[i];
+        if (prefix == 0xFE) {                   // Long item: size byte, tag byte, data
+            if (i + 2 >= len) { check.parsed = false; break; }
+            i += 3 + desc[i + 1];
+            continue;
+        }
+        const uint8_t n = (prefix & 0x03) == 3 ? 4 : prefix & 0x03;
+        if (i + n >= len) { check.parsed = false; break; }
+        uint32_t value = 0;
+        for (uint8_t b = 0; b < n; b++) { value |= static_cast<uint32_t>(desc[i + 1 + b]) << (8 * b); }
+        switch (prefix & 0xFC) {
+            case 0x74: size = value; break;                         // Report Size
+            case 0x94: count = value; break;                        // Report Count
+            case 0x84: id = static_cast<uint8_t>(value); break;     // Report ID
+            case 0x80: if (id == reportId) { check.inputBits += size * count; } break;
+            case 0xA0: depth++; break;                              // Collection
+            case 0xC0: if (--depth < 0) { check.balanced = false; } break;
+            default: break;
+        }
+        i += 1 + n;
+    }
+    if (i != len) { check.parsed = false; }
+    if (depth != 0) { check.balanced = false; }
+    return check;
+}
+
+// True if the descriptor is well formed and report `reportId` carries
+// exactly `bytes` bytes of Input
+constexpr bool hidReportMatches(const uint8_t* desc, size_t len, uint8_t reportId, size_t bytes) {
+    const HidCheck check = checkHidDescriptor(desc, len, reportId);
+    return check.parsed && check.balanced && check.inputBits == 8 * bytes;
+}
+/****************************************************************************/
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef KEYBOARD_HID_HPP
+#define KEYBOARD_HID_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <USB.h>
+#include <USBHID.h>
+#include "GamepadState.hpp"
+#include "HidDescriptor.hpp"
+
+constexpr uint8_t KEYBOARD_REPORT_ID = 0x02;
+constexpr uint8_t KEYBOARD_BUTTONS = 32;        // One key per ButtonManager bit
+constexpr uint8_t KEYBOARD_BITMAP = 16;         // Usages 0x00-0x7F, one bit each
+
+/****************************************************************************/
+// HID usage IDs (Keyboard/Keypad page) used by the pinball front ends.
+// Not the Arduino KEY_* codes, which are offset for the boot protocol.
+namespace HidKey {
+    constexpr uint8_t NONE = 0x00;
+    constexpr uint8_t A = 0x04;                 // A..Z follow in order
+    constexpr uint8_t Q = 0x14;
+    constexpr uint8_t T = 0x17;
+    constexpr uint8_t Z = 0x1D;
+    constexpr uint8_t N1 = 0x1E;                // 1..9, then 0
+    constexpr uint8_t N5 = 0x22;
+    constexpr uint8_t ENTER = 0x28;
+    constexpr uint8_t ESCAPE = 0x29;
+    constexpr uint8_t SPACE = 0x2C;
+    constexpr uint8_t SLASH = 0x38;
+    constexpr uint8_t F1 = 0x3A;                // F1..F12 follow in order
+    constexpr uint8_t LEFT_CTRL = 0xE0;         // Modifiers, 0xE0-0xE7
+    constexpr uint8_t LEFT_SHIFT = 0xE1;
+    constexpr uint8_t LEFT_ALT = 0xE2;
+    constexpr uint8_t RIGHT_CTRL = 0xE4;
+    constexpr uint8_t RIGHT_SHIFT = 0xE5;
+
+    constexpr bool isModifier(uint8_t key) { return key >= LEFT_CTRL && key <= 0xE7; }
+}
+
+// Button bit -> HID usage, NONE for unbound bits
+struct Keymap {
+    uint8_t key[KEYBOARD_BUTTONS] = {};
+
+    constexpr void bind(uint8_t bit, uint8_t usage) {
+        if (bit < KEYBOARD_BUTTONS) { key[bit] = usage; }
+    }
+
+    // Bits bound to any key
+    constexpr uint32_t mapped() const {
+        uint32_t mask = 0;
+        for (uint8_t b = 0; b < KEYBOARD_BUTTONS; b++) { mask |= static_cast<uint32_t>(key[b] != HidKey::NONE) << b; }
+        return mask;
+    }
+};
+
+// Visual Pinball X defaults
+constexpr Keymap makeVpxKeymap() {
+    Keymap map;
+    map.bind(BTN_LEFT_FLIPPER, HidKey::LEFT_SHIFT);
+    map.bind(BTN_RIGHT_FLIPPER, HidKey::RIGHT_SHIFT);
+    map.bind(BTN_LEFT_MAGNA, HidKey::LEFT_CTRL);
+    map.bind(BTN_RIGHT_MAGNA, HidKey::RIGHT_CTRL);
+    map.bind(BTN_LAUNCH, HidKey::ENTER);
+    map.bind(BTN_START, HidKey::N1);
+    map.bind(BTN_COIN, HidKey::N5);
+    map.bind(BTN_EXIT, HidKey::Q);
+    map.bind(BTN_FIRE, HidKey::LEFT_ALT);
+    map.bind(BTN_TILT, HidKey::T);
+    return map;
+}
+inline constexpr Keymap VPX_KEYMAP = makeVpxKeymap();
+
+/****************************************************************************/
+// N-key rollover report: the eight modifiers, then one bit per usage, so
+// any chord of buttons is reported exactly as held.
+struct __attribute__((packed)) KeyboardReport {
+    uint8_t modifiers = 0;
+    uint8_t keys[KEYBOARD_BITMAP] = {};
+
+    constexpr bool has(uint8_t usage) const {
+        return HidKey::isModifier(usage) ? (modifiers >> (usage - HidKey::LEFT_CTRL)) & 1
+             : usage < 8 * KEYBOARD_BITMAP && ((keys[usage >> 3] >> (usage & 7)) & 1);
+    }
+};
+
+constexpr KeyboardReport buildKeyboardReport(uint32_t buttons, const Keymap& map) {
+    KeyboardReport report;
+    for (uint8_t b = 0; b < KEYBOARD_BUTTONS; b++) {
+        const uint8_t usage = map.key[b];
+        if (!((buttons >> b) & 1) || usage == HidKey::NONE) { continue; }
+        if (HidKey::isModifier(usage)) { report.modifiers |= 1 << (usage - HidKey::LEFT_CTRL); }
+        else if (usage < 8 * KEYBOARD_BITMAP) { report.keys[usage >> 3] |= 1 << (usage & 7); }
+    }
+    return report;
+}
+
+// Chords a player actually makes: both flippers, flipper + magna-save,
+// start with a coin, every bound button at once
+static_assert(buildKeyboardReport(0, VPX_KEYMAP).modifiers == 0, "Idle report not empty");
+static_assert(buildKeyboardReport((1 << BTN_LEFT_FLIPPER) | (1 << BTN_RIGHT_FLIPPER), VPX_KEYMAP).modifiers == 0x22,
+              "Flipper chord lost");
+static_assert(buildKeyboardReport((1 << BTN_LEFT_FLIPPER) | (1 << BTN_LEFT_MAGNA), VPX_KEYMAP).modifiers == 0x03,
+              "Flipper + magna-save chord lost");
+static_assert(buildKeyboardReport((1 << BTN_START) | (1 << BTN_COIN), VPX_KEYMAP).has(HidKey::N1)
+           && buildKeyboardReport((1 << BTN_START) | (1 << BTN_COIN), VPX_KEYMAP).has(HidKey::N5),
+              "Start + coin chord lost");
+static_assert(buildKeyboardReport(VPX_KEYMAP.mapped(), VPX_KEYMAP).has(HidKey::ENTER)
+           && buildKeyboardReport(VPX_KEYMAP.mapped(), VPX_KEYMAP).has(HidKey::T)
+           && buildKeyboardReport(VPX_KEYMAP.mapped(), VPX_KEYMAP).modifiers == 0x37,
+              "Full chord lost");
+static_assert(!buildKeyboardReport(1u << 31, VPX_KEYMAP).has(HidKey::ENTER), "Unbound bit reported");
+static_assert(sizeof(KeyboardReport) == 1 + KEYBOARD_BITMAP, "KeyboardReport is padded");
+
+/****************************************************************************/
+// USB HID keyboard for front ends that only take keys. It registers with
+// the same USBHID as GamepadHID under its own report ID, so the two make
+// one composite device: keys for the buttons, axes from the gamepad.
+class KeyboardHID : public USBHIDDevice {
+
+private:
+    USBHID _hid;
+    Keymap _map;
+
+    static constexpr uint8_t DESCRIPTOR[] = {
+        0x05, 0x01,                             // Usage Page (Generic Desktop)
+        0x09, 0x06,                             // Usage (Keyboard)
+        0xA1, 0x01,                             // Collection (Application)
+        0x85, KEYBOARD_REPORT_ID,               //   Report ID
+        0x05, 0x07,                             //   Usage Page (Keyboard/Keypad)
+        0x19, 0xE0,                             //   Usage Minimum (Left Control)
+        0x29, 0xE7,                             //   Usage Maximum (Right GUI)
+        0x15, 0x00,                             //   Logical Minimum (0)
+        0x25, 0x01,                             //   Logical Maximum (1)
+        0x75, 0x01,                             //   Report Size (1)
+        0x95, 0x08,                             //   Report Count (8)
+        0x81, 0x02,                             //   Input (Data, Var, Abs)
+        0x19, 0x00,                             //   Usage Minimum (0)
+        0x29, 8 * KEYBOARD_BITMAP - 1,          //   Usage Maximum (0x7F)
+        0x95, 8 * KEYBOARD_BITMAP,              //   Report Count (128)
+        0x81, 0x02,                             //   Input (Data, Var, Abs)
+        0xC0                                    // End Collection
+    };
+
+public:
+
+    KeyboardHID(const Keymap& map = VPX_KEYMAP) : _map(map) {
+        static_assert(hidReportMatches(DESCRIPTOR, sizeof(DESCRIPTOR), KEYBOARD_REPORT_ID, sizeof(KeyboardReport)),
+                      "Keyboard descriptor does not match KeyboardReport");
+        static bool initialized = false;
+        if (!initialized) {
+            initialized = true;
+            _hid.addDevice(this, sizeof(DESCRIPTOR));
+        }
+    }
+
+    // Not needed alongside GamepadHID, which starts the shared USB stack
+    void begin() {
+        _hid.begin();
+        USB.begin();
+    }
+
+    bool ready() { return _hid.ready(); }
+
+    void setKey(uint8_t bit, uint8_t usage) { _map.bind(bit, usage); }
+    const Keymap& keymap() const { return _map; }
+    uint32_t mapped() const { return _map.mapped(); }
+
+    bool send(uint32_t buttons, uint32_t timeoutMs = 2) {
+        const KeyboardReport report = buildKeyboardReport(buttons, _map);
+        return _hid.SendReport(KEYBOARD_REPORT_ID, &report, sizeof(report), timeoutMs);
+    }
+
+    uint16_t _onGetDescriptor(uint8_t* buffer) override {
+        memcpy(buffer, DESCRIPTOR, sizeof(DESCRIPTOR));
+        return sizeof(DESCRIPTOR);
+    }
+};
+/****************************************************************************/
+
+#endif
@@ -0,0 +1,266 @@
+#ifndef PINBALL_HID_HPP
+#define PINBALL_HID_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <USB.h>
+#include <USBHID.h>
+#include <esp32-hal-tinyusb.h>
+#include "Gamepad.hpp"
+#include "HidDescriptor.hpp"
+
+constexpr uint8_t PINBALL_REPORT_ID = 0x03;
+constexpr char PINBALL_USAGE_STRING[] = "OpenPinballDeviceStruct/1.0";
+
+// Scales of the derived fields
+constexpr float NUDGE_VELOCITY_MM_S = 1000.f;   // vxNudge/vyNudge counts per m/s
+constexpr float NUDGE_VELOCITY_TAU_S = 0.25f;   // Leak, so the velocity settles back to 0 at rest
+constexpr float PLUNGER_SPEED_FULL_S = 0.02f;   // Full travel in this time = full-scale speed
+constexpr uint32_t PLUNGER_STILL_US = 30000;    // No plunger movement this long = speed 0
+
+/****************************************************************************/
+// Open Pinball Device semantic buttons (pinballButtons bit numbers)
+enum OpdButton : uint8_t {
+    OPD_START, OPD_EXIT, OPD_EXTRA_BALL,
+    OPD_COIN1, OPD_COIN2, OPD_COIN3, OPD_COIN4,
+    OPD_LAUNCH, OPD_FIRE,
+    OPD_LEFT_FLIPPER, OPD_RIGHT_FLIPPER, OPD_UPPER_LEFT_FLIPPER, OPD_UPPER_RIGHT_FLIPPER,
+    OPD_LEFT_MAGNA, OPD_RIGHT_MAGNA,
+    OPD_TILT_BOB, OPD_SLAM_TILT, OPD_COIN_DOOR
+};
+
+// PinballButton bit -> OpdButton bit
+inline constexpr uint8_t OPD_BUTTON_MAP[PINBALL_BUTTONS] = {
+    OPD_LEFT_FLIPPER, OPD_RIGHT_FLIPPER, OPD_LEFT_MAGNA, OPD_RIGHT_MAGNA,
+    OPD_LAUNCH, OPD_START, OPD_COIN1, OPD_EXIT, OPD_FIRE, OPD_TILT_BOB
+};
+
+// One report, exactly as the host reads it. Every analog field is 16-bit.
+struct __attribute__((packed)) PinballReport {
+    uint64_t timestamp;                         // us, of the newest input in the report
+    uint32_t genericButtons;                    // Raw ButtonManager bits
+    uint32_t pinballButtons;                    // OpdButton bits
+    uint8_t llFlipper, lrFlipper;               // Analog flipper travel, 0-255
+    uint8_t ulFlipper, urFlipper;
+    int16_t axNudge, ayNudge;                   // Cabinet acceleration, +-32767 = +-2 g (toNudge())
+    int16_t vxNudge, vyNudge;                   // Cabinet velocity, mm/s
+    int16_t plungerPos;                         // 0 at rest, + pulled back, - pushed in
+    int16_t plungerSpeed;                       // + moving back, - moving forward
+};
+static_assert(sizeof(PinballReport) == 32, "PinballReport does not match the Open Pinball Device struct");
+
+/****************************************************************************/
+// Turns the GamepadState stream into PinballReports. The state already
+// holds the cabinet acceleration (the Joystick's GravityTracker residual,
+// not the tilt; zero without one) and the RangeLaser plunger on Z; the velocities are derived here
+// from successive states, using each state's own sample time, so they
+// don't depend on how often encode() is called.
+class PinballEncoder {
+
+private:
+    uint32_t _lastSampled = 0, _wraps = 0;
+    bool _primed = false;
+    float _vel[2] = {};                         // Nudge velocity, m/s
+    int16_t _plunger = 0;                       // Last plunger position that moved
+    uint32_t _plungerAt = 0;
+    float _plungerSpeed = 0.f;                  // Axis units per s
+
+    static int16_t saturate(float v) {
+        return static_cast<int16_t>(lroundf(constrain(v, -AXIS_MAX, AXIS_MAX)));
+    }
+
+    static uint32_t mapButtons(uint32_t buttons) {
+        uint32_t opd = 0;
+        for (uint8_t b = 0; b < PINBALL_BUTTONS; b++) { opd |= ((buttons >> b) & 1) << OPD_BUTTON_MAP[b]; }
+        return opd;
+    }
+
+public:
+
+    void reset() {
+        _primed = false;
+        _vel[0] = _vel[1] = 0.f;
+        _plungerSpeed = 0.f;
+    }
+
+    void encode(const GamepadState& state, PinballReport& report) {
+        const float dt = _primed ? (state.sampled - _lastSampled) * 1e-6f : 0.f;
+        if (_primed && state.sampled < _lastSampled) { _wraps++; }
+        if (!_primed) { _plunger = state.axis[AXIS_Z]; _plungerAt = state.sampled; }
+        _lastSampled = state.sampled;
+        _primed = true;
+
+        // Leaky integral of the nudge acceleration; exact decay, so a long
+        // gap between states can't overshoot
+        if (dt > 0.f) {
+            const float decay = expf(-dt / NUDGE_VELOCITY_TAU_S);
+            constexpr float MS2 = NUDGE_FULL_MS2 / AXIS_MAX;
+            for (uint8_t a = 0; a < 2; a++) { _vel[a] = _vel[a] * decay + state.nudge[a] * MS2 * dt; }
+        }
+
+        // The plunger updates slower than the state; measure speed between
+        // positions that actually differ
+        if (state.axis[AXIS_Z] != _plunger) {
+            const uint32_t span = state.sampled - _plungerAt;
+            if (span) { _plungerSpeed = (state.axis[AXIS_Z] - _plunger) * 1e6f / span; }
+            _plunger = state.axis[AXIS_Z];
+            _plungerAt = state.sampled;
+        } else if (state.sampled - _plungerAt > PLUNGER_STILL_US) {
+            _plungerSpeed = 0.f;
+        }
+
+        report.timestamp = (static_cast<uint64_t>(_wraps) << 32) | state.sampled;
+        report.genericButtons = state.buttons;
+        report.pinballButtons = mapButtons(state.buttons);
+        report.llFlipper = ((state.buttons >> BTN_LEFT_FLIPPER) & 1) * 255;
+        report.lrFlipper = ((state.buttons >> BTN_RIGHT_FLIPPER) & 1) * 255;
+        report.ulFlipper = report.urFlipper = 0;
+        report.axNudge = state.nudge[0];
+        report.ayNudge = state.nudge[1];
+        report.vxNudge = saturate(_vel[0] * NUDGE_VELOCITY_MM_S);
+        report.vyNudge = saturate(_vel[1] * NUDGE_VELOCITY_MM_S);
+        report.plungerPos = state.axis[AXIS_Z];
+        report.plungerSpeed = saturate(_plungerSpeed * PLUNGER_SPEED_FULL_S);
+    }
+};
+
+/****************************************************************************/
+// USB HID Open Pinball Device: one opaque 32-byte report under the Game
+// Controls / Pinball Device usage, named by a usage string so hosts can
+// tell the struct version. Registers on the shared USBHID like GamepadHID
+// and KeyboardHID; the interface polls its endpoint every 1 ms.
+class PinballHID : public USBHIDDevice {
+
+private:
+    USBHID _hid;
+    uint8_t _stringIndex = 0;
+
+    static constexpr uint8_t STRING_INDEX_AT = 11;      // Patched once the string is registered
+    static constexpr uint8_t DESCRIPTOR[] = {
+        0x05, 0x05,                             // Usage Page (Game Controls)
+        0x09, 0x02,                             // Usage (Pinball Device)
+        0xA1, 0x01,                             // Collection (Application)
+        0x85, PINBALL_REPORT_ID,                //   Report ID
+        0x09, 0x00,                             //   Usage (Undefined): opaque struct
+        0x79, 0x00,                             //   String Index (usage string)
+        0x15, 0x00,                             //   Logical Minimum (0)
+        0x26, 0xFF, 0x00,                       //   Logical Maximum (255)
+        0x75, 0x08,                             //   Report Size (8)
+        0x95, sizeof(PinballReport),            //   Report Count
+        0x81, 0x02,                             //   Input (Data, Var, Abs)
+        0xC0                                    // End Collection
+    };
+
+public:
+
+    PinballHID() {
+        static_assert(hidReportMatches(DESCRIPTOR, sizeof(DESCRIPTOR), PINBALL_REPORT_ID, sizeof(PinballReport)),
+                      "Pinball descriptor does not match PinballReport");
+        static_assert(DESCRIPTOR[STRING_INDEX_AT - 1] == 0x79, "String Index item moved");
+        static bool initialized = false;
+        if (!initialized) {
+            initialized = true;
+            _stringIndex = tinyusb_add_string_descriptor(PINBALL_USAGE_STRING);
+            _hid.addDevice(this, sizeof(DESCRIPTOR));
+        }
+    }
+
+    void begin() {
+        _hid.begin();
+        USB.begin();
+    }
+
+    bool ready() { return _hid.ready(); }
+
+    bool send(const PinballReport& report, uint32_t timeoutMs = 2) {
+        return _hid.SendReport(PINBALL_REPORT_ID, &report, sizeof(report), timeoutMs);
+    }
+
+    uint16_t _onGetDescriptor(uint8_t* buffer) override {
+        memcpy(buffer, DESCRIPTOR, sizeof(DESCRIPTOR));
+        buffer[STRING_INDEX_AT] = _stringIndex;
+        return sizeof(DESCRIPTOR);
+    }
+};
+
+/****************************************************************************/
+// Sends the newest Gamepad state as a PinballReport every HID_REPORT_US,
+// skipping slots where nothing but the timestamp would change. Same
+// shape as ReportPump, which it replaces when the host speaks Open
+// Pinball Device rather than generic gamepad.
+class PinballPump {
+
+private:
+    Gamepad& _source;
+    PinballHID& _hid;
+    PinballEncoder _encoder;
+    PinballReport _last = {};
+    TaskHandle_t _task = nullptr;
+
+    uint32_t _slots = 0, _sent = 0, _skipped = 0, _failed = 0;
+    uint32_t _latMax = 0;
+    uint64_t _latSum = 0;
+
+    static void run(void* arg) {
+        PinballPump& self = *static_cast<PinballPump*>(arg);
+        const TickType_t period = max<TickType_t>(pdMS_TO_TICKS(HID_REPORT_US / 1000), 1);
+        for (;;) {
+            ulTaskNotifyTake(pdTRUE, period);   // A slot per period, or at once on an edge
+            self.pump();
+        }
+    }
+
+public:
+
+    PinballPump(Gamepad& source, PinballHID& hid) : _source(source), _hid(hid) {}
+
+    PinballEncoder& encoder() { return _encoder; }
+
+    // For MotionGamepad::notifyOnEdge(); nullptr before begin()
+    TaskHandle_t task() const { return _task; }
+
+    bool begin(UBaseType_t priority = 5, uint8_t core = OUTPUT_CORE) {
+        if (_task) { return true; }
+        if (xTaskCreatePinnedToCore(&PinballPump::run, "opd_pump", 4096, this, priority, &_task, core) != pdPASS) {
+            _task = nullptr;
+            return ErrorMsg("PinballPump task create failed!");
+        }
+        return true;
+    }
+
+    void end() {
+        if (_task) { vTaskDelete(_task); _task = nullptr; }
+    }
+
+    // One report slot. Called by the task; public for driving by hand.
+    void pump() {
+        _slots++;
+        const GamepadState state = _source.getState();
+        PinballReport report;
+        _encoder.encode(state, report);
+        constexpr size_t PAYLOAD = offsetof(PinballReport, genericButtons);
+        if (_sent && memcmp(reinterpret_cast<const uint8_t*>(&report) + PAYLOAD,
+                            reinterpret_cast<const uint8_t*>(&_last) + PAYLOAD, sizeof(report) - PAYLOAD) == 0) {
+            _skipped++;
+            return;
+        }
+        if (!_hid.ready() || !_hid.send(report)) { _failed++; return; }
+        _last = report;
+        const uint32_t latency = micros() - state.sampled;
+        _latMax = max(_latMax, latency);
+        _latSum += latency;
+        _sent++;
+    }
+
+    uint32_t sent() const { return _sent; }
+    uint32_t latencyMean() const { return _sent ? static_cast<uint32_t>(_latSum / _sent) : 0; }
+    uint32_t latencyMax() const { return _latMax; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("PinballPump: %lu slots, %lu sent, %lu unchanged, %lu failed, latency mean %lu / max %lu us\n",
+            _slots, _sent, _skipped, _failed, latencyMean(), latencyMax());
+    }
+};
+/****************************************************************************/
+
+#endif
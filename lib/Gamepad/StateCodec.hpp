@@ -0,0 +1,163 @@
+#ifndef STATE_CODEC_HPP
+#define STATE_CODEC_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+#include "GamepadState.hpp"
+
+/****************************************************************************/
+// Wire layout of a GamepadState: each field at the offset it has in memory,
+// little-endian, no padding. Because the two agree, packing is one memcpy.
+//
+//   offset  size  field
+//        0     4  buttons      bit k = button k+1
+//        4     4  sampled      micros()
+//        8     6  axis X/Y/Z   int16 each
+//       14     4  nudge X/Y    int16 each, toNudge() units
+//       18         (STATE_BYTES)
+enum StateField : uint8_t {
+    FIELD_BUTTONS,
+    FIELD_SAMPLED,
+    FIELD_X,
+    FIELD_Y,
+    FIELD_Z,
+    FIELD_NUDGE_X,
+    FIELD_NUDGE_Y,
+    STATE_FIELDS
+};
+
+struct FieldSpan {
+    uint8_t offset;
+    uint8_t size;
+};
+
+inline constexpr FieldSpan STATE_LAYOUT[STATE_FIELDS] = {
+    { offsetof(GamepadState, buttons), sizeof(uint32_t) },
+    { offsetof(GamepadState, sampled), sizeof(uint32_t) },
+    { offsetof(GamepadState, axis) + AXIS_X * sizeof(int16_t), sizeof(int16_t) },
+    { offsetof(GamepadState, axis) + AXIS_Y * sizeof(int16_t), sizeof(int16_t) },
+    { offsetof(GamepadState, axis) + AXIS_Z * sizeof(int16_t), sizeof(int16_t) },
+    { offsetof(GamepadState, nudge), sizeof(int16_t) },
+    { offsetof(GamepadState, nudge) + sizeof(int16_t), sizeof(int16_t) },
+};
+
+constexpr uint8_t STATE_BYTES = STATE_LAYOUT[FIELD_NUDGE_Y].offset + STATE_LAYOUT[FIELD_NUDGE_Y].size;
+constexpr uint8_t FIELDS_ALL = (1 << STATE_FIELDS) - 1;
+constexpr uint8_t DELTA_MAX = 1 + STATE_BYTES;     // Mask byte + every field
+
+static_assert(STATE_BYTES == 18, "GamepadState has interior padding");
+static_assert(STATE_LAYOUT[FIELD_SAMPLED].offset == STATE_LAYOUT[FIELD_BUTTONS].offset + 4
+           && STATE_LAYOUT[FIELD_X].offset == STATE_LAYOUT[FIELD_SAMPLED].offset + 4
+           && STATE_LAYOUT[FIELD_NUDGE_X].offset == STATE_LAYOUT[FIELD_Z].offset + 2,
+              "GamepadState fields out of wire order");
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Wire format is little-endian");
+
+inline void packState(const GamepadState& state, uint8_t (&out)[STATE_BYTES]) {
+    memcpy(out, &state, STATE_BYTES);
+}
+
+inline void unpackState(const uint8_t (&in)[STATE_BYTES], GamepadState& state) {
+    memcpy(static_cast<void*>(&state), in, STATE_BYTES);
+}
+
+/****************************************************************************/
+// Change records between successive states, for HID, telemetry and
+// recordings alike. A record is one mask byte (bit f = field f present)
+// followed by the present fields in StateField order. The first record
+// after reset() carries every enabled field, so a stream can be decoded
+// from any such keyframe.
+//
+// Encoding does not branch per field: every field is written at the
+// current end of the record and the end only advances if it changed.
+class DeltaEncoder {
+
+private:
+    GamepadState _ref;
+    uint8_t _fields;
+    bool _primed = false;
+
+    template<uint8_t F>
+    void emit(const uint8_t* cur, const uint8_t* ref, uint8_t* out, uint8_t& mask, uint8_t& n) const {
+        constexpr FieldSpan span = STATE_LAYOUT[F];
+        uint32_t a = 0, b = 0;
+        memcpy(&a, cur + span.offset, span.size);
+        memcpy(&b, ref + span.offset, span.size);
+        const uint8_t hit = ((a != b) | !_primed) & (_fields >> F) & 1;
+        memcpy(out + n, cur + span.offset, span.size);
+        n += hit * span.size;
+        mask |= hit << F;
+    }
+
+    template<size_t... F>
+    uint8_t encodeFields(const GamepadState& next, uint8_t* out, std::index_sequence<F...>) const {
+        const uint8_t* cur = reinterpret_cast<const uint8_t*>(&next);
+        const uint8_t* ref = reinterpret_cast<const uint8_t*>(&_ref);
+        uint8_t mask = 0, n = 1;
+        (emit<F>(cur, ref, out, mask, n), ...);
+        out[0] = mask;
+        return mask ? n : 0;
+    }
+
+public:
+
+    // `fields`: mask of StateFields to track, e.g. without FIELD_SAMPLED
+    // for a recording that is timestamped elsewhere
+    DeltaEncoder(uint8_t fields = FIELDS_ALL) : _fields(fields & FIELDS_ALL) {}
+
+    // Writes the record for `next` (up to DELTA_MAX bytes) and returns its
+    // length, 0 if nothing tracked has changed
+    uint8_t encode(const GamepadState& next, uint8_t (&out)[DELTA_MAX]) {
+        const uint8_t n = encodeFields(next, out, std::make_index_sequence<STATE_FIELDS>{});
+        _ref = next;
+        _primed = true;
+        return n;
+    }
+
+    void reset() { _primed = false; }
+    const GamepadState& last() const { return _ref; }
+};
+
+/****************************************************************************/
+// Rebuilds states from DeltaEncoder records. Fields absent from a record
+// keep their previous value.
+class DeltaDecoder {
+
+private:
+    GamepadState _state;
+
+    static constexpr uint8_t recordLength(uint8_t mask) {
+        uint8_t n = 1;
+        for (uint8_t f = 0; f < STATE_FIELDS; f++) { n += ((mask >> f) & 1) * STATE_LAYOUT[f].size; }
+        return n;
+    }
+
+public:
+
+    // Applies the record at `in` and returns the bytes it took, so records
+    // can be read back to back; 0 if it is malformed or runs past `len`
+    uint8_t decode(const uint8_t* in, size_t len, GamepadState& out) {
+        if (len == 0 || (in[0] & ~FIELDS_ALL)) { return 0; }
+        const uint8_t mask = in[0];
+        const uint8_t n = recordLength(mask);
+        if (n > len) { return 0; }
+        uint8_t* dst = reinterpret_cast<uint8_t*>(&_state);
+        uint8_t pos = 1;
+        for (uint8_t f = 0; f < STATE_FIELDS; f++) {
+            if (!((mask >> f) & 1)) { continue; }
+            memcpy(dst + STATE_LAYOUT[f].offset, in + pos, STATE_LAYOUT[f].size);
+            pos += STATE_LAYOUT[f].size;
+        }
+        out = _state;
+        return n;
+    }
+
+    void reset() { _state = GamepadState(); }
+    const GamepadState& state() const { return _state; }
+};
+
+/****************************************************************************/
+
+#endif
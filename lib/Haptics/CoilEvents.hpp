@@ -0,0 +1,69 @@
+// CoilEvents.hpp
+#ifndef COIL_EVENTS_H
+#define COIL_EVENTS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief A coil starting to kick. Coils are identified by their LEDC
+ * channel, which is unique across CoilScheduler and HapticPlayer.
+ */
+struct CoilEvent {
+    uint8_t coil;
+    uint32_t us;            // micros() the coil was energised
+};
+
+/**
+ * @brief Ring of fire events from the coil drivers (esp_timer task) to the
+ * accelerometer pipeline (loop). When full the oldest event is dropped.
+ */
+class CoilEventQueue {
+
+public:
+    static constexpr uint8_t CAPACITY = 16;
+
+private:
+    CoilEvent _ring[CAPACITY];
+    uint8_t _head = 0;
+    uint8_t _size = 0;
+    uint32_t _published = 0;
+    uint32_t _dropped = 0;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+public:
+    void push(uint8_t coil, uint32_t us) {
+        portENTER_CRITICAL(&_lock);
+        if (_size == CAPACITY) {
+            _head = (_head + 1) % CAPACITY;
+            _size--;
+            _dropped++;
+        }
+        _ring[(_head + _size) % CAPACITY] = CoilEvent{coil, us};
+        _size++;
+        _published++;
+        portEXIT_CRITICAL(&_lock);
+    }
+
+    bool pop(CoilEvent& event) {
+        portENTER_CRITICAL(&_lock);
+        const bool ok = _size > 0;
+        if (ok) {
+            event = _ring[_head];
+            _head = (_head + 1) % CAPACITY;
+            _size--;
+        }
+        portEXIT_CRITICAL(&_lock);
+        return ok;
+    }
+
+    void clear() {
+        portENTER_CRITICAL(&_lock);
+        _head = _size = 0;
+        portEXIT_CRITICAL(&_lock);
+    }
+
+    uint32_t published() const { return _published; }
+    uint32_t dropped() const { return _dropped; }
+};
+
+#endif // COIL_EVENTS_H
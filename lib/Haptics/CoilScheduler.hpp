@@ -0,0 +1,247 @@
+// CoilScheduler.hpp
+#ifndef COIL_SCHEDULER_H
+#define COIL_SCHEDULER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Solenoid.hpp"
+#include "CoilEvents.hpp"
+
+/**
+ * @brief Kick-then-hold drive profile for one coil
+ *
+ * A fire drives the coil at kickDuty for kickUs to pull the plunger in,
+ * drops to holdDuty (enough to keep it seated, without cooking it) and
+ * releases after the requested on-time, never later than maxOnUs.
+ */
+struct PulseProfile {
+    uint32_t kickUs;
+    uint16_t kickDuty;      // 0-4095
+    uint16_t holdDuty;      // 0-4095, 0 = kick only
+    uint32_t maxOnUs;
+};
+
+constexpr PulseProfile DEFAULT_PULSE = {20000, 4095, 1200, 500000};
+
+class CoilScheduler {
+
+public:
+    static constexpr uint8_t MAX_COILS = 8;
+
+private:
+    enum Phase : uint8_t { IDLE, PENDING, KICK, HOLD, RELEASING, REFIRE };
+
+    struct Coil {
+        CoilScheduler* owner;
+        Solenoid* driver;
+        PulseProfile profile;
+        esp_timer_handle_t timer;
+        volatile Phase phase;
+        uint32_t seq;               // Bumped by every fire()/release()
+        uint32_t onUs;              // Requested on-time for this fire
+        uint32_t requested;         // micros() at fire()
+        uint32_t energised;         // micros() at kick start
+        uint32_t deadline;          // micros() the coil must be off by
+        bool carry;                 // Re-fired while energised: keep the deadline
+    };
+
+    Coil _coils[MAX_COILS];
+    uint8_t _count;
+    CoilEventQueue* _events;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Fire-to-energise latency statistics (us)
+    uint32_t _latMin, _latMax, _latSum, _latCount;
+
+    /**
+     * @brief Phase transitions, all run from the esp_timer task so the
+     * LEDC writes for a coil never race each other
+     */
+    static void onTimer(void* arg) {
+        Coil& c = *static_cast<Coil*>(arg);
+        CoilScheduler& self = *c.owner;
+        const uint32_t now = micros();
+
+        portENTER_CRITICAL(&self._lock);
+        const Phase phase = c.phase;
+        const uint32_t onUs = c.onUs;
+        const uint32_t requested = c.requested;
+        const uint32_t seq = c.seq;
+        const bool carry = c.carry;
+        portEXIT_CRITICAL(&self._lock);
+
+        switch (phase) {
+            case REFIRE: {
+                // Delayed re-fire: off until the new kick is due
+                c.driver->setDuty(0);
+                const int32_t wait = static_cast<int32_t>(requested - now);
+                setPhase(self, c, seq, PENDING);
+                esp_timer_start_once(c.timer, wait > 0 ? wait : 0);
+                break;
+            }
+            case PENDING: {
+                c.driver->setDuty(c.profile.kickDuty);
+                c.energised = now;
+                if (!carry) c.deadline = now + c.profile.maxOnUs;
+                if (self._events) self._events->push(c.driver->getChannel(), now);
+                self.recordLatency(now - requested);
+                const uint32_t kick = min(c.profile.kickUs, onUs);
+                setPhase(self, c, seq, KICK);
+                esp_timer_start_once(c.timer, kick);
+                break;
+            }
+            case KICK:
+                if (c.profile.holdDuty && onUs > c.profile.kickUs) {
+                    c.driver->setDuty(c.profile.holdDuty);
+                    setPhase(self, c, seq, HOLD);
+                    esp_timer_start_once(c.timer, onUs - c.profile.kickUs);
+                    break;
+                }
+                // fall through - kick-only profile
+            case HOLD:
+            case RELEASING:
+                c.driver->setDuty(0);
+                setPhase(self, c, seq, IDLE);
+                break;
+            case IDLE:
+                break;
+        }
+    }
+
+    static void setPhase(CoilScheduler& self, Coil& c, uint32_t seq, Phase phase) {
+        portENTER_CRITICAL(&self._lock);
+        if (c.seq == seq) { c.phase = phase; }           // A newer fire()/release() wins
+        portEXIT_CRITICAL(&self._lock);
+    }
+
+    void recordLatency(uint32_t us) {
+        _latMin = min(_latMin, us);
+        _latMax = max(_latMax, us);
+        _latSum += us;
+        _latCount++;
+    }
+
+    // Re-arm a coil's timer to run the next phase after delayUs
+    void kick(Coil& c, Phase phase, uint32_t delayUs = 0) {
+        portENTER_CRITICAL(&_lock);
+        c.phase = phase;
+        c.seq++;
+        portEXIT_CRITICAL(&_lock);
+        esp_timer_stop(c.timer);
+        esp_timer_start_once(c.timer, delayUs);
+    }
+
+public:
+    CoilScheduler() : _count(0), _events(nullptr) { resetStats(); }
+
+    /**
+     * @brief Register a coil (its Solenoid must already be begun)
+     * @return Coil index, or -1 if full or the timer could not be created
+     */
+    int8_t add(Solenoid& driver, const PulseProfile& profile = DEFAULT_PULSE) {
+        if (_count >= MAX_COILS) {
+            Serial.println("CoilScheduler full!");
+            return -1;
+        }
+        Coil& c = _coils[_count];
+        c = Coil{this, &driver, profile, nullptr, IDLE, 0, 0, 0, 0, 0, false};
+        esp_timer_create_args_t args = {};
+        args.callback = &CoilScheduler::onTimer;
+        args.arg = &c;
+        args.name = "coil";
+        if (esp_timer_create(&args, &c.timer) != ESP_OK) {
+            Serial.println("CoilScheduler timer create failed!");
+            return -1;
+        }
+        return static_cast<int8_t>(_count++);
+    }
+
+    /**
+     * @brief Fire a coil through its profile. Returns immediately; the
+     * kick, hold and release all happen from esp_timer.
+     *
+     * Re-firing a coil that is still energised never extends its on-time
+     * past maxOnUs: an immediate re-fire kicks again but keeps the running
+     * fire's deadline, and a delayed one drops the coil to zero until its
+     * kick is due.
+     * @param coil Coil index from add()
+     * @param onUs Total on-time, 0 = profile maxOnUs (clamped to it)
+     * @param delayUs Start the kick this long from now (staggering)
+     * @param sinceUs micros() when the request arrived (e.g. a host report),
+     * so the latency stats cover the time before this call too
+     * @return false for an unknown coil, or one re-fired past its deadline
+     */
+    bool fire(uint8_t coil, uint32_t onUs = 0, uint32_t delayUs = 0, uint32_t sinceUs = micros()) {
+        if (coil >= _count) return false;
+        Coil& c = _coils[coil];
+        const uint32_t limit = c.profile.maxOnUs;
+        const uint32_t now = micros();
+        portENTER_CRITICAL(&_lock);
+        c.onUs = (onUs == 0 || onUs > limit) ? limit : onUs;
+        c.requested = sinceUs + delayUs;
+        const bool energised = c.phase == KICK || c.phase == HOLD || (c.phase == PENDING && c.carry);
+        c.carry = energised && delayUs == 0;
+        const int32_t left = static_cast<int32_t>(c.deadline - now);
+        if (c.carry && left > 0) c.onUs = min(c.onUs, static_cast<uint32_t>(left));
+        portEXIT_CRITICAL(&_lock);
+        if (c.carry && left <= 0) {
+            kick(c, RELEASING);         // Already on for maxOnUs
+            return false;
+        }
+        if (energised && delayUs) {
+            kick(c, REFIRE);
+        } else {
+            kick(c, PENDING, delayUs);
+        }
+        return true;
+    }
+
+    /**
+     * @brief End a fire early (e.g. flipper button released)
+     */
+    void release(uint8_t coil) {
+        if (coil >= _count || _coils[coil].phase == IDLE) return;
+        kick(_coils[coil], RELEASING);
+    }
+
+    void releaseAll() {
+        for (uint8_t k = 0; k < _count; k++) release(k);
+    }
+
+    bool isActive(uint8_t coil) const {
+        return coil < _count && _coils[coil].phase != IDLE;
+    }
+
+    void setProfile(uint8_t coil, const PulseProfile& profile) {
+        if (coil < _count) _coils[coil].profile = profile;
+    }
+
+    const PulseProfile& getProfile(uint8_t coil) const { return _coils[coil].profile; }
+    const Solenoid& getDriver(uint8_t coil) const { return *_coils[coil].driver; }
+
+    /**
+     * @brief Publish every kick start to `events` (nullptr to stop)
+     */
+    void setEventQueue(CoilEventQueue* events) { _events = events; }
+    uint8_t size() const { return _count; }
+
+    /**
+     * @brief Fire-to-energise latency, as seen by the timer task
+     */
+    uint32_t latencyMin() const { return _latCount ? _latMin : 0; }
+    uint32_t latencyMax() const { return _latMax; }
+    uint32_t latencyMean() const { return _latCount ? _latSum / _latCount : 0; }
+    uint32_t latencyJitter() const { return _latCount ? _latMax - _latMin : 0; }
+
+    void resetStats() {
+        _latMin = UINT32_MAX;
+        _latMax = _latSum = _latCount = 0;
+    }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("CoilScheduler: %lu fires, latency min %lu / mean %lu / max %lu us, jitter %lu us\n",
+            _latCount, latencyMin(), latencyMean(), latencyMax(), latencyJitter());
+    }
+};
+
+#endif // COIL_SCHEDULER_H
@@ -0,0 +1,93 @@
+// HapticEffects.hpp
+#ifndef HAPTIC_EFFECTS_H
+#define HAPTIC_EFFECTS_H
+
+#include <Arduino.h>
+
+/**
+ * @brief One breakpoint of a duty envelope. Duty is linearly interpolated
+ * between breakpoints and drops to 0 after the last one.
+ */
+struct EnvelopePoint {
+    uint16_t ms;            // Time from effect start
+    uint16_t duty;          // 0-4095
+};
+
+struct HapticEnvelope {
+    const EnvelopePoint* points;
+    uint8_t count;
+    uint16_t duration;      // ms, time of the last point
+};
+
+template<size_t K>
+constexpr HapticEnvelope makeEnvelope(const EnvelopePoint (&points)[K]) {
+    static_assert(K >= 2 && K <= 255, "Envelope needs 2..255 points");
+    return HapticEnvelope{points, static_cast<uint8_t>(K), points[K - 1].ms};
+}
+
+/**
+ * @brief Duty of an envelope at time t (ms, Q4 fraction for sub-ms
+ * resolution at the PWM update rate). Constexpr so tables can be checked
+ * at compile time.
+ */
+constexpr uint16_t sampleEnvelope(const HapticEnvelope& env, uint32_t tQ4, uint8_t& cursor) {
+    const EnvelopePoint* p = env.points;
+    if (tQ4 >= (static_cast<uint32_t>(env.duration) << 4)) return 0;
+    if (cursor >= env.count - 1 || (static_cast<uint32_t>(p[cursor].ms) << 4) > tQ4) cursor = 0;
+    while (cursor + 2 < env.count && (static_cast<uint32_t>(p[cursor + 1].ms) << 4) <= tQ4) cursor++;
+    const uint32_t t0 = static_cast<uint32_t>(p[cursor].ms) << 4;
+    const uint32_t t1 = static_cast<uint32_t>(p[cursor + 1].ms) << 4;
+    if (t1 <= t0) return p[cursor + 1].duty;
+    const int32_t d0 = p[cursor].duty, d1 = p[cursor + 1].duty;
+    return static_cast<uint16_t>(d0 + (d1 - d0) * static_cast<int32_t>(tQ4 - t0) / static_cast<int32_t>(t1 - t0));
+}
+
+/**
+ * @brief Built-in effects, stored as flash tables
+ */
+namespace Haptic {
+
+inline constexpr EnvelopePoint FLIPPER_POINTS[] = {
+    {0, 4095}, {12, 4095}, {14, 1200}, {40, 0}
+};
+inline constexpr EnvelopePoint BUMPER_POINTS[] = {
+    {0, 4095}, {25, 4095}, {30, 1600}, {80, 0}
+};
+inline constexpr EnvelopePoint SLINGSHOT_POINTS[] = {
+    {0, 4095}, {18, 4095}, {20, 800}, {50, 0}
+};
+inline constexpr EnvelopePoint KNOCKER_POINTS[] = {
+    {0, 4095}, {45, 4095}, {46, 0}
+};
+inline constexpr EnvelopePoint DRAIN_RUMBLE_POINTS[] = {
+    {0, 0}, {60, 1600}, {120, 600}, {180, 1600}, {240, 600},
+    {300, 1400}, {360, 400}, {420, 1000}, {600, 0}
+};
+inline constexpr EnvelopePoint TILT_BUZZ_POINTS[] = {
+    {0, 2400}, {100, 2400}, {101, 0}, {200, 0}, {201, 2400}, {300, 2400}, {301, 0}, {400, 0}
+};
+inline constexpr EnvelopePoint BALL_LAUNCH_POINTS[] = {
+    {0, 0}, {30, 3000}, {60, 4095}, {70, 0}
+};
+
+inline constexpr HapticEnvelope FLIPPER_HIT  = makeEnvelope(FLIPPER_POINTS);
+inline constexpr HapticEnvelope BUMPER       = makeEnvelope(BUMPER_POINTS);
+inline constexpr HapticEnvelope SLINGSHOT    = makeEnvelope(SLINGSHOT_POINTS);
+inline constexpr HapticEnvelope KNOCKER      = makeEnvelope(KNOCKER_POINTS);
+inline constexpr HapticEnvelope DRAIN_RUMBLE = makeEnvelope(DRAIN_RUMBLE_POINTS);
+inline constexpr HapticEnvelope TILT_BUZZ    = makeEnvelope(TILT_BUZZ_POINTS);
+inline constexpr HapticEnvelope BALL_LAUNCH  = makeEnvelope(BALL_LAUNCH_POINTS);
+
+// Compile-time checks of the tables
+constexpr uint16_t sampleAt(const HapticEnvelope& env, uint32_t ms) {
+    uint8_t cursor = 0;
+    return sampleEnvelope(env, ms << 4, cursor);
+}
+static_assert(sampleAt(BUMPER, 10) == 4095, "bumper kick");
+static_assert(sampleAt(BUMPER, 55) == 800, "bumper decay midpoint");
+static_assert(sampleAt(KNOCKER, 46) == 0, "knocker ends");
+static_assert(sampleAt(DRAIN_RUMBLE, 30) == 800, "rumble ramp");
+
+} // namespace Haptic
+
+#endif // HAPTIC_EFFECTS_H
@@ -0,0 +1,230 @@
+// HapticPlayer.hpp
+#ifndef HAPTIC_PLAYER_H
+#define HAPTIC_PLAYER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "Solenoid.hpp"
+#include "HapticEffects.hpp"
+#include "CoilEvents.hpp"
+
+// Ramp sampling period. Envelope breakpoints are whole milliseconds, so
+// 1 kHz lands on every one of them; flat segments do not tick at all.
+constexpr uint32_t HAPTIC_TICK_US = 1000;
+
+/**
+ * @brief Non-blocking envelope player for the haptic coils
+ *
+ * play() only queues a voice and wakes the timer. A one-shot esp_timer
+ * samples every voice, sums voices landing on the same coil, saturates at
+ * 4095 and writes each coil's duty only when it changes. It then re-arms
+ * for the next breakpoint, or one tick ahead while any voice is ramping:
+ * at most 1000 wakeups a second, none on flat segments or when idle.
+ *
+ * A coil should be driven either by this player or by a CoilScheduler, not
+ * both: each writes the duty without knowing about the other.
+ */
+template<uint8_t MaxVoices = 8>
+class HapticPlayer {
+
+public:
+    static constexpr uint8_t MAX_COILS = 8;
+
+private:
+    struct Voice {
+        const HapticEnvelope* env;
+        uint32_t start;             // micros()
+        uint16_t gain;              // Q8
+        uint8_t coil;
+        uint8_t cursor;
+        bool active;
+    };
+
+    Solenoid* _coils[MAX_COILS];
+    uint16_t _written[MAX_COILS];
+    uint8_t _count;
+    CoilEventQueue* _events;
+    Voice _voices[MaxVoices];
+    esp_timer_handle_t _timer;
+    uint32_t _tickUs;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Per-tick cost (us) and mixer counters
+    uint32_t _ticks, _tickLast, _tickMax, _tickSum, _saturated, _stolen;
+
+    // Tick now, on the timer task. A tick racing us may have re-armed from
+    // the voices as they were; take the timer back from it.
+    void wake() {
+        if (!_timer) return;
+        esp_timer_stop(_timer);
+        while (esp_timer_start_once(_timer, 0) == ESP_ERR_INVALID_STATE) esp_timer_stop(_timer);
+    }
+
+    static void onTimer(void* arg) {
+        HapticPlayer* self = static_cast<HapticPlayer*>(arg);
+        const uint32_t next = self->tick(micros());
+        if (next) esp_timer_start_once(self->_timer, next);
+    }
+
+public:
+    HapticPlayer() : _count(0), _events(nullptr), _timer(nullptr), _tickUs(HAPTIC_TICK_US) {
+        for (uint8_t k = 0; k < MaxVoices; k++) _voices[k] = Voice{nullptr, 0, 256, 0, 0, false};
+        resetStats();
+    }
+
+    /**
+     * @brief Register a coil (already begun)
+     * @return Player coil index, or -1 if full
+     */
+    int8_t add(Solenoid& driver) {
+        if (_count >= MAX_COILS) return -1;
+        _coils[_count] = &driver;
+        _written[_count] = 0;
+        return static_cast<int8_t>(_count++);
+    }
+
+    /**
+     * @brief Create the sampling timer. It only runs while voices play.
+     * @param tickUs Ramp sampling period, no shorter than HAPTIC_TICK_US
+     */
+    bool begin(uint32_t tickUs = HAPTIC_TICK_US) {
+        if (_timer) return true;
+        esp_timer_create_args_t args = {};
+        args.callback = &HapticPlayer::onTimer;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "haptic";
+        if (esp_timer_create(&args, &_timer) != ESP_OK) {
+            Serial.println("HapticPlayer timer create failed!");
+            _timer = nullptr;
+            return false;
+        }
+        _tickUs = max(tickUs, HAPTIC_TICK_US);
+        return true;
+    }
+
+    void end() {
+        if (!_timer) return;
+        esp_timer_stop(_timer);
+        esp_timer_delete(_timer);
+        _timer = nullptr;
+        stopAll();
+        tick(micros());
+    }
+
+    /**
+     * @brief Start an effect on a coil. Returns immediately.
+     * @param gain Q8 scale of the envelope (256 = as authored)
+     * @return Voice index. When all voices are busy the oldest is stolen.
+     */
+    int8_t play(uint8_t coil, const HapticEnvelope& env, uint16_t gain = 256) {
+        if (coil >= _count) return -1;
+        const uint32_t now = micros();
+        portENTER_CRITICAL(&_lock);
+        uint8_t slot = 0;
+        bool found = false;
+        for (uint8_t k = 0; k < MaxVoices; k++) {
+            if (!_voices[k].active) { slot = k; found = true; break; }
+            if (now - _voices[k].start > now - _voices[slot].start) slot = k;
+        }
+        if (!found) _stolen++;
+        _voices[slot] = Voice{&env, now, gain, coil, 0, true};
+        portEXIT_CRITICAL(&_lock);
+        if (_events) _events->push(_coils[coil]->getChannel(), now);
+        wake();
+        return static_cast<int8_t>(slot);
+    }
+
+    void stop(uint8_t coil) {
+        portENTER_CRITICAL(&_lock);
+        for (uint8_t k = 0; k < MaxVoices; k++) {
+            if (_voices[k].coil == coil) _voices[k].active = false;
+        }
+        portEXIT_CRITICAL(&_lock);
+        wake();
+    }
+
+    void stopAll() {
+        portENTER_CRITICAL(&_lock);
+        for (uint8_t k = 0; k < MaxVoices; k++) _voices[k].active = false;
+        portEXIT_CRITICAL(&_lock);
+        wake();
+    }
+
+    /**
+     * @brief Sample and mix all voices. Called by the timer; public so it can
+     * be driven by hand.
+     * @return us until the next tick is due, 0 once no voice is left
+     */
+    uint32_t tick(uint32_t now) {
+        const uint32_t tic = micros();
+        uint32_t mix[MAX_COILS] = {};
+        uint32_t next = 0;
+
+        portENTER_CRITICAL(&_lock);
+        for (uint8_t k = 0; k < MaxVoices; k++) {
+            Voice& v = _voices[k];
+            if (!v.active) continue;
+            const uint32_t elapsed = now - v.start;
+            if (elapsed >= static_cast<uint32_t>(v.env->duration) * 1000) {
+                v.active = false;
+                continue;
+            }
+            const uint32_t tQ4 = (elapsed << 4) / 1000;
+            mix[v.coil] += (static_cast<uint32_t>(sampleEnvelope(*v.env, tQ4, v.cursor)) * v.gain) >> 8;
+            // The cursor now sits on the segment holding `elapsed`
+            const EnvelopePoint* p = v.env->points + v.cursor;
+            uint32_t due = static_cast<uint32_t>(p[1].ms) * 1000 - elapsed;
+            if (p[0].duty != p[1].duty) due = min(due, _tickUs);
+            next = next ? min(next, due) : due;
+        }
+        portEXIT_CRITICAL(&_lock);
+
+        for (uint8_t c = 0; c < _count; c++) {
+            if (mix[c] > 4095) {
+                mix[c] = 4095;
+                _saturated++;
+            }
+            if (mix[c] != _written[c]) {
+                _coils[c]->setDuty(mix[c]);
+                _written[c] = static_cast<uint16_t>(mix[c]);
+            }
+        }
+
+        _tickLast = micros() - tic;
+        _tickMax = max(_tickMax, _tickLast);
+        _tickSum += _tickLast;
+        _ticks++;
+        return next;
+    }
+
+    uint8_t activeVoices() const {
+        uint8_t n = 0;
+        for (uint8_t k = 0; k < MaxVoices; k++) n += _voices[k].active;
+        return n;
+    }
+
+    /**
+     * @brief Publish every effect start to `events` (nullptr to stop)
+     */
+    void setEventQueue(CoilEventQueue* events) { _events = events; }
+
+    uint16_t duty(uint8_t coil) const { return coil < _count ? _written[coil] : 0; }
+    uint8_t size() const { return _count; }
+
+    uint32_t ticks() const { return _ticks; }
+    uint32_t lastTickMicros() const { return _tickLast; }
+    uint32_t maxTickMicros() const { return _tickMax; }
+    float meanTickMicros() const { return _ticks ? static_cast<float>(_tickSum) / _ticks : 0.0f; }
+    uint32_t saturated() const { return _saturated; }
+    uint32_t stolen() const { return _stolen; }
+
+    void resetStats() { _ticks = _tickLast = _tickMax = _tickSum = _saturated = _stolen = 0; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("HapticPlayer: %d voices active, %lu ticks, last %lu us, mean %.2f us, max %lu us, %lu saturated, %lu stolen\n",
+            activeVoices(), _ticks, _tickLast, meanTickMicros(), _tickMax, _saturated, _stolen);
+    }
+};
+
+#endif // HAPTIC_PLAYER_H
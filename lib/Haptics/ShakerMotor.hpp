@@ -0,0 +1,227 @@
+// ShakerMotor.hpp
+#ifndef SHAKER_MOTOR_H
+#define SHAKER_MOTOR_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "LedcAllocator.hpp"
+
+// Above hearing, and low enough for 10-bit LEDC resolution at 80 MHz APB
+constexpr uint32_t SHAKER_PWM_FREQ = 20000;
+constexpr uint8_t SHAKER_PWM_BITS = 10;
+constexpr uint32_t SHAKER_TICK_US = 1000;
+
+/**
+ * @brief Slew-rate limiter for a signed intensity (-4095..4095)
+ *
+ * Pure arithmetic, no hardware: step() moves the output at most `rate`
+ * counts towards the target. A reversal ramps down through zero.
+ */
+struct SlewRamp {
+    int16_t output = 0;
+    int16_t target = 0;
+    uint16_t rate = 4095;           // Counts per step, 0 = jump
+
+    int16_t step() {
+        const int32_t diff = static_cast<int32_t>(target) - output;
+        if (rate == 0 || abs(diff) <= rate) output = target;
+        else output += diff > 0 ? rate : -static_cast<int16_t>(rate);
+        return output;
+    }
+
+    bool settled() const { return output == target; }
+};
+
+/**
+ * @brief DRV8833 H-bridge driving a shaker or gear motor
+ *
+ * IN1/IN2 each get an LEDC channel from LedcAllocator.
+ *   forward  IN1 = PWM, IN2 = 0
+ *   reverse  IN1 = 0,   IN2 = PWM
+ *   coast    IN1 = 0,   IN2 = 0   (outputs Hi-Z, motor freewheels)
+ *   brake    IN1 = 1,   IN2 = 1   (low-side short, motor stops hard)
+ * With Decay::SLOW the idle input is held high and the other one gets the
+ * inverted duty, which gives a more linear speed response.
+ *
+ * setIntensity() only stores a target; a periodic esp_timer slews the
+ * output towards it, so the host can stream commands at any rate and the
+ * motor sees the latest one.
+ */
+class ShakerMotor {
+
+public:
+    enum class Decay : uint8_t { FAST, SLOW };
+
+private:
+    enum Mode : uint8_t { DRIVE, COAST, BRAKE };
+
+    uint8_t _pin1, _pin2;
+    int8_t _chan1, _chan2;
+    Decay _decay;
+    SlewRamp _ramp;
+    volatile int16_t _target;
+    volatile Mode _mode;
+    Mode _applied;
+    int16_t _written;
+    esp_timer_handle_t _timer;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    uint32_t _commands, _ticks, _tickMax;
+
+    static void onTimer(void* arg) { static_cast<ShakerMotor*>(arg)->tick(); }
+
+    static uint32_t scale(uint16_t level) { return level >> (12 - SHAKER_PWM_BITS); }
+
+    void writeBridge(Mode mode, int16_t out) {
+        const uint32_t full = (1u << SHAKER_PWM_BITS) - 1;
+        uint32_t in1 = 0, in2 = 0;
+        if (mode == BRAKE) {
+            in1 = in2 = full;
+        } else if (mode == DRIVE && out != 0) {
+            const uint32_t duty = scale(static_cast<uint16_t>(abs(out)));
+            if (_decay == Decay::FAST) {
+                (out > 0 ? in1 : in2) = duty;
+            } else {
+                in1 = in2 = full;
+                (out > 0 ? in2 : in1) = full - duty;
+            }
+        }
+        ledcWrite(_chan1, in1);
+        ledcWrite(_chan2, in2);
+    }
+
+    void setMode(Mode mode) {
+        portENTER_CRITICAL(&_lock);
+        _mode = mode;
+        _target = 0;
+        portEXIT_CRITICAL(&_lock);
+        _commands++;
+    }
+
+    void tick() {
+        const uint32_t tic = micros();
+        portENTER_CRITICAL(&_lock);
+        const Mode mode = _mode;
+        _ramp.target = _target;
+        portEXIT_CRITICAL(&_lock);
+
+        if (mode == DRIVE) {
+            _ramp.step();
+        } else {
+            _ramp.output = _ramp.target = 0;
+        }
+        if (mode != _applied || _ramp.output != _written) {
+            writeBridge(mode, _ramp.output);
+            _applied = mode;
+            _written = _ramp.output;
+        }
+        _tickMax = max<uint32_t>(_tickMax, micros() - tic);
+        _ticks++;
+    }
+
+public:
+    /**
+     * @param in1 GPIO to DRV8833 AIN1/BIN1
+     * @param in2 GPIO to DRV8833 AIN2/BIN2
+     * @param slewPerMs Largest intensity change per ms (4095 = full scale in 1 ms)
+     */
+    ShakerMotor(uint8_t in1, uint8_t in2, uint16_t slewPerMs = 40, Decay decay = Decay::FAST)
+        : _pin1(in1), _pin2(in2), _chan1(-1), _chan2(-1), _decay(decay), _target(0),
+          _mode(COAST), _applied(COAST), _written(0), _timer(nullptr),
+          _commands(0), _ticks(0), _tickMax(0) {
+        _ramp.rate = slewPerMs;
+    }
+
+    /**
+     * @brief Claim two LEDC channels, attach the pins (coasting) and start
+     * the ramp timer
+     * @return false if no channels are free or the timer cannot be created
+     */
+    bool begin() {
+        if (_timer) return true;
+        _chan1 = LedcAllocator::claim(SHAKER_PWM_FREQ, SHAKER_PWM_BITS);
+        _chan2 = LedcAllocator::claim(SHAKER_PWM_FREQ, SHAKER_PWM_BITS);
+        if (_chan1 < 0 || _chan2 < 0) {
+            Serial.println("ShakerMotor: no free LEDC channels!");
+            end();
+            return false;
+        }
+        ledcSetup(_chan1, SHAKER_PWM_FREQ, SHAKER_PWM_BITS);
+        ledcSetup(_chan2, SHAKER_PWM_FREQ, SHAKER_PWM_BITS);
+        ledcAttachPin(_pin1, _chan1);
+        ledcAttachPin(_pin2, _chan2);
+        writeBridge(COAST, 0);
+
+        esp_timer_create_args_t args = {};
+        args.callback = &ShakerMotor::onTimer;
+        args.arg = this;
+        args.dispatch_method = ESP_TIMER_TASK;
+        args.name = "shaker";
+        if (esp_timer_create(&args, &_timer) != ESP_OK) {
+            Serial.println("ShakerMotor timer create failed!");
+            _timer = nullptr;
+            end();
+            return false;
+        }
+        esp_timer_start_periodic(_timer, SHAKER_TICK_US);
+        Serial.printf("ShakerMotor initialized on Pins %d/%d, Channels %d/%d, 20kHz\n", _pin1, _pin2, _chan1, _chan2);
+        return true;
+    }
+
+    void end() {
+        if (_timer) {
+            esp_timer_stop(_timer);
+            esp_timer_delete(_timer);
+            _timer = nullptr;
+        }
+        if (_chan1 >= 0) { ledcWrite(_chan1, 0); ledcDetachPin(_pin1); LedcAllocator::release(_chan1); }
+        if (_chan2 >= 0) { ledcWrite(_chan2, 0); ledcDetachPin(_pin2); LedcAllocator::release(_chan2); }
+        _chan1 = _chan2 = -1;
+    }
+
+    /**
+     * @brief Ramp towards a signed intensity. Returns immediately.
+     * @param level -4095 (full reverse) to 4095 (full forward)
+     */
+    void setIntensity(int16_t level) {
+        level = constrain(level, -4095, 4095);
+        portENTER_CRITICAL(&_lock);
+        _target = level;
+        _mode = DRIVE;
+        portEXIT_CRITICAL(&_lock);
+        _commands++;
+    }
+
+    void forward(uint16_t level) { setIntensity(static_cast<int16_t>(min<uint16_t>(level, 4095))); }
+    void reverse(uint16_t level) { setIntensity(-static_cast<int16_t>(min<uint16_t>(level, 4095))); }
+
+    /**
+     * @brief Ramp down to zero, then freewheel
+     */
+    void stop() { setIntensity(0); }
+
+    // Applied on the next tick, without a ramp
+    void coast() { setMode(COAST); }
+    void brake() { setMode(BRAKE); }
+
+    void setSlewRate(uint16_t perMs) {
+        portENTER_CRITICAL(&_lock);
+        _ramp.rate = perMs;
+        portEXIT_CRITICAL(&_lock);
+    }
+
+    int16_t getIntensity() const { return _written; }
+    int16_t getTarget() const { return _target; }
+    bool braking() const { return _mode == BRAKE; }
+    bool attached() const { return _timer != nullptr; }
+
+    uint32_t commands() const { return _commands; }
+    uint32_t maxTickMicros() const { return _tickMax; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("ShakerMotor: %d -> %d, %lu commands, %lu ticks, max %lu us per tick\n",
+            _written, _target, _commands, _ticks, _tickMax);
+    }
+};
+
+#endif // SHAKER_MOTOR_H
@@ -3,6 +3,7 @@
 #define SOLENOID_H
 
 #include <Arduino.h>
+#include "LedcAllocator.hpp"
 
 class Solenoid {
 
@@ -21,13 +22,24 @@ public:
      * @param channel LEDC channel (default: 0)
      */
     Solenoid(uint8_t pin = 1, uint8_t channel = 0)
-        : _pin(pin), _chan(channel), _freq(4000), _res(12), _init(false) {}
+        : _pin(pin), _chan(channel), _freq(4000), _res(12), _init(false) {
+        // Keep the wired channel out of reach of LEDs and motors that
+        // begin() before this does
+        LedcAllocator::reserve(_chan, _freq, _res);
+    }
 
     /**
      * @brief Initialize the solenoid driver
      * @return true on success, false on failure
      */
     bool begin() {
+        // Take up the reservation; fails only if the channel was claimed
+        // before this was constructed
+        if (!_init && !LedcAllocator::claim(_chan, _freq, _res)) {
+            Serial.printf("Solenoid LEDC channel %d unavailable!\n", _chan);
+            return false;
+        }
+
         // Configure LEDC timer and channel
         ledcSetup(_chan, _freq, _res);
         ledcAttachPin(_pin, _chan);
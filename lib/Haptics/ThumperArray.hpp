@@ -0,0 +1,203 @@
+// ThumperArray.hpp
+#ifndef THUMPER_ARRAY_H
+#define THUMPER_ARRAY_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "CoilScheduler.hpp"
+
+/**
+ * @brief First-order coil heating parameters
+ *
+ * Heat is normalised so 1.0 is the hottest the coil may get. A fire adds
+ * heatRate * (duty fraction) per second on; the coil cools exponentially
+ * towards ambient with time constant tauS.
+ */
+struct ThermalModel {
+    float heatRate;         // Heat units per second at 100% duty
+    float tauS;             // Cooling time constant (s)
+};
+
+constexpr ThermalModel DEFAULT_THERMAL = {2.0f, 30.0f};
+
+/**
+ * @brief Bank of thumper coils sharing one supply
+ *
+ * Every fire is admitted against three limits:
+ *  - thermal: the predicted heat after the fire must stay <= 1.0. If the full
+ *    pulse does not fit, the hold is shortened (throttled); if even the kick
+ *    does not fit, the fire is refused.
+ *  - concurrency: at most maxActive coils energised at once. A fire that
+ *    would exceed it is pushed back to when a coil frees up, or refused if
+ *    that is further out than maxDeferUs.
+ *  - inrush: fires landing together are staggered by staggerUs each.
+ */
+template<uint8_t N>
+class ThumperArray {
+
+private:
+    CoilScheduler& _sched;
+    uint8_t _coil[N];               // Scheduler index per thumper
+    ThermalModel _thermal[N];
+    float _heat[N];
+    uint32_t _heatTic[N];           // micros() of the last heat update
+    uint32_t _busyFrom[N];          // micros() the current fire kicks
+    uint32_t _busyUntil[N];         // micros() the current fire ends
+    uint8_t _count;
+
+    uint8_t _maxActive;
+    uint32_t _staggerUs;
+    uint32_t _maxDeferUs;
+    uint32_t _lastStart;
+
+    uint32_t _fires, _throttled, _refusedHeat, _refusedBusy, _deferred;
+
+    static bool after(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+    // t lies in (now, now + span]. Unlike after(), an old t never comes
+    // back round as "future" once the array has sat idle past 2^31 us.
+    static bool soon(uint32_t t, uint32_t now, uint32_t span) { return t - now - 1u < span; }
+
+    void cool(uint8_t k, uint32_t now) {
+        const float dt = (now - _heatTic[k]) * 1e-6f;
+        _heat[k] *= expf(-dt / _thermal[k].tauS);
+        _heatTic[k] = now;
+    }
+
+    // Coils energised at time t, other than `skip` (a re-fire replaces itself).
+    // Kick starts are issued in order, so the count at a fire's start is
+    // the most it will overlap for its whole on-time.
+    uint8_t activeAt(uint32_t t, uint8_t skip = N) const {
+        uint8_t n = 0;
+        for (uint8_t k = 0; k < _count; k++) {
+            if (k != skip && !after(_busyFrom[k], t) && after(_busyUntil[k], t)) n++;
+        }
+        return n;
+    }
+
+    // Earliest end of a fire still running at t
+    uint32_t nextFree(uint32_t t, uint8_t skip) const {
+        uint32_t best = t;
+        bool found = false;
+        for (uint8_t k = 0; k < _count; k++) {
+            if (k != skip && after(_busyUntil[k], t) && (!found || after(best, _busyUntil[k]))) {
+                best = _busyUntil[k];
+                found = true;
+            }
+        }
+        return best;
+    }
+
+public:
+    /**
+     * @param scheduler Scheduler the thumper coils are registered with
+     * @param maxActive Coils allowed on at once
+     * @param staggerUs Minimum spacing between kick starts
+     * @param maxDeferUs Longest a fire may be pushed back waiting for a slot
+     */
+    ThumperArray(CoilScheduler& scheduler, uint8_t maxActive = 2,
+                 uint32_t staggerUs = 500, uint32_t maxDeferUs = 30000)
+        : _sched(scheduler), _count(0), _maxActive(max<uint8_t>(maxActive, 1)), _staggerUs(staggerUs),
+          _maxDeferUs(maxDeferUs), _lastStart(0) { resetStats(); }
+
+    /**
+     * @brief Add a coil already registered with the scheduler
+     * @return Thumper index, or -1 if the array is full
+     */
+    int8_t add(uint8_t schedulerCoil, const ThermalModel& model = DEFAULT_THERMAL) {
+        if (_count >= N) return -1;
+        _coil[_count] = schedulerCoil;
+        _thermal[_count] = model;
+        _heat[_count] = 0.0f;
+        _heatTic[_count] = micros();
+        _busyFrom[_count] = _busyUntil[_count] = micros();
+        return static_cast<int8_t>(_count++);
+    }
+
+    /**
+     * @brief Admit and schedule a fire. Returns immediately.
+     * @param onUs Requested on-time, 0 = profile maximum
+     * @param sinceUs micros() when the request arrived, for latency stats
+     * @return false if refused (too hot, or no slot soon enough)
+     */
+    bool fire(uint8_t k, uint32_t onUs = 0, uint32_t sinceUs = micros()) {
+        if (k >= _count) return false;
+        const uint32_t now = micros();
+        const PulseProfile& p = _sched.getProfile(_coil[k]);
+        if (onUs == 0 || onUs > p.maxOnUs) onUs = p.maxOnUs;
+
+        // Thermal admission, on the predicted heat of the whole pulse
+        cool(k, now);
+        const float rate = _thermal[k].heatRate * 1e-6f / 4095.0f;         // per us per duty step
+        const uint32_t kickUs = min(p.kickUs, onUs);
+        const float kickHeat = rate * kickUs * p.kickDuty;
+        const float holdRate = rate * p.holdDuty;
+        const float budget = 1.0f - _heat[k];
+        float heat = kickHeat + holdRate * (onUs - kickUs);
+        if (heat > budget) {
+            if (kickHeat > budget) {
+                _refusedHeat++;
+                return false;
+            }
+            onUs = kickUs + (holdRate > 0 ? static_cast<uint32_t>((budget - kickHeat) / holdRate) : 0);
+            heat = kickHeat + holdRate * (onUs - kickUs);
+            _throttled++;
+        }
+
+        // Stagger against the last kick (at most maxDeferUs ahead of the
+        // fire that queued it), then wait for a free slot
+        uint32_t start = now;
+        if (soon(_lastStart + _staggerUs, now, _staggerUs + _maxDeferUs)) start = _lastStart + _staggerUs;
+        while (activeAt(start, k) >= _maxActive) {
+            start = nextFree(start, k);
+            if (static_cast<uint32_t>(start - now) > _maxDeferUs) {
+                _refusedBusy++;
+                return false;
+            }
+        }
+        if (start != now) _deferred++;
+
+        if (!_sched.fire(_coil[k], onUs, start - now, sinceUs)) return false;
+        _heat[k] += heat;
+        _busyFrom[k] = start;
+        _busyUntil[k] = start + onUs;
+        _lastStart = start;
+        _fires++;
+        return true;
+    }
+
+    void release(uint8_t k) {
+        if (k >= _count) return;
+        _sched.release(_coil[k]);
+        _busyUntil[k] = micros();
+    }
+
+    /**
+     * @brief Current heat of a thumper, 1.0 = limit
+     */
+    float heat(uint8_t k) {
+        if (k >= _count) return 0.0f;
+        cool(k, micros());
+        return _heat[k];
+    }
+
+    uint8_t active() const { return activeAt(micros()); }
+    uint8_t size() const { return _count; }
+
+    uint32_t fires() const { return _fires; }
+    uint32_t throttled() const { return _throttled; }
+    uint32_t refusedHot() const { return _refusedHeat; }
+    uint32_t refusedBusy() const { return _refusedBusy; }
+    uint32_t deferred() const { return _deferred; }
+
+    void resetStats() { _fires = _throttled = _refusedHeat = _refusedBusy = _deferred = 0; }
+
+    void printStats(Stream& stream = Serial) {
+        stream.printf("ThumperArray: %lu fires, %lu throttled, %lu refused hot, %lu refused busy, %lu deferred\n",
+            _fires, _throttled, _refusedHeat, _refusedBusy, _deferred);
+        for (uint8_t k = 0; k < _count; k++) {
+            stream.printf("  thumper %d: heat %.2f\n", k, heat(k));
+        }
+    }
+};
+
+#endif // THUMPER_ARRAY_H
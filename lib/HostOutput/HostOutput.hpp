@@ -0,0 +1,225 @@
+#ifndef HOST_OUTPUT_HPP
+#define HOST_OUTPUT_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <USB.h>
+#include <USBHID.h>
+#include "OutputPort.hpp"
+
+constexpr uint8_t HOST_OUTPUT_REPORT_ID = 0x10;
+constexpr uint8_t HOST_OUTPUT_REPORT_LEN = 63;      // 64-byte packet minus report ID
+constexpr uint8_t HOST_OUTPUT_PORTS = 32;           // LedWiz port count
+constexpr uint16_t HOST_OUTPUT_TIMEOUT_MS = 1000;   // Silence before ports go safe
+
+/****************************************************************************/
+// Output report protocol. Byte 0 selects the command:
+//
+//   CMD_LEDWIZ  [1..8]   One raw 8-byte LedWiz message (SBA or PBA), so DOF's
+//                        LedWiz output driver can be bridged unchanged.
+//   CMD_BATCH   [1]      n pairs follow, then n x (port, level 0..255).
+//                        Up to 30 ports per report, applied together.
+//
+// LedWiz semantics: SBA (first byte 64) switches ports on/off; each PBA
+// carries 8 brightnesses (0..48) for the next bank of 8 ports. A port's
+// output is its brightness while switched on. Waveform codes 129..132 are
+// shown as steady full brightness.
+//
+// Watchdog: update() calls every port's timeout() once the host has been
+// silent for the timeout, so a host that crashes or unplugs with a coil
+// switched on cannot leave it energised. Ports that are safe to hold (LEDs)
+// ignore it.
+class HostOutputProtocol {
+
+public:
+    enum Command : uint8_t { CMD_LEDWIZ = 0x01, CMD_BATCH = 0x02 };
+    static constexpr uint8_t MAX_BATCH = (HOST_OUTPUT_REPORT_LEN - 2) / 2;
+
+private:
+    OutputPort* _ports[HOST_OUTPUT_PORTS] = {};
+    uint8_t _level[HOST_OUTPUT_PORTS] = {};         // Last level written
+    uint8_t _profile[HOST_OUTPUT_PORTS] = {};       // LedWiz brightness 0..48 / waveform
+    uint32_t _switches = 0;                         // LedWiz on/off bits
+    uint8_t _bank = 0;                              // Next PBA bank
+
+    uint16_t _timeoutMs = HOST_OUTPUT_TIMEOUT_MS;
+    volatile uint32_t _lastReport = 0;              // millis() of the last report
+    volatile bool _live = false;                    // Reports seen since the last timeout
+    uint32_t _received = 0;                         // micros() the report being applied arrived
+
+    uint32_t _reports = 0;
+    uint32_t _updates = 0;
+    uint32_t _timeouts = 0;
+    uint32_t _lastLatency = 0;                      // us, report receipt -> ports set
+    uint32_t _maxLatency = 0;
+
+    void write(uint8_t port, uint8_t level) {
+        if (port >= HOST_OUTPUT_PORTS) { return; }
+        _level[port] = level;
+        if (_ports[port]) { _ports[port]->set(level, _received); }
+        _updates++;
+    }
+
+    static uint8_t ledwizLevel(uint8_t profile) {
+        if (profile <= 48) { return static_cast<uint8_t>((profile * 255u) / 48); }
+        if (profile == 49) { return 255; }          // Some hosts send 49 for 100%
+        if (profile >= 129 && profile <= 132) { return 255; }
+        return 0;
+    }
+
+    void applyLedWiz(const uint8_t* msg) {
+        if (msg[0] == 64) {                          // SBA
+            _switches = msg[1] | (msg[2] << 8) | (msg[3] << 16) | (static_cast<uint32_t>(msg[4]) << 24);
+            _bank = 0;
+            for (uint8_t k = 0; k < HOST_OUTPUT_PORTS; k++) {
+                write(k, (_switches >> k) & 1 ? ledwizLevel(_profile[k]) : 0);
+            }
+        } else {                                     // PBA for the next bank of 8
+            const uint8_t first = _bank * 8;
+            for (uint8_t k = 0; k < 8; k++) {
+                const uint8_t port = first + k;
+                _profile[port] = msg[k];
+                write(port, (_switches >> port) & 1 ? ledwizLevel(msg[k]) : 0);
+            }
+            _bank = (_bank + 1) % (HOST_OUTPUT_PORTS / 8);
+        }
+    }
+
+public:
+
+    bool attach(uint8_t port, OutputPort& output) {
+        if (port >= HOST_OUTPUT_PORTS) { return false; }
+        _ports[port] = &output;
+        return true;
+    }
+
+    // Silence before the watchdog trips, 0 = never
+    void setTimeout(uint16_t ms) { _timeoutMs = ms; }
+
+    /**
+     * @brief Decode and apply one report in place
+     * @param receivedUs micros() when the report arrived; latency is
+     * measured from here. Coil ports pass it on, so the CoilScheduler's
+     * latency stats run from receipt to the coil energising.
+     * @return false for malformed input
+     */
+    bool apply(const uint8_t* report, uint16_t len, uint32_t receivedUs = micros()) {
+        if (len < 1) { return false; }
+        _received = receivedUs;
+        switch (report[0]) {
+            case CMD_LEDWIZ:
+                if (len < 9) { return false; }
+                applyLedWiz(report + 1);
+                break;
+            case CMD_BATCH: {
+                if (len < 2) { return false; }
+                const uint8_t n = min<uint8_t>(report[1], MAX_BATCH);
+                if (len < 2 + 2 * n) { return false; }
+                for (uint8_t k = 0; k < n; k++) { write(report[2 + 2 * k], report[3 + 2 * k]); }
+                break;
+            }
+            default:
+                return false;
+        }
+        _reports++;
+        _lastReport = millis();
+        _live = true;
+        _lastLatency = micros() - receivedUs;
+        if (_lastLatency > _maxLatency) { _maxLatency = _lastLatency; }
+        return true;
+    }
+
+    // From the main loop: retries deferred port work and runs the watchdog
+    void update(uint32_t nowMs = millis()) {
+        for (uint8_t k = 0; k < HOST_OUTPUT_PORTS; k++) {
+            if (_ports[k]) { _ports[k]->update(); }
+        }
+        if (!_live || !_timeoutMs || nowMs - _lastReport < _timeoutMs) { return; }
+        _live = false;
+        _timeouts++;
+        for (uint8_t k = 0; k < HOST_OUTPUT_PORTS; k++) {
+            if (_ports[k]) { _ports[k]->timeout(); }
+        }
+    }
+
+    uint8_t level(uint8_t port) const { return port < HOST_OUTPUT_PORTS ? _level[port] : 0; }
+
+    // Throughput/latency counters, for on-target measurement
+    uint32_t reports() const { return _reports; }
+    uint32_t updates() const { return _updates; }
+    uint32_t timeouts() const { return _timeouts; }
+    uint32_t lastLatencyMicros() const { return _lastLatency; }
+    uint32_t maxLatencyMicros() const { return _maxLatency; }
+    void resetStats() { _reports = _updates = _timeouts = _maxLatency = 0; }
+};
+/****************************************************************************/
+// Vendor-defined HID interface carrying the protocol above. Output reports
+// are applied directly in the USB task callback, so outputs change within
+// the same USB frame the report arrived in. Call update() from the loop
+// for the watchdog.
+class HostOutputHID : public USBHIDDevice {
+
+private:
+    USBHID _hid;
+    HostOutputProtocol _protocol;
+    uint32_t _statsTic = 0;
+    uint32_t _statsUpdates = 0;
+
+    static constexpr uint8_t DESCRIPTOR[] = {
+        0x06, 0x00, 0xFF,                       // Usage Page (Vendor 0xFF00)
+        0x09, 0x01,                             // Usage (1)
+        0xA1, 0x01,                             // Collection (Application)
+        0x85, HOST_OUTPUT_REPORT_ID,            //   Report ID
+        0x15, 0x00,                             //   Logical Minimum (0)
+        0x26, 0xFF, 0x00,                       //   Logical Maximum (255)
+        0x75, 0x08,                             //   Report Size (8)
+        0x95, HOST_OUTPUT_REPORT_LEN,           //   Report Count
+        0x09, 0x02,                             //   Usage (2)
+        0x91, 0x02,                             //   Output (Data, Var, Abs)
+        0xC0                                    // End Collection
+    };
+
+public:
+
+    HostOutputHID() {
+        static bool initialized = false;
+        if (!initialized) {
+            initialized = true;
+            _hid.addDevice(this, sizeof(DESCRIPTOR));
+        }
+    }
+
+    void begin() {
+        _hid.begin();
+        USB.begin();
+    }
+
+    HostOutputProtocol& protocol() { return _protocol; }
+    bool attach(uint8_t port, OutputPort& output) { return _protocol.attach(port, output); }
+
+    uint16_t _onGetDescriptor(uint8_t* buffer) override {
+        memcpy(buffer, DESCRIPTOR, sizeof(DESCRIPTOR));
+        return sizeof(DESCRIPTOR);
+    }
+
+    void _onOutput(uint8_t report_id, const uint8_t* buffer, uint16_t len) override {
+        const uint32_t received = micros();
+        if (report_id == HOST_OUTPUT_REPORT_ID) { _protocol.apply(buffer, len, received); }
+    }
+
+    void update() { _protocol.update(); }
+
+    // Prints updates/s since the last call plus receipt-to-output latency
+    void printStats(Stream& stream = Serial) {
+        const uint32_t now = millis();
+        const uint32_t updates = _protocol.updates();
+        const uint32_t dt = now - _statsTic;
+        stream.printf("HostOutput: %lu reports, %lu updates/s, latency last %lu us, max %lu us, %lu timeouts\n",
+            _protocol.reports(), dt ? (updates - _statsUpdates) * 1000 / dt : 0,
+            _protocol.lastLatencyMicros(), _protocol.maxLatencyMicros(), _protocol.timeouts());
+        _statsTic = now;
+        _statsUpdates = updates;
+    }
+};
+/****************************************************************************/
+#endif
@@ -0,0 +1,137 @@
+#ifndef OUTPUT_PORT_HPP
+#define OUTPUT_PORT_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "CoilScheduler.hpp"
+#include "ThumperArray.hpp"
+#include "PowerArbiter.hpp"
+#include "FadeLED.hpp"
+
+/****************************************************************************/
+// One host-addressable output (LedWiz/DOF "port"). Levels are 0..255.
+// set() must be safe to call from the USB task and must not allocate or
+// block. receivedUs is micros() when the report carrying the level arrived.
+class OutputPort {
+public:
+    virtual void set(uint8_t level, uint32_t receivedUs) = 0;
+    // From HostOutputProtocol::update(), on the main loop
+    virtual void update() {}
+    // The host stopped sending reports: drop to the safe state
+    virtual void timeout() {}
+    virtual ~OutputPort() = default;
+};
+/****************************************************************************/
+// Coil on the CoilScheduler. The level is a request, never a duty: any
+// non-zero level fires the coil through its profile (kick, hold, released
+// after maxOnUs at the latest), zero releases it. Holding a level does not
+// re-fire; the host has to send zero first.
+//
+// With a PowerArbiter attached, a fire that does not fit the budget stays
+// pending and update() retries it while the level is still up.
+class CoilPort : public OutputPort {
+private:
+    CoilScheduler& _coils;
+    uint8_t _coil;
+    PowerArbiter* _power = nullptr;
+    uint8_t _powerCoil = 0;
+    volatile bool _on = false;
+    volatile bool _pending = false;
+    volatile uint32_t _since = 0;
+    portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+
+    // set() (USB task) and update() (loop) both get here; only one of them
+    // takes the pending fire
+    void tryFire() {
+        portENTER_CRITICAL(&_lock);
+        const bool go = _pending && _on;
+        _pending = false;
+        portEXIT_CRITICAL(&_lock);
+        if (!go) { return; }
+        if (_power && !_power->admit(_powerCoil, _coils.getProfile(_coil).kickUs)) {
+            _pending = true;
+            return;
+        }
+        _coils.fire(_coil, 0, 0, _since);
+    }
+
+public:
+    CoilPort(CoilScheduler& coils, uint8_t coil) : _coils(coils), _coil(coil) {}
+
+    // Index of the same coil in the arbiter (PowerArbiter::addCoil)
+    void attachPower(PowerArbiter& power, uint8_t powerCoil) {
+        _power = &power;
+        _powerCoil = powerCoil;
+    }
+
+    void set(uint8_t level, uint32_t receivedUs) override {
+        const bool on = level != 0;
+        if (on == _on) { return; }
+        _on = on;
+        if (on) {
+            _since = receivedUs;
+            _pending = true;
+            tryFire();
+        } else {
+            _pending = false;
+            _coils.release(_coil);
+        }
+    }
+
+    void update() override {
+        if (_pending) { tryFire(); }
+    }
+
+    void timeout() override {
+        _on = _pending = false;
+        _coils.release(_coil);
+    }
+
+    bool pending() const { return _pending; }
+};
+/****************************************************************************/
+// Thumper in a ThumperArray, so host fires go through its thermal,
+// concurrency and stagger limits. Same on/off semantics as CoilPort.
+template<uint8_t N>
+class ThumperPort : public OutputPort {
+private:
+    ThumperArray<N>& _array;
+    uint8_t _thumper;
+    volatile bool _on = false;
+
+public:
+    ThumperPort(ThumperArray<N>& array, uint8_t thumper) : _array(array), _thumper(thumper) {}
+
+    void set(uint8_t level, uint32_t receivedUs) override {
+        const bool on = level != 0;
+        if (on == _on) { return; }
+        _on = on;
+        if (on) { _array.fire(_thumper, 0, receivedUs); } else { _array.release(_thumper); }
+    }
+
+    void timeout() override {
+        _on = false;
+        _array.release(_thumper);
+    }
+};
+/****************************************************************************/
+// Single LED channel on LEDC, gamma corrected
+class LedPort : public OutputPort {
+private:
+    FadeLED& _led;
+public:
+    explicit LedPort(FadeLED& led) : _led(led) {}
+    void set(uint8_t level, uint32_t) override { _led.set(GAMMA12[level]); }
+};
+/****************************************************************************/
+// Writes into a 12-bit frame buffer channel (TLC5947 bank, strips), which
+// the owner pushes out on its next frame
+class FramePort : public OutputPort {
+private:
+    uint16_t& _level;
+public:
+    explicit FramePort(uint16_t& level) : _level(level) {}
+    void set(uint8_t level, uint32_t) override { _level = GAMMA12[level]; }
+};
+/****************************************************************************/
+#endif
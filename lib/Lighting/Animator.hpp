@@ -0,0 +1,110 @@
+#ifndef ANIMATOR_HPP
+#define ANIMATOR_HPP
+
+#pragma once
+#include "Keyframes.hpp"
+#include "PowerArbiter.hpp"
+
+/****************************************************************************/
+// Fixed-rate evaluator for a bank of LEDs (buttons + exterior strips).
+// Each tick evaluates every playing track in fixed point, gamma corrects
+// through the flash LUT and leaves 12-bit levels in a static frame buffer.
+template<size_t MaxLEDs>
+class Animator {
+
+private:
+    EffectPlayer _players[MaxLEDs];
+    RGB12 _frame[MaxLEDs];
+    uint16_t _scale = Q8_ONE;       // Q8 output scale, e.g. from a power limiter
+    PowerArbiter* _power = nullptr;  // Sets _scale from each frame's own demand
+    uint8_t _powerGroup = 0;
+    uint32_t _demand = 0;           // Level sum of the latest frame before scaling
+    uint32_t _lastTick = 0;
+    uint32_t _frameCount = 0;
+    uint32_t _lastMicros = 0;       // Evaluation cost of the latest frame
+    uint32_t _maxMicros = 0;
+
+public:
+
+    Animator() { clear(); }
+
+    void play(size_t led, const Effect& fx, uint32_t nowMs, uint16_t phaseMs = 0) {
+        if (led < MaxLEDs) { _players[led].play(fx, nowMs, phaseMs); }
+    }
+
+    // Same effect across a run of LEDs, phase-stepped for chase patterns
+    void playRange(size_t first, size_t count, const Effect& fx, uint32_t nowMs, uint16_t phaseStepMs = 0) {
+        for (size_t k = 0; k < count && first + k < MaxLEDs; k++) {
+            _players[first + k].play(fx, nowMs, static_cast<uint16_t>(k * phaseStepMs));
+        }
+    }
+
+    void stop(size_t led) {
+        if (led < MaxLEDs) { _players[led].stop(); _frame[led] = RGB12{0, 0, 0}; }
+    }
+
+    void clear() {
+        for (size_t k = 0; k < MaxLEDs; k++) { _players[k].stop(); _frame[k] = RGB12{0, 0, 0}; }
+    }
+
+    // Call from loop(); renders at most one frame per LED_FRAME_MS.
+    // Returns true when a new frame is ready in frame().
+    bool update(uint32_t nowMs = millis()) {
+        if (nowMs - _lastTick < LED_FRAME_MS) { return false; }
+        _lastTick = nowMs;
+        render(nowMs);
+        return true;
+    }
+
+    // Evaluate, then scale: with a PowerArbiter attached the scale comes
+    // from this frame's demand, before anything is written out
+    void render(uint32_t nowMs) {
+        const uint32_t tic = micros();
+        uint32_t demand = 0;
+        for (size_t k = 0; k < MaxLEDs; k++) {
+            if (_players[k].playing()) {
+                _frame[k] = gammaCorrect(_players[k].evaluate(nowMs));
+                demand += _frame[k].r + _frame[k].g + _frame[k].b;
+            }
+        }
+        _demand = demand;
+        if (_power) { _scale = _power->scaleFrame(_powerGroup, demand); }
+        if (_scale < Q8_ONE) {
+            for (size_t k = 0; k < MaxLEDs; k++) {
+                if (!_players[k].playing()) { continue; }
+                RGB12& c = _frame[k];
+                c = RGB12{uint16_t((c.r * _scale) >> 8), uint16_t((c.g * _scale) >> 8), uint16_t((c.b * _scale) >> 8)};
+            }
+        }
+        _lastMicros = micros() - tic;
+        if (_lastMicros > _maxMicros) { _maxMicros = _lastMicros; }
+        _frameCount++;
+    }
+
+    void setScale(uint16_t q8) { _scale = min<uint16_t>(q8, Q8_ONE); }
+    uint16_t scale() const { return _scale; }
+
+    // Let the arbiter scale every frame as group `group` (PowerArbiter::addLeds)
+    void attachPower(PowerArbiter& power, uint8_t group) {
+        _power = &power;
+        _powerGroup = group;
+    }
+    uint32_t demand() const { return _demand; }
+
+    const RGB12* frame() const { return _frame; }
+    const RGB12& operator[](size_t led) const { return _frame[led]; }
+    static constexpr size_t size() { return MaxLEDs; }
+
+    // Per-frame cost, for benchmarking on target
+    uint32_t lastFrameMicros() const { return _lastMicros; }
+    uint32_t maxFrameMicros() const { return _maxMicros; }
+    uint32_t frameCount() const { return _frameCount; }
+    void resetStats() { _maxMicros = 0; _frameCount = 0; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("Animator: %u LEDs, %lu frames, last %lu us, max %lu us\n",
+            static_cast<unsigned>(MaxLEDs), _frameCount, _lastMicros, _maxMicros);
+    }
+};
+/****************************************************************************/
+#endif
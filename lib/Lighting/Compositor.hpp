@@ -0,0 +1,135 @@
+#ifndef COMPOSITOR_HPP
+#define COMPOSITOR_HPP
+
+#pragma once
+#include "Animator.hpp"
+
+/****************************************************************************/
+// Layered frame renderer for the exterior strips:
+//   1. base      - keyframe effects from an Animator
+//   2. flash     - additive event overlay (e.g. bumper hit) decaying to zero
+//   3. limiter   - master brightness and a current cap for the 12 V rail
+// Everything is rendered in 12-bit linear space into a static frame buffer.
+template<size_t Count>
+class Compositor {
+
+private:
+    struct Flash {
+        RGB12 color;
+        uint32_t start;
+        uint16_t decay;                 // ms to fade out
+        uint16_t first, count;
+        bool active;
+    };
+
+    Animator<Count> _base;
+    Flash _flash = {};
+    RGB12 _frame[Count];
+    uint16_t _brightness = Q8_ONE;      // Q8 master brightness
+    uint32_t _maxLoad = 0;              // Sum of channel levels allowed, 0 = no cap
+    uint16_t _powerScale = Q8_ONE;      // Q8 cap from the system power arbiter
+    PowerArbiter* _power = nullptr;
+    uint8_t _powerGroup = 0;
+    uint16_t _scale = Q8_ONE;           // Q8 scale applied by the limiter last frame
+    uint32_t _demand = 0;               // Level sum after brightness, before capping
+    uint32_t _lastTick = 0;
+    uint32_t _lastMicros = 0;
+
+public:
+
+    Compositor() {
+        for (size_t k = 0; k < Count; k++) { _frame[k] = RGB12{0, 0, 0}; }
+    }
+
+    Animator<Count>& base() { return _base; }
+
+    // Overlay a colour over [first, first+count) that fades out in decayMs
+    void flash(const RGB& color, uint16_t decayMs, uint32_t nowMs = millis(),
+               size_t first = 0, size_t count = Count) {
+        if (first >= Count) { return; }
+        _flash.color = gammaCorrect(color);
+        _flash.start = nowMs;
+        _flash.decay = decayMs ? decayMs : 1;
+        _flash.first = static_cast<uint16_t>(first);
+        _flash.count = static_cast<uint16_t>(min(count, Count - first));
+        _flash.active = true;
+    }
+
+    void setBrightness(uint8_t level) { _brightness = level + (level >> 7); }    // 255 -> 256
+
+    // Cap the summed draw. mAPerChannel is the current of one fully-on
+    // colour channel (about 20 mA for WS2812).
+    void setCurrentLimit(uint16_t mA, uint8_t mAPerChannel = 20) {
+        _maxLoad = mA ? static_cast<uint32_t>(mA) * LEVEL_MAX / mAPerChannel : 0;
+    }
+
+    // Extra scale imposed from outside, applied with the cap
+    void setPowerScale(uint16_t q8) { _powerScale = min<uint16_t>(q8, Q8_ONE); }
+
+    // Let the arbiter set the power scale from each frame's own (capped)
+    // demand, as group `group` (PowerArbiter::addLeds)
+    void attachPower(PowerArbiter& power, uint8_t group) {
+        _power = &power;
+        _powerGroup = group;
+    }
+
+    // Fixed-rate, like Animator::update(). True when frame() is fresh.
+    bool update(uint32_t nowMs = millis()) {
+        if (nowMs - _lastTick < LED_FRAME_MS) { return false; }
+        _lastTick = nowMs;
+        render(nowMs);
+        return true;
+    }
+
+    void render(uint32_t nowMs) {
+        const uint32_t tic = micros();
+        _base.render(nowMs);
+        const RGB12* src = _base.frame();
+        for (size_t k = 0; k < Count; k++) { _frame[k] = src[k]; }
+
+        if (_flash.active) {
+            const uint32_t age = nowMs - _flash.start;
+            if (age >= _flash.decay) {
+                _flash.active = false;
+            } else {
+                const uint32_t w = ((_flash.decay - age) << 8) / _flash.decay;      // Q8, linear
+                const uint16_t r = (_flash.color.r * w) >> 8;
+                const uint16_t g = (_flash.color.g * w) >> 8;
+                const uint16_t b = (_flash.color.b * w) >> 8;
+                for (size_t k = _flash.first; k < _flash.first + _flash.count; k++) {
+                    _frame[k].r = min<uint32_t>(_frame[k].r + r, LEVEL_MAX);
+                    _frame[k].g = min<uint32_t>(_frame[k].g + g, LEVEL_MAX);
+                    _frame[k].b = min<uint32_t>(_frame[k].b + b, LEVEL_MAX);
+                }
+            }
+        }
+
+        // Limiter: one pass to measure, one pass to scale
+        uint32_t load = 0;
+        for (size_t k = 0; k < Count; k++) { load += _frame[k].r + _frame[k].g + _frame[k].b; }
+        load = (load * _brightness) >> 8;
+        _demand = load;
+        _scale = _brightness;
+        if (_maxLoad && load > _maxLoad) {
+            _scale = static_cast<uint16_t>((static_cast<uint64_t>(_brightness) * _maxLoad) / load);
+        }
+        if (_power) { _powerScale = _power->scaleFrame(_powerGroup, _maxLoad ? min(load, _maxLoad) : load); }
+        _scale = (_scale * _powerScale) >> 8;
+        if (_scale < Q8_ONE) {
+            for (size_t k = 0; k < Count; k++) {
+                _frame[k].r = (_frame[k].r * _scale) >> 8;
+                _frame[k].g = (_frame[k].g * _scale) >> 8;
+                _frame[k].b = (_frame[k].b * _scale) >> 8;
+            }
+        }
+        _lastMicros = micros() - tic;
+    }
+
+    const RGB12* frame() const { return _frame; }
+    uint16_t limiterScale() const { return _scale; }
+    uint32_t demand() const { return _demand; }
+    uint32_t lastFrameMicros() const { return _lastMicros; }
+    static constexpr size_t size() { return Count; }
+};
+/****************************************************************************/
+#endif
@@ -0,0 +1,73 @@
+#ifndef EFFECTS_HPP
+#define EFFECTS_HPP
+
+#pragma once
+#include "Keyframes.hpp"
+
+/****************************************************************************/
+// Built-in effect tables. Everything here is constexpr, so the tracks live
+// in flash and adding an effect is a data change, not a code change.
+namespace Effects {
+
+inline constexpr RGB BLACK   = {0, 0, 0};
+inline constexpr RGB RED     = {255, 0, 0};
+inline constexpr RGB GREEN   = {0, 255, 0};
+inline constexpr RGB BLUE    = {0, 0, 255};
+inline constexpr RGB YELLOW  = {255, 255, 0};
+inline constexpr RGB MAGENTA = {255, 0, 255};
+inline constexpr RGB CYAN    = {0, 255, 255};
+inline constexpr RGB WHITE   = {255, 255, 255};
+
+// Palettes stepped by press-driven modes
+inline constexpr RGB CYCLE_PALETTE[]   = {BLACK, RED, GREEN, BLUE, YELLOW, MAGENTA, CYAN};
+inline constexpr RGB RAINBOW_PALETTE[] = {RED, YELLOW, GREEN, CYAN, BLUE, MAGENTA};
+inline constexpr RGB RANDOM_PALETTE[]  = {RED, GREEN, BLUE, YELLOW, MAGENTA, CYAN, WHITE};
+
+template<size_t K>
+constexpr size_t paletteSize(const RGB (&)[K]) { return K; }
+
+/****************************************************************************/
+inline constexpr Keyframe OFF_KEYS[]   = {{0, BLACK, Ease::STEP}};
+inline constexpr Keyframe RED_KEYS[]   = {{0, RED,   Ease::STEP}};
+inline constexpr Keyframe GREEN_KEYS[] = {{0, GREEN, Ease::STEP}};
+inline constexpr Keyframe BLUE_KEYS[]  = {{0, BLUE,  Ease::STEP}};
+
+inline constexpr Keyframe PULSE_RED_KEYS[]   = {{0, RED,   Ease::STEP}, {500, BLACK, Ease::STEP}};
+inline constexpr Keyframe PULSE_GREEN_KEYS[] = {{0, GREEN, Ease::STEP}, {500, BLACK, Ease::STEP}};
+inline constexpr Keyframe PULSE_BLUE_KEYS[]  = {{0, BLUE,  Ease::STEP}, {500, BLACK, Ease::STEP}};
+
+inline constexpr Keyframe BREATHE_KEYS[] = {
+    {0,    RED,     Ease::IN_OUT},
+    {1000, YELLOW,  Ease::IN_OUT},
+    {2000, GREEN,   Ease::IN_OUT},
+    {3000, CYAN,    Ease::IN_OUT},
+    {4000, BLUE,    Ease::IN_OUT},
+    {5000, MAGENTA, Ease::IN_OUT}
+};
+
+inline constexpr Keyframe CHASE_KEYS[] = {
+    {0,    RED,   Ease::OUT},
+    {1000, GREEN, Ease::OUT},
+    {2000, BLUE,  Ease::OUT}
+};
+
+inline constexpr Keyframe FLASH_KEYS[] = {
+    {0,   WHITE, Ease::OUT},
+    {250, BLACK, Ease::STEP}
+};
+
+/****************************************************************************/
+inline constexpr Effect OFF         = makeEffect(OFF_KEYS);
+inline constexpr Effect SOLID_RED   = makeEffect(RED_KEYS);
+inline constexpr Effect SOLID_GREEN = makeEffect(GREEN_KEYS);
+inline constexpr Effect SOLID_BLUE  = makeEffect(BLUE_KEYS);
+inline constexpr Effect PULSE_RED   = makeEffect(PULSE_RED_KEYS, 1000);
+inline constexpr Effect PULSE_GREEN = makeEffect(PULSE_GREEN_KEYS, 1000);
+inline constexpr Effect PULSE_BLUE  = makeEffect(PULSE_BLUE_KEYS, 1000);
+inline constexpr Effect BREATHING_RAINBOW = makeEffect(BREATHE_KEYS, 6000);
+inline constexpr Effect CHASE       = makeEffect(CHASE_KEYS, 3000);
+inline constexpr Effect FLASH       = makeEffect(FLASH_KEYS);
+
+} // namespace Effects
+/****************************************************************************/
+#endif
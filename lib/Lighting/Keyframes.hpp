@@ -0,0 +1,116 @@
+#ifndef KEYFRAMES_HPP
+#define KEYFRAMES_HPP
+
+#pragma once
+#include "Color.hpp"
+
+constexpr uint16_t LED_FRAME_MS = 20;           // Fixed 50 fps animation tick
+constexpr uint16_t Q8_ONE = 256;                // Fixed-point 1.0 for blends
+
+/****************************************************************************/
+// Easing applied over the segment *leaving* a keyframe
+enum class Ease : uint8_t {
+    STEP,           // Hold colour until the next keyframe
+    LINEAR,
+    IN,             // Quadratic ease-in
+    OUT,            // Quadratic ease-out
+    IN_OUT          // Smoothstep
+};
+
+struct Keyframe {
+    uint16_t time;                  // ms from start of effect
+    RGB color;
+    Ease ease;
+};
+
+// An effect is a const keyframe track. Tracks loop every `period` ms;
+// a period of 0 plays once and holds the last keyframe.
+struct Effect {
+    const Keyframe* frames;
+    uint8_t count;
+    uint16_t period;
+};
+
+template<size_t K>
+constexpr Effect makeEffect(const Keyframe (&frames)[K], uint16_t period = 0) {
+    static_assert(K >= 1 && K <= 255, "Effect needs 1..255 keyframes");
+    return Effect{frames, static_cast<uint8_t>(K), period};
+}
+/****************************************************************************/
+// Q8 easing, 0..256 in -> 0..256 out
+constexpr uint16_t easeQ8(uint16_t f, Ease ease) {
+    switch (ease) {
+        case Ease::STEP:   return 0;
+        case Ease::LINEAR: return f;
+        case Ease::IN:     return (f * f) >> 8;
+        case Ease::OUT:    return Q8_ONE - (((Q8_ONE - f) * (Q8_ONE - f)) >> 8);
+        case Ease::IN_OUT: return (static_cast<uint32_t>(f) * f * (3 * Q8_ONE - 2 * f)) >> 16;
+    }
+    return f;
+}
+
+constexpr uint8_t lerpQ8(uint8_t a, uint8_t b, uint16_t w) {
+    return static_cast<uint8_t>(a + (((static_cast<int16_t>(b) - a) * static_cast<int32_t>(w)) >> 8));
+}
+/****************************************************************************/
+// Plays one effect for one LED. Keeps a segment cursor so evaluation is
+// O(1) per frame for monotonic time instead of a search over the track.
+class EffectPlayer {
+
+private:
+    const Effect* _fx = nullptr;
+    uint32_t _start = 0;
+    uint8_t _cursor = 0;
+    uint16_t _last = 0;
+
+public:
+
+    void play(const Effect& fx, uint32_t nowMs, uint16_t phaseMs = 0) {
+        _fx = &fx;
+        _start = nowMs - phaseMs;
+        _cursor = 0;
+        _last = 0;
+    }
+
+    void stop() { _fx = nullptr; }
+    bool playing() const { return _fx != nullptr; }
+    const Effect* effect() const { return _fx; }
+
+    RGB evaluate(uint32_t nowMs) {
+        if (!_fx) { return RGB{0, 0, 0}; }
+        const Keyframe* k = _fx->frames;
+        const uint8_t n = _fx->count;
+
+        uint32_t elapsed = nowMs - _start;
+        uint16_t t;
+        if (_fx->period) {
+            t = static_cast<uint16_t>(elapsed % _fx->period);
+        } else {
+            t = static_cast<uint16_t>(elapsed > k[n - 1].time ? k[n - 1].time : elapsed);
+        }
+        if (t < _last) { _cursor = 0; }                 // Wrapped
+        _last = t;
+
+        while (_cursor + 1 < n && k[_cursor + 1].time <= t) { _cursor++; }
+
+        const Keyframe& a = k[_cursor];
+        if (t < a.time) { return k[0].color; }          // Before first key
+        // Last key blends back into the first across the loop seam
+        const bool seam = (_cursor + 1 == n);
+        if (seam && !_fx->period) { return a.color; }
+        const Keyframe& b = seam ? k[0] : k[_cursor + 1];
+        const uint16_t t1 = seam ? _fx->period + b.time : b.time;
+        const uint16_t span = t1 - a.time;
+        if (span == 0 || a.ease == Ease::STEP) { return a.color; }
+
+        const uint16_t f = static_cast<uint16_t>((static_cast<uint32_t>(t - a.time) << 8) / span);
+        const uint16_t w = easeQ8(f, a.ease);
+        return RGB{
+            lerpQ8(a.color.r, b.color.r, w),
+            lerpQ8(a.color.g, b.color.g, w),
+            lerpQ8(a.color.b, b.color.b, w)
+        };
+    }
+};
+/****************************************************************************/
+#endif
@@ -0,0 +1,133 @@
+#ifndef LEDSTRIP_HPP
+#define LEDSTRIP_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include "Color.hpp"
+
+/****************************************************************************/
+// WS2812 / SK6812 waveform encoding for the RMT peripheral.
+// RMT runs from the 80 MHz APB clock divided by 2, i.e. 25 ns per tick.
+// Each data bit becomes one 32-bit RMT item: {high ticks, low ticks}.
+namespace StripTiming {
+    constexpr uint8_t CLK_DIV = 2;
+    constexpr uint16_t NS_PER_TICK = 25;
+    constexpr uint16_t ticks(uint16_t ns) { return (ns + NS_PER_TICK / 2) / NS_PER_TICK; }
+
+    constexpr uint16_t T0H = ticks(400);        // 0-bit: 0.40 us high, 0.85 us low
+    constexpr uint16_t T0L = ticks(850);
+    constexpr uint16_t T1H = ticks(800);        // 1-bit: 0.80 us high, 0.45 us low
+    constexpr uint16_t T1L = ticks(450);
+    constexpr uint16_t RESET_US = 80;           // SK6812 latch; WS2812 needs 50
+
+    constexpr uint16_t BIT_NS = (T0H + T0L) * NS_PER_TICK;
+
+    // Same bit layout as rmt_item32_t: duration0:15, level0:1, duration1:15, level1:1
+    constexpr uint32_t item(uint16_t high, uint16_t low) {
+        return (static_cast<uint32_t>(high) & 0x7FFF) | (1u << 15) | ((static_cast<uint32_t>(low) & 0x7FFF) << 16);
+    }
+    constexpr uint32_t BIT0 = item(T0H, T0L);
+    constexpr uint32_t BIT1 = item(T1H, T1L);
+
+    // MSB first, one item per bit. Returns items written.
+    inline size_t encode(const uint8_t* bytes, size_t count, uint32_t* items) {
+        uint32_t* out = items;
+        for (size_t k = 0; k < count; k++) {
+            const uint8_t v = bytes[k];
+            for (uint8_t b = 0x80; b; b >>= 1) { *out++ = (v & b) ? BIT1 : BIT0; }
+        }
+        return out - items;
+    }
+
+    // Stretch the final low period into the latch gap, so back-to-back
+    // frames cannot run into each other
+    constexpr uint16_t RESET_TICKS = RESET_US * 1000u / NS_PER_TICK;
+    inline void terminate(uint32_t* items, size_t count) {
+        if (count) { items[count - 1] = item(items[count - 1] & 0x7FFF, RESET_TICKS); }
+    }
+}
+
+enum class StripType : uint8_t {
+    WS2812_GRB,         // 3 bytes per pixel
+    SK6812_GRBW         // 4 bytes per pixel, white derived from min(r, g, b)
+};
+
+/****************************************************************************/
+// Addressable strip on one RMT channel. All buffers are static and sized
+// by the template, so show() never allocates. The RMT peripheral clocks
+// the waveform out on its own; the CPU only encodes and refills RMT RAM.
+template<size_t Count, StripType Type = StripType::WS2812_GRB>
+class LedStrip {
+
+public:
+    static constexpr size_t BYTES_PER_LED = (Type == StripType::SK6812_GRBW) ? 4 : 3;
+    static constexpr size_t ITEMS = Count * BYTES_PER_LED * 8;
+
+private:
+    uint8_t _pin;
+    rmt_channel_t _chan;
+    bool _init = false;
+    uint8_t _bytes[Count * BYTES_PER_LED];
+    uint32_t _items[ITEMS];
+    uint32_t _renderMicros = 0;
+
+public:
+
+    LedStrip(uint8_t pin, uint8_t rmtChannel = 0)
+        : _pin(pin), _chan(static_cast<rmt_channel_t>(rmtChannel)) {}
+
+    bool begin() {
+        rmt_config_t config = RMT_DEFAULT_CONFIG_TX(static_cast<gpio_num_t>(_pin), _chan);
+        config.clk_div = StripTiming::CLK_DIV;
+        config.mem_block_num = 1;
+        if (rmt_config(&config) != ESP_OK || rmt_driver_install(_chan, 0, 0) != ESP_OK) {
+            Serial.printf("LedStrip: RMT channel %d unavailable\n", _chan);
+            return false;
+        }
+        _init = true;
+        return true;
+    }
+
+    // True while the previous frame is still being clocked out
+    bool busy() const { return _init && rmt_wait_tx_done(_chan, 0) != ESP_OK; }
+
+    // Quantise a 12-bit frame, encode to RMT items and start transmission.
+    // Returns false without blocking if the last frame is still on the wire.
+    bool show(const RGB12* frame) {
+        if (!_init || busy()) { return false; }
+        const uint32_t tic = micros();
+        uint8_t* p = _bytes;
+        for (size_t k = 0; k < Count; k++) {
+            uint8_t r = frame[k].r >> 4, g = frame[k].g >> 4, b = frame[k].b >> 4;
+            if (Type == StripType::SK6812_GRBW) {
+                const uint8_t w = min(r, min(g, b));
+                *p++ = g - w; *p++ = r - w; *p++ = b - w; *p++ = w;
+            } else {
+                *p++ = g; *p++ = r; *p++ = b;
+            }
+        }
+        StripTiming::encode(_bytes, sizeof(_bytes), _items);
+        StripTiming::terminate(_items, ITEMS);
+        _renderMicros = micros() - tic;
+        rmt_write_items(_chan, reinterpret_cast<const rmt_item32_t*>(_items), ITEMS, false);
+        return true;
+    }
+
+    // Encode cost of the latest frame, and the fixed wire time of a frame
+    uint32_t renderMicros() const { return _renderMicros; }
+    static constexpr uint32_t transmitMicros() {
+        return (ITEMS * StripTiming::BIT_NS) / 1000 + StripTiming::RESET_US;
+    }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("LedStrip: %u LEDs, render %lu us (%lu us/100), transmit %lu us (%lu us/100)\n",
+            static_cast<unsigned>(Count),
+            _renderMicros, _renderMicros * 100 / Count,
+            transmitMicros(), transmitMicros() * 100 / Count);
+    }
+
+    static constexpr size_t size() { return Count; }
+};
+/****************************************************************************/
+#endif
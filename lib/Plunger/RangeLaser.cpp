@@ -1,7 +1,7 @@
 #include "RangeLaser.hpp"
 
 /*************************************************************************************/
-RangeLaser::RangeLaser() : init(false), continuous(false)
+RangeLaser::RangeLaser() : init(false), continuous(false), offset_mm(0.0f), smoother(nullptr)
 {
 }
 /*************************************************************************************/
@@ -110,7 +110,8 @@ float RangeLaser::readDistanceContinuous()
         return -1.0;
     }
     setError("");
-    return (float)distance + offset_mm;     // Apply calibration offset
+    const float mm = (float)distance + offset_mm;     // Apply calibration offset
+    return smoother ? smoother->apply(mm) : mm;
 }
 /*************************************************************************************/
 bool RangeLaser::calibrateZeroOffset(uint16_t known_distance_mm, uint8_t samples) {
@@ -160,6 +161,11 @@ void RangeLaser::setOffset(float offset_mm) {
   Serial.println("Offset set to: " + String(offset_mm, 1) + "mm");
 }
 /*************************************************************************************/
+void RangeLaser::attachSmoother(OneEuroFilter<1>& filter) {
+  smoother = &filter;
+  smoother->reset();
+}
+/*************************************************************************************/
 void RangeLaser::printDiagnostics() {
   Serial.println("=== VL6180X Range Laser Sensor Diagnostics ===");
   Serial.println("Initialized: " + String(init ? "Yes" : "No"));
@@ -5,6 +5,7 @@
 #include <Wire.h>
 #include <VL6180X.h>
 #include "utilities.hpp"
+#include "OneEuro.hpp"
 
 constexpr uint8_t DEVICE_ADDRESS = 0x29;
 
@@ -16,6 +17,7 @@ private:
   bool init; 
   bool continuous;
   float offset_mm; 
+  OneEuroFilter<1>* smoother;   // Optional adaptive smoothing of continuous reads
   
   void setError(const String& error);
 
@@ -40,6 +42,9 @@ public:
   void setOffset(float offset_mm);
   float getOffset() const { return offset_mm; }
   void clearOffset() { offset_mm = 0.0f; }
+
+  // Smoothing
+  void attachSmoother(OneEuroFilter<1>& filter);
   
   // Configuration
   void setScaling(uint8_t scaling);
@@ -0,0 +1,260 @@
+#ifndef POWER_ARBITER_HPP
+#define POWER_ARBITER_HPP
+
+#pragma once
+#include <Arduino.h>
+#include "Solenoid.hpp"
+#include "Color.hpp"
+
+/****************************************************************************/
+// Supply: Sony VGP-AC19V31, 19.5 V @ 4.7 A (see circuits/README.md).
+// 15% is held back for converter losses in the estimates and the MCU rail.
+constexpr uint32_t SUPPLY_MW = 90000;
+constexpr uint32_t SUPPLY_BUDGET_MW = SUPPLY_MW * 85 / 100;
+
+enum class Rail : uint8_t { V12, V5 };
+
+struct RailSpec {
+    uint16_t mV;
+    uint8_t efficiency;         // % of buck converter, input power = output / eff
+};
+
+inline constexpr RailSpec RAILS[] = {
+    {12000, 90},                // Solenoids, shakers, exterior LEDs
+    {5000, 90}                  // TLC5947 bank, button LEDs
+};
+
+/****************************************************************************/
+// Estimates supply draw from LED frame contents and coil PWM duties, and
+// keeps it under budget:
+//   - every LED frame is scaled from its own demand, between measuring it
+//     and writing it out (scaleFrame(), called by Animator and Compositor
+//     when attached), against coils and the other groups' frames as they
+//     were actually sent. A frame whose demand jumps is scaled in that
+//     same frame, never one frame late.
+//   - coils win over lights: a coil fire is admitted if it fits with LEDs
+//     at a visible floor; low-priority coils must also leave `reserveMw`
+//     free for high-priority ones (flippers). If it fits only once the LEDs
+//     dim, admit() stakes a claim and defers; the next LED frames make the
+//     room and the caller's retry gets in.
+// scaleFrame() and admit() are O(coils + LED groups).
+class PowerArbiter {
+
+public:
+    static constexpr uint8_t MAX_COILS = 8;
+    static constexpr uint8_t MAX_LED_GROUPS = 4;
+    static constexpr uint8_t PRIORITY_HIGH = 128;
+    static constexpr uint32_t CLAIM_US = 50000;     // Two LED frames to dim for a coil
+
+private:
+    struct Coil {
+        const Solenoid* driver;
+        uint16_t mA;                // Current at 100% duty
+        Rail rail;
+        uint8_t priority;
+        uint32_t reservedUntil;     // micros(); counted at full duty until then
+        uint32_t reservedUs;        // Length of that reservation, 0 once over
+        uint32_t claimUntil;        // micros(); LEDs keep room for it until then
+        uint32_t claimUs;           // Length of that claim, 0 once over
+    };
+
+    struct LedGroup {
+        Rail rail;
+        uint16_t mAPerChannel;      // Current of one channel at LEVEL_MAX
+        uint32_t demand;            // Unscaled level sum of the latest frame
+        uint16_t applied;           // Q8 scale that frame went out with
+    };
+
+    Coil _coils[MAX_COILS];
+    LedGroup _groups[MAX_LED_GROUPS];
+    uint8_t _coilCount = 0;
+    uint8_t _groupCount = 0;
+
+    uint32_t _budgetMw;
+    uint32_t _reserveMw;
+    uint16_t _floorQ8;              // LED scale coil admission leaves room for
+
+    uint16_t _scale = 256;          // Latest frame's scale
+    uint32_t _coilMw = 0;           // Coils + reservations + claims, latest frame
+    uint32_t _ledMw = 0;            // LED demand before scaling, latest frame
+    uint32_t _peakMw = 0;           // Highest estimate of what was actually driven
+    uint32_t _scaledFrames = 0;
+    uint32_t _belowFloor = 0;       // Frames scaled under the floor to hold the budget
+    uint32_t _deferred = 0;
+    uint32_t _claims = 0;
+    uint32_t _lastMicros = 0;
+
+    static uint32_t railMw(Rail rail, uint32_t mA) {
+        const RailSpec& r = RAILS[static_cast<uint8_t>(rail)];
+        return (mA * r.mV / 1000) * 100 / r.efficiency;
+    }
+
+    // A window of `span` us ending at `until` has not ended yet at `now`.
+    // Measured against its own length, so a long-gone window cannot look
+    // "ahead" again once micros() has moved on by 2^31 us.
+    static bool pending(uint32_t until, uint32_t span, uint32_t now) { return until - now - 1u < span; }
+
+    // Drop reservations and claims that have run out
+    void expire(uint32_t now) {
+        for (uint8_t k = 0; k < _coilCount; k++) {
+            Coil& c = _coils[k];
+            if (!pending(c.reservedUntil, c.reservedUs, now)) c.reservedUs = 0;
+            if (!pending(c.claimUntil, c.claimUs, now)) c.claimUs = 0;
+        }
+    }
+
+    uint32_t coilMw(uint32_t now) const {
+        uint32_t mw = 0;
+        for (uint8_t k = 0; k < _coilCount; k++) {
+            const Coil& c = _coils[k];
+            const uint32_t duty = pending(c.reservedUntil, c.reservedUs, now) ? 4095 : c.driver->getDuty();
+            mw += railMw(c.rail, c.mA * duty / 4095);
+        }
+        return mw;
+    }
+
+    // Full-duty draw of coils waiting for LEDs to make room
+    uint32_t claimMw(uint32_t now, uint8_t skip = MAX_COILS) const {
+        uint32_t mw = 0;
+        for (uint8_t k = 0; k < _coilCount; k++) {
+            const Coil& c = _coils[k];
+            if (k != skip && pending(c.claimUntil, c.claimUs, now)) mw += railMw(c.rail, c.mA);
+        }
+        return mw;
+    }
+
+    static uint32_t groupMw(const LedGroup& g, uint16_t scaleQ8) {
+        const uint64_t mA = static_cast<uint64_t>(g.demand) * g.mAPerChannel * scaleQ8 / (LEVEL_MAX * 256ull);
+        return railMw(g.rail, static_cast<uint32_t>(mA));
+    }
+
+    // Every group at one scale
+    uint32_t ledMw(uint16_t scaleQ8) const {
+        uint32_t mw = 0;
+        for (uint8_t k = 0; k < _groupCount; k++) mw += groupMw(_groups[k], scaleQ8);
+        return mw;
+    }
+
+    // Every group as its latest frame went out
+    uint32_t appliedMw(uint8_t skip = MAX_LED_GROUPS) const {
+        uint32_t mw = 0;
+        for (uint8_t k = 0; k < _groupCount; k++) {
+            if (k != skip) mw += groupMw(_groups[k], _groups[k].applied);
+        }
+        return mw;
+    }
+
+public:
+
+    PowerArbiter(uint32_t budgetMw = SUPPLY_BUDGET_MW, uint32_t reserveMw = 12000, uint16_t floorQ8 = 32)
+        : _budgetMw(budgetMw), _reserveMw(reserveMw), _floorQ8(floorQ8) {}
+
+    int8_t addCoil(const Solenoid& driver, uint16_t mAFull, uint8_t priority = 0, Rail rail = Rail::V12) {
+        if (_coilCount >= MAX_COILS) return -1;
+        _coils[_coilCount] = Coil{&driver, mAFull, rail, priority, micros(), 0, micros(), 0};
+        return static_cast<int8_t>(_coilCount++);
+    }
+
+    int8_t addLeds(Rail rail, uint16_t mAPerChannel) {
+        if (_groupCount >= MAX_LED_GROUPS) return -1;
+        _groups[_groupCount] = LedGroup{rail, mAPerChannel, 0, 256};
+        return static_cast<int8_t>(_groupCount++);
+    }
+
+    /**
+     * @brief Scale for one LED group's frame, from that frame's own demand
+     * @param levelSum Unscaled sum of the frame's 12-bit channel levels
+     * @return Q8 scale the frame must be written with. Normally no lower
+     * than the floor; lower only when the frame's demand jumped past what
+     * coils were admitted against, since the budget comes first.
+     */
+    uint16_t scaleFrame(uint8_t group, uint32_t levelSum, uint32_t now = micros()) {
+        if (group >= _groupCount) return 256;
+        const uint32_t tic = micros();
+        LedGroup& g = _groups[group];
+        g.demand = levelSum;
+        expire(now);
+        _coilMw = coilMw(now) + claimMw(now);
+        _ledMw = ledMw(256);
+
+        // Fair share: every group at the same scale, on current demands...
+        uint16_t scale = 256;
+        if (_coilMw + _ledMw > _budgetMw && _ledMw) {
+            const uint32_t room = _budgetMw > _coilMw ? _budgetMw - _coilMw : 0;
+            scale = min<uint32_t>(static_cast<uint64_t>(room) * 256 / _ledMw, 256);
+        }
+        // ...and never more than what is left beside the other groups' frames
+        // as they were actually sent
+        const uint32_t used = _coilMw + appliedMw(group);
+        const uint32_t room = _budgetMw > used ? _budgetMw - used : 0;
+        const uint32_t mine = groupMw(g, 256);
+        if (mine > room) scale = min<uint32_t>(scale, static_cast<uint64_t>(room) * 256 / mine);
+        // Integer rounding in groupMw can leave us a hair over; step down
+        while (scale > 0 && groupMw(g, scale) > room) scale--;
+
+        g.applied = scale;
+        _scale = scale;
+        if (scale < 256) _scaledFrames++;
+        if (scale < _floorQ8 && mine) _belowFloor++;
+        _peakMw = max(_peakMw, coilMw(now) + appliedMw());
+        _lastMicros = micros() - tic;
+        return scale;
+    }
+
+    /**
+     * @brief Ask before firing a coil. Reserves its full-duty draw for
+     * durationUs (the kick).
+     * @return false if the fire should be deferred; retry later. A fire
+     * that only needs the LEDs to dim keeps a claim for CLAIM_US, so it
+     * gets in once the next LED frames have gone out.
+     */
+    bool admit(uint8_t coil, uint32_t durationUs, uint32_t now = micros()) {
+        if (coil >= _coilCount) return false;
+        expire(now);
+        Coil& c = _coils[coil];
+        const uint32_t reserved = c.reservedUntil, reservedUs = c.reservedUs;
+        c.reservedUntil = now + durationUs;             // Count it at full duty...
+        c.reservedUs = durationUs;
+        const uint32_t coils = coilMw(now) + claimMw(now, coil);
+        const uint32_t reserve = c.priority >= PRIORITY_HIGH ? 0 : _reserveMw;
+        if (coils + ledMw(_floorQ8) + reserve > _budgetMw) {
+            c.reservedUntil = reserved;                 // ...unless it does not fit
+            c.reservedUs = reservedUs;
+            _deferred++;
+            return false;
+        }
+        if (coils + appliedMw() > _budgetMw) {
+            c.reservedUntil = reserved;                 // Fits, once the LEDs dim
+            c.reservedUs = reservedUs;
+            if (!c.claimUs) _claims++;
+            c.claimUntil = now + CLAIM_US;
+            c.claimUs = CLAIM_US;
+            _deferred++;
+            return false;
+        }
+        c.claimUs = 0;
+        return true;
+    }
+
+    uint16_t scale() const { return _scale; }
+    uint16_t groupScale(uint8_t group) const { return group < _groupCount ? _groups[group].applied : 256; }
+    uint32_t coilMilliwatts() const { return _coilMw; }
+    uint32_t ledMilliwatts() const { return _ledMw; }
+    // Estimated draw now: coils as driven, LEDs as their latest frames went out
+    uint32_t totalMilliwatts(uint32_t now = micros()) const { return coilMw(now) + appliedMw(); }
+    uint32_t peakMilliwatts() const { return _peakMw; }
+    uint32_t budget() const { return _budgetMw; }
+    uint32_t deferred() const { return _deferred; }
+    uint32_t claims() const { return _claims; }
+    uint32_t scaledFrames() const { return _scaledFrames; }
+    uint32_t belowFloorFrames() const { return _belowFloor; }
+    uint32_t lastDecisionMicros() const { return _lastMicros; }
+
+    void printStats(Stream& stream = Serial) const {
+        stream.printf("Power: %lu/%lu mW (coils %lu, LEDs %lu x %u/256), peak %lu mW, %lu scaled frames (%lu below floor), %lu deferred (%lu claims), %lu us\n",
+            totalMilliwatts(), _budgetMw, _coilMw, _ledMw, _scale, _peakMw, _scaledFrames, _belowFloor,
+            _deferred, _claims, _lastMicros);
+    }
+};
+/****************************************************************************/
+#endif
@@ -0,0 +1,96 @@
+#ifndef CIC_DECIMATOR_HPP
+#define CIC_DECIMATOR_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+
+/**********************************************************************************/
+// Cascaded integrator-comb decimator with a droop compensation FIR.
+//
+// Stages integrators run at the input rate, Stages combs at the output
+// rate, differential delay 1: H(z) = ((1 - z^-R) / (1 - z^-1))^Stages. The
+// CIC itself is adds and subtracts only. Integrators are unsigned so they
+// wrap (well defined), and the combs undo the wrap exactly as long as the
+// output fits the register, hence the bit-growth check. With Ratio a power
+// of two the gain R^Stages comes off exactly.
+//
+// The CIC's sinc^Stages response sags across the output passband; a 3-tap
+// FIR at the output rate, [-a, 1 + 2a, -a] with a = Stages / 24, flattens
+// its second-order term (about 1 dB left at a quarter of the output rate
+// instead of 3 dB for Stages = 3). Group delay: Stages * (Ratio - 1) / 2
+// input samples for the CIC, plus one output sample for the FIR.
+template<uint8_t Ratio, uint8_t Stages = 3, uint8_t Channels = 3>
+class CicDecimator {
+    static_assert(Ratio >= 2 && (Ratio & (Ratio - 1)) == 0, "CIC ratio must be a power of two");
+    static_assert(Stages >= 1 && Channels >= 1, "Need at least one stage and one channel");
+
+public:
+    static constexpr uint8_t shift() {
+        uint8_t s = 0;
+        for (uint8_t r = Ratio; r > 1; r >>= 1) { s++; }
+        return s * Stages;
+    }
+
+private:
+    static_assert(16 + shift() <= 32, "int16 input would outgrow 32-bit CIC registers; use fewer stages or a lower ratio");
+
+    static constexpr float COMP = Stages / 24.f;
+    static constexpr float GAIN = 1.f / (1ull << shift());
+
+    uint32_t _integ[Channels][Stages] = {};
+    uint32_t _comb[Channels][Stages] = {};      // Previous comb inputs
+    float _fir[Channels][2] = {};               // Last two CIC outputs
+    uint8_t _phase = 0;
+    uint8_t _warmup = 0;                        // Outputs before the pipeline is full
+
+public:
+    static constexpr uint8_t ratio() { return Ratio; }
+    static constexpr uint8_t stages() { return Stages; }
+
+    void reset() {
+        memset(_integ, 0, sizeof(_integ));
+        memset(_comb, 0, sizeof(_comb));
+        memset(_fir, 0, sizeof(_fir));
+        _phase = 0;
+        _warmup = 0;
+    }
+
+    /**
+     * @brief One input sample per channel
+     * @param out Written with the decimated sample, in input units, every
+     * Ratio-th call
+     * @return true when out holds a new output sample
+     */
+    bool push(const int16_t (&in)[Channels], float (&out)[Channels]) {
+        for (uint8_t c = 0; c < Channels; c++) {
+            uint32_t acc = static_cast<uint32_t>(static_cast<int32_t>(in[c]));
+            for (uint8_t s = 0; s < Stages; s++) { acc = _integ[c][s] += acc; }
+        }
+        if (++_phase < Ratio) { return false; }
+        _phase = 0;
+
+        for (uint8_t c = 0; c < Channels; c++) {
+            uint32_t acc = _integ[c][Stages - 1];
+            for (uint8_t s = 0; s < Stages; s++) {
+                const uint32_t prev = _comb[c][s];
+                _comb[c][s] = acc;
+                acc -= prev;
+            }
+            // Scale in float rather than shifting, to keep the fractional LSB
+            // the averaging gained
+            const float y = static_cast<float>(static_cast<int32_t>(acc)) * GAIN;
+            // Compensation FIR, centred on the previous output
+            out[c] = (1.f + 2.f * COMP) * _fir[c][0] - COMP * (y + _fir[c][1]);
+            _fir[c][1] = _fir[c][0];
+            _fir[c][0] = y;
+        }
+        // The first outputs mix in the zeroed history; skip them
+        if (_warmup < Stages + 2) { _warmup++; return false; }
+        return true;
+    }
+};
+
+/**********************************************************************************/
+
+#endif
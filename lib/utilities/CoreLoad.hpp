@@ -0,0 +1,75 @@
+#ifndef CORE_LOAD_HPP
+#define CORE_LOAD_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <esp_freertos_hooks.h>
+
+/****************************************************************************/
+// Per-core CPU load from the FreeRTOS idle hooks. Each core's idle task
+// calls its hook in a tight loop; back-to-back calls (gap < IDLE_GAP_US)
+// are counted as idle time, anything longer means another task ran.
+// Load over a window = 1 - idle / elapsed.
+class CoreLoad {
+
+public:
+    static constexpr uint8_t CORES = 2;
+    static constexpr int64_t IDLE_GAP_US = 50;
+
+private:
+    static inline volatile int64_t _last[CORES] = {};
+    static inline volatile int64_t _idle[CORES] = {};
+    static inline int64_t _windowIdle[CORES] = {};
+    static inline int64_t _windowStart = 0;
+    static inline float _load[CORES] = {};
+
+    static bool account(uint8_t core) {
+        const int64_t now = esp_timer_get_time();
+        const int64_t gap = now - _last[core];
+        if (gap < IDLE_GAP_US) { _idle[core] = _idle[core] + gap; }
+        _last[core] = now;
+        return false;                               // Call again straight away
+    }
+
+    static bool hook0() { return account(0); }
+    static bool hook1() { return account(1); }
+
+public:
+
+    static bool begin() {
+        _windowStart = esp_timer_get_time();
+        for (uint8_t c = 0; c < CORES; c++) { _last[c] = _windowStart; _windowIdle[c] = _idle[c]; }
+        return esp_register_freertos_idle_hook_for_cpu(&CoreLoad::hook0, 0) == ESP_OK
+            && esp_register_freertos_idle_hook_for_cpu(&CoreLoad::hook1, 1) == ESP_OK;
+    }
+
+    static void end() {
+        esp_deregister_freertos_idle_hook_for_cpu(&CoreLoad::hook0, 0);
+        esp_deregister_freertos_idle_hook_for_cpu(&CoreLoad::hook1, 1);
+    }
+
+    // Close the current window and compute each core's load over it
+    static void sample() {
+        const int64_t now = esp_timer_get_time();
+        const int64_t span = now - _windowStart;
+        if (span <= 0) { return; }
+        for (uint8_t c = 0; c < CORES; c++) {
+            const int64_t idle = _idle[c];
+            _load[c] = constrain(1.f - static_cast<float>(idle - _windowIdle[c]) / span, 0.f, 1.f);
+            _windowIdle[c] = idle;
+        }
+        _windowStart = now;
+    }
+
+    // Fraction 0..1 over the last sample() window
+    static float load(uint8_t core) { return core < CORES ? _load[core] : 0.f; }
+
+    static void printStats(Stream& stream = Serial) {
+        sample();
+        stream.printf("CoreLoad: core 0 %.1f%%, core 1 %.1f%%\n", 100.f * _load[0], 100.f * _load[1]);
+    }
+};
+/****************************************************************************/
+
+#endif
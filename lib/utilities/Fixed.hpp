@@ -0,0 +1,174 @@
+#ifndef FIXED_HPP
+#define FIXED_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <type_traits>
+#include "vectors.hpp"
+
+/**********************************************************************************/
+// Signed Q-format number with IntBits integer and FracBits fraction bits
+// (plus sign) in an int32_t. Every operation saturates to the representable
+// range instead of wrapping, so an out-of-range accelerometer reading pins
+// at full scale rather than flipping sign. Fully constexpr; no FPU needed
+// except to convert to and from float.
+template<uint8_t IntBits, uint8_t FracBits>
+class Fixed {
+    static_assert(IntBits + FracBits <= 31, "Fixed holds at most 31 bits plus sign");
+
+public:
+    static constexpr int64_t RAW_MAX = (int64_t(1) << (IntBits + FracBits)) - 1;
+    static constexpr int64_t RAW_MIN = -(int64_t(1) << (IntBits + FracBits));
+    static constexpr int64_t ONE = int64_t(1) << FracBits;
+
+private:
+    int32_t _raw = 0;
+
+    static constexpr int32_t saturate(int64_t v) {
+        return static_cast<int32_t>(v > RAW_MAX ? RAW_MAX : v < RAW_MIN ? RAW_MIN : v);
+    }
+
+    // a * b / 2^FracBits, rounded half up
+    static constexpr int64_t product(int64_t a, int64_t b) {
+        return FracBits ? (a * b + (int64_t(1) << (FracBits - 1))) >> FracBits : a * b;
+    }
+
+public:
+    constexpr Fixed() = default;
+
+    template<typename I, typename std::enable_if_t<std::is_integral<I>::value, int> = 0>
+    constexpr Fixed(I value) : _raw(saturate(static_cast<int64_t>(value) * ONE)) {}
+
+    template<typename F, typename std::enable_if_t<std::is_floating_point<F>::value, int> = 0>
+    constexpr Fixed(F value) : _raw(
+        value != value ? 0                                          // NaN
+      : value * ONE >= RAW_MAX ? static_cast<int32_t>(RAW_MAX)
+      : value * ONE <= RAW_MIN ? static_cast<int32_t>(RAW_MIN)
+      : static_cast<int32_t>(value * ONE + (value < 0 ? -0.5f : 0.5f))) {}
+
+    static constexpr Fixed fromRaw(int64_t raw) {
+        Fixed f;
+        f._raw = saturate(raw);
+        return f;
+    }
+
+    static constexpr Fixed max() { return fromRaw(RAW_MAX); }
+    static constexpr Fixed min() { return fromRaw(RAW_MIN); }
+
+    constexpr int32_t raw() const { return _raw; }
+    constexpr explicit operator float() const { return static_cast<float>(_raw) / ONE; }
+    constexpr int32_t toInt() const { return _raw >> FracBits; }      // Floor
+
+    // Arithmetic
+    constexpr Fixed operator-() const { return fromRaw(-static_cast<int64_t>(_raw)); }
+    constexpr Fixed& operator+=(Fixed o) { _raw = saturate(static_cast<int64_t>(_raw) + o._raw); return *this; }
+    constexpr Fixed& operator-=(Fixed o) { _raw = saturate(static_cast<int64_t>(_raw) - o._raw); return *this; }
+    constexpr Fixed& operator*=(Fixed o) { _raw = saturate(product(_raw, o._raw)); return *this; }
+    constexpr Fixed& operator/=(Fixed o) {
+        // x / 0 pins at the full scale of x's sign
+        _raw = o._raw == 0 ? saturate(_raw >= 0 ? RAW_MAX : RAW_MIN)
+             : saturate((static_cast<int64_t>(_raw) * ONE) / o._raw);
+        return *this;
+    }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return a += b; }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return a -= b; }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) { return a *= b; }
+    friend constexpr Fixed operator/(Fixed a, Fixed b) { return a /= b; }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a._raw == b._raw; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a._raw != b._raw; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a._raw < b._raw; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a._raw > b._raw; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a._raw <= b._raw; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a._raw >= b._raw; }
+
+    // Vector<Fixed, N>::magnitude(), found by argument-dependent lookup.
+    // Squares are summed in 64 bits, so no intermediate can saturate.
+    template<size_t N>
+    friend constexpr Fixed vectorMagnitude(const Vector<Fixed, N>& v) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < N; i++) { sum += static_cast<uint64_t>(static_cast<int64_t>(v[i]._raw) * v[i]._raw); }
+        return fromRaw(static_cast<int64_t>(isqrt(sum)));
+    }
+
+    static constexpr uint64_t isqrt(uint64_t n) {
+        uint64_t root = 0, bit = uint64_t(1) << 62;
+        while (bit > n) { bit >>= 2; }
+        while (bit) {
+            if (n >= root + bit) { n -= root + bit; root = (root >> 1) + bit; }
+            else { root >>= 1; }
+            bit >>= 2;
+        }
+        return root;
+    }
+};
+
+template<uint8_t IntBits, uint8_t FracBits>
+struct IsVectorScalar<Fixed<IntBits, FracBits>> : std::true_type {};
+
+// Q15.16: +-32768 with 1.5e-5 steps, plenty for m/s^2 and degrees
+using Fix16 = Fixed<15, 16>;
+using Vec2x = Vector<Fix16, 2>;
+using Vec3x = Vector<Fix16, 3>;
+
+/**********************************************************************************/
+// CORDIC in vectoring mode: rotates (x, y) onto the +x axis in 2^-i steps,
+// accumulating the angle turned. Integer shifts and adds only.
+namespace Cordic {
+    constexpr uint8_t STEPS = 24;
+    constexpr int32_t GAIN_INV_Q30 = 652032874;     // 1 / prod(sqrt(1 + 2^-2i)) = 0.607253
+
+    // atan(2^-i) in degrees, Q16
+    inline constexpr int32_t ATAN_DEG_Q16[STEPS] = {
+        2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+        14668, 7334, 3667, 1833, 917, 458, 229, 115, 57, 29, 14, 7, 4, 2, 1, 0
+    };
+
+    struct Polar {
+        int32_t angleQ16;                           // Degrees, Q16, (-180, 180]
+        int64_t radius;                             // In the inputs' units
+    };
+
+    constexpr Polar vectoring(int64_t x, int64_t y) {
+        if (x == 0 && y == 0) { return { 0, 0 }; }  // atan2(0, 0) = 0, as in float
+        // Fold the left half-plane onto the right, remembering the +-180
+        int32_t angle = 0;
+        if (x < 0) {
+            angle = y >= 0 ? 180 * 65536 : -180 * 65536;
+            x = -x;
+            y = -y;
+        }
+        // Scale into [2^27, 2^28): the rotation gain can't overflow and the
+        // 2^-i steps keep their precision
+        constexpr int64_t HI = int64_t(1) << 28, LO = int64_t(1) << 27;
+        int8_t shift = 0;
+        while (x >= HI || y >= HI || -y >= HI) { x >>= 1; y >>= 1; shift--; }
+        while ((x | y) != 0 && x < LO && y < LO && -y < LO) { x <<= 1; y <<= 1; shift++; }
+        for (uint8_t i = 0; i < STEPS; i++) {
+            const int64_t dx = y >> i, dy = x >> i;
+            if (y > 0) { x += dx; y -= dy; angle += ATAN_DEG_Q16[i]; }
+            else { x -= dx; y += dy; angle -= ATAN_DEG_Q16[i]; }
+        }
+        const int64_t radius = (x * GAIN_INV_Q30) >> 30;
+        return { angle, shift >= 0 ? radius >> shift : radius << -shift };
+    }
+}
+
+// tiltProjection() for fixed point: (pitch, roll) in degrees, as the float
+// version but with CORDIC. The roll rotation also yields sqrt(y^2 + z^2),
+// which is exactly the pitch rotation's x input.
+template<uint8_t IntBits, uint8_t FracBits>
+constexpr Vector<Fixed<IntBits, FracBits>, 2> tiltProjection(const Vector<Fixed<IntBits, FracBits>, 3>& vec) {
+    using Fx = Fixed<IntBits, FracBits>;
+    const Cordic::Polar roll = Cordic::vectoring(vec[2].raw(), vec[1].raw());
+    const Cordic::Polar pitch = Cordic::vectoring(roll.radius, -static_cast<int64_t>(vec[0].raw()));
+    const auto toFx = [](int32_t q16) {
+        return Fx::fromRaw(FracBits >= 16 ? static_cast<int64_t>(q16) << (FracBits - 16)
+                                          : static_cast<int64_t>(q16) >> (16 - FracBits));
+    };
+    return Vector<Fx, 2>(toFx(pitch.angleQ16), toFx(roll.angleQ16));
+}
+/**********************************************************************************/
+
+#endif
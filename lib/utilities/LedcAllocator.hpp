@@ -0,0 +1,106 @@
+#ifndef LEDC_ALLOCATOR_HPP
+#define LEDC_ALLOCATOR_HPP
+
+#pragma once
+#include <Arduino.h>
+
+/****************************************************************************/
+// Bookkeeping for the LEDC peripheral, shared by every PWM user (Solenoid,
+// button LEDs, motors). The Arduino core binds channel pairs to one timer
+// (timer = (channel / 2) % 4), so two channels can only share a timer if
+// they agree on frequency and resolution. ledcSetup() on one channel
+// silently retunes its sibling, which is what this class prevents.
+//
+// Channels fixed by wiring (the Solenoid's) are reserved when their owner
+// is constructed, before any begin() runs, so the dynamic claim() of a
+// FadeLED or ShakerMotor can neither take them nor retune their timer.
+//
+// Budget with the default wiring: the solenoid holds channel 0, a shaker
+// needs a timer pair of its own at 20 kHz, and each RGB button lamp takes
+// three 4 kHz channels. That is two PWM lamps without a shaker, one with;
+// further buttons stay on plain GPIO (beginPWM() returns false).
+class LedcAllocator {
+
+public:
+    static constexpr uint8_t CHANNELS = 8;          // ESP32-S3: 8 low-speed channels
+    static constexpr uint8_t TIMERS = 4;
+
+    static constexpr uint8_t timerOf(uint8_t channel) { return (channel / 2) % TIMERS; }
+
+    // Hold a specific channel, and its timer's config, for a later
+    // claim(channel, ...). Call from the owner's constructor. false if
+    // taken, already reserved, or its timer runs at another config.
+    static bool reserve(uint8_t channel, uint32_t freq, uint8_t bits) {
+        if (channel >= CHANNELS || ((_used | _reserved) & mask(channel))) { return false; }
+        if (!hold(channel, freq, bits)) { return false; }
+        _reserved |= mask(channel);
+        return true;
+    }
+
+    // Claim a specific channel (e.g. one fixed by wiring). false if taken
+    // or its timer already runs at a different frequency/resolution.
+    static bool claim(uint8_t channel, uint32_t freq, uint8_t bits) {
+        if (channel >= CHANNELS || (_used & mask(channel))) { return false; }
+        if (_reserved & mask(channel)) {
+            const Timer& t = _timers[timerOf(channel)];
+            if (t.freq != freq || t.bits != bits) { return false; }
+            _reserved &= ~mask(channel);        // The reservation already counts as a user
+        } else if (!hold(channel, freq, bits)) {
+            return false;
+        }
+        _used |= mask(channel);
+        return true;
+    }
+
+    // Claim any free channel whose timer is compatible. Prefers timers
+    // already running at this config so fresh timers stay available.
+    static int8_t claim(uint32_t freq, uint8_t bits) {
+        for (uint8_t pass = 0; pass < 2; pass++) {
+            for (uint8_t ch = 0; ch < CHANNELS; ch++) {
+                const Timer& t = _timers[timerOf(ch)];
+                const bool shared = t.users && t.freq == freq && t.bits == bits;
+                if ((pass == 0 && !shared) || (pass == 1 && t.users)) { continue; }
+                if (_reserved & mask(ch)) { continue; }
+                if (claim(ch, freq, bits)) { return static_cast<int8_t>(ch); }
+            }
+        }
+        return -1;
+    }
+
+    // Frees a claimed or reserved channel
+    static void release(uint8_t channel) {
+        if (channel >= CHANNELS || !((_used | _reserved) & mask(channel))) { return; }
+        _used &= ~mask(channel);
+        _reserved &= ~mask(channel);
+        _timers[timerOf(channel)].users--;
+    }
+
+    static bool isClaimed(uint8_t channel) { return channel < CHANNELS && (_used & mask(channel)); }
+    static bool isReserved(uint8_t channel) { return channel < CHANNELS && (_reserved & mask(channel)); }
+    static uint8_t freeChannels() { return CHANNELS - __builtin_popcount(_used | _reserved); }
+
+private:
+    struct Timer {
+        uint32_t freq;
+        uint8_t bits;
+        uint8_t users;
+    };
+
+    static constexpr uint8_t mask(uint8_t channel) { return static_cast<uint8_t>(1u << channel); }
+
+    static bool hold(uint8_t channel, uint32_t freq, uint8_t bits) {
+        Timer& t = _timers[timerOf(channel)];
+        if (t.users && (t.freq != freq || t.bits != bits)) { return false; }
+        t.freq = freq;
+        t.bits = bits;
+        t.users++;
+        return true;
+    }
+
+    // Constant-initialised, so constructors of other globals can reserve
+    static inline uint8_t _used = 0;
+    static inline uint8_t _reserved = 0;
+    static inline Timer _timers[TIMERS] = {};
+};
+/****************************************************************************/
+#endif
@@ -0,0 +1,152 @@
+#ifndef ONE_EURO_HPP
+#define ONE_EURO_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+#include "vectors.hpp"
+#include "utilities.hpp"
+
+/**********************************************************************************/
+// Per-channel tunables of the One-Euro filter
+struct OneEuroParams {
+    float minCutoff = 1.f;          // Hz at rest; lower = less jitter
+    float beta = 0.05f;             // Cutoff added per unit/s of speed; higher = less lag
+    float dCutoff = 1.f;            // Hz, smoothing of the speed estimate
+};
+
+/**********************************************************************************/
+// One-Euro adaptive low-pass (Casiez et al.): a one-pole filter whose
+// cutoff rises with the smoothed speed of the signal,
+//
+//   fc = minCutoff + beta * |dx/dt|,   y += alpha(fc) * (x - y)
+//
+// so a resting input sees minCutoff (no jitter) and a moving one sees a
+// cutoff high enough to keep up (little lag). N channels, each with its
+// own tunables; all state is inline, nothing is allocated. A sample costs
+// one reciprocal per channel on top of two one-pole steps.
+template<size_t N>
+class OneEuroFilter {
+    static_assert(N >= 1, "OneEuroFilter needs at least one channel");
+
+private:
+    OneEuroParams _params[N];
+    float _dt;
+    float _dAlpha[N];               // Speed smoothing, fixed at the nominal rate
+    float _x[N] = {};               // Last output
+    float _dx[N] = {};              // Smoothed speed
+    bool _primed = false;
+
+    static float alpha(float cutoff, float dt) {
+        const float tau = 1.f / (2.f * PI * cutoff);
+        return 1.f / (1.f + tau / dt);
+    }
+
+    float step(size_t k, float x, float dt, float dAlpha) {
+        const OneEuroParams& p = _params[k];
+        _dx[k] += dAlpha * ((x - _x[k]) / dt - _dx[k]);
+        const float a = alpha(p.minCutoff + p.beta * fabsf(_dx[k]), dt);
+        _x[k] += a * (x - _x[k]);
+        return _x[k];
+    }
+
+    Vector<float, N> prime(const Vector<float, N>& x) {
+        for (size_t k = 0; k < N; k++) { _x[k] = x[k]; _dx[k] = 0.f; }
+        _primed = true;
+        return x;
+    }
+
+public:
+    /**
+     * @param rate Nominal sample rate, Hz, used by apply(x)
+     * @param params Starting tunables for every channel
+     */
+    OneEuroFilter(float rate = SMPL_FREQ, const OneEuroParams& params = OneEuroParams()) {
+        _dt = 1.f / max(rate, 1.f);
+        for (size_t k = 0; k < N; k++) { setParams(k, params); }
+    }
+
+    void setParams(size_t channel, const OneEuroParams& params) {
+        if (channel >= N) { return; }
+        _params[channel] = params;
+        _dAlpha[channel] = alpha(params.dCutoff, _dt);
+    }
+
+    const OneEuroParams& getParams(size_t channel) const { return _params[channel < N ? channel : 0]; }
+
+    void reset() { _primed = false; }
+
+    // One sample at the nominal rate
+    Vector<float, N> apply(const Vector<float, N>& x) {
+        if (!_primed) { return prime(x); }
+        Vector<float, N> y;
+        for (size_t k = 0; k < N; k++) { y[k] = step(k, x[k], _dt, _dAlpha[k]); }
+        return y;
+    }
+
+    // One sample dt seconds after the previous, for irregular sources
+    Vector<float, N> apply(const Vector<float, N>& x, float dt) {
+        if (!_primed || dt <= 0.f) { return _primed ? current() : prime(x); }
+        Vector<float, N> y;
+        for (size_t k = 0; k < N; k++) { y[k] = step(k, x[k], dt, alpha(_params[k].dCutoff, dt)); }
+        return y;
+    }
+
+    // Single channel convenience
+    template<size_t M = N, typename = std::enable_if_t<M == 1>>
+    float apply(float x) { return apply(Vector<float, 1>(x))[0]; }
+
+    Vector<float, N> current() const {
+        Vector<float, N> y;
+        for (size_t k = 0; k < N; k++) { y[k] = _x[k]; }
+        return y;
+    }
+};
+
+/**********************************************************************************/
+// Second-order Butterworth low-pass (bilinear transform, one biquad per
+// channel): the fixed filter the One-Euro stage is measured against.
+template<size_t N>
+class ButterworthFilter {
+    static_assert(N >= 1, "ButterworthFilter needs at least one channel");
+
+private:
+    float _b0, _b1, _b2, _a1, _a2;
+    float _z1[N] = {}, _z2[N] = {};         // Transposed direct form II state
+    bool _primed = false;
+
+public:
+    ButterworthFilter(float cutoff = 5.f, float rate = SMPL_FREQ) { setCutoff(cutoff, rate); }
+
+    void setCutoff(float cutoff, float rate = SMPL_FREQ) {
+        const float k = tanf(PI * constrain(cutoff, 0.001f, 0.49f * rate) / rate);
+        const float norm = 1.f / (1.f + M_SQRT2 * k + k * k);
+        _b0 = k * k * norm;
+        _b1 = 2.f * _b0;
+        _b2 = _b0;
+        _a1 = 2.f * (k * k - 1.f) * norm;
+        _a2 = (1.f - M_SQRT2 * k + k * k) * norm;
+        _primed = false;
+    }
+
+    void reset() { _primed = false; }
+
+    Vector<float, N> apply(const Vector<float, N>& x) {
+        Vector<float, N> y;
+        for (size_t k = 0; k < N; k++) {
+            if (!_primed) {                 // Start settled on the first sample
+                _z1[k] = x[k] * (1.f - _b0);
+                _z2[k] = x[k] * (_b2 - _a2);
+            }
+            y[k] = _b0 * x[k] + _z1[k];
+            _z1[k] = _b1 * x[k] - _a1 * y[k] + _z2[k];
+            _z2[k] = _b2 * x[k] - _a2 * y[k];
+        }
+        _primed = true;
+        return y;
+    }
+};
+
+/**********************************************************************************/
+
+#endif
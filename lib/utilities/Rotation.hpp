@@ -0,0 +1,106 @@
+#ifndef ROTATION_HPP
+#define ROTATION_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+#include <type_traits>
+#include "vectors.hpp"
+
+/**********************************************************************************/
+// constexpr sine/cosine for baking fixed angles into matrices at compile
+// time (libm's aren't constexpr). Range-reduced Taylor series, good to
+// ~1e-7 over a full turn; not meant for per-sample use.
+namespace ConstMath {
+    constexpr double PI_D = 3.14159265358979323846;
+
+    constexpr double wrap(double rad) {
+        while (rad > PI_D) { rad -= 2 * PI_D; }
+        while (rad < -PI_D) { rad += 2 * PI_D; }
+        return rad;
+    }
+
+    constexpr double sin(double rad) {
+        const double x = wrap(rad);
+        double term = x, sum = x;
+        for (int n = 1; n < 12; n++) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cos(double rad) { return sin(rad + PI_D / 2); }
+    constexpr double radians(double deg) { return deg * PI_D / 180; }
+}
+
+/**********************************************************************************/
+// 3x3 matrix, row-major, for rotating Vec3f samples. An aggregate of plain
+// floats, so it is trivially copyable and fits a Seqlock.
+struct Mat3 {
+    float m[3][3];
+
+    static constexpr Mat3 identity() { return {{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}}; }
+
+    constexpr Vec3f operator*(const Vec3f& v) const {
+        return Vec3f(m[0][0] * v[0] + m[0][1] * v[1] + m[0][2] * v[2],
+                     m[1][0] * v[0] + m[1][1] * v[1] + m[1][2] * v[2],
+                     m[2][0] * v[0] + m[2][1] * v[1] + m[2][2] * v[2]);
+    }
+
+    constexpr Mat3 operator*(const Mat3& o) const {
+        Mat3 r{};
+        for (uint8_t i = 0; i < 3; i++) {
+            for (uint8_t j = 0; j < 3; j++) {
+                r.m[i][j] = m[i][0] * o.m[0][j] + m[i][1] * o.m[1][j] + m[i][2] * o.m[2][j];
+            }
+        }
+        return r;
+    }
+
+    // Inverse, for a rotation
+    constexpr Mat3 transposed() const {
+        return {{{m[0][0], m[1][0], m[2][0]}, {m[0][1], m[1][1], m[2][1]}, {m[0][2], m[1][2], m[2][2]}}};
+    }
+};
+static_assert(std::is_trivially_copyable<Mat3>::value && sizeof(Mat3) == 9 * sizeof(float), "Mat3 must stay plain data");
+
+// Right-handed rotations by `deg` about each axis
+constexpr Mat3 rotationX(double deg) {
+    const float c = ConstMath::cos(ConstMath::radians(deg)), s = ConstMath::sin(ConstMath::radians(deg));
+    return {{{1, 0, 0}, {0, c, -s}, {0, s, c}}};
+}
+constexpr Mat3 rotationY(double deg) {
+    const float c = ConstMath::cos(ConstMath::radians(deg)), s = ConstMath::sin(ConstMath::radians(deg));
+    return {{{c, 0, s}, {0, 1, 0}, {-s, 0, c}}};
+}
+constexpr Mat3 rotationZ(double deg) {
+    const float c = ConstMath::cos(ConstMath::radians(deg)), s = ConstMath::sin(ConstMath::radians(deg));
+    return {{{c, -s, 0}, {s, c, 0}, {0, 0, 1}}};
+}
+
+// Orientation of a sensor in its host frame as roll (X), pitch (Y), yaw (Z)
+// applied in that order. The matrix maps sensor-frame readings into the
+// host frame.
+constexpr Mat3 mountMatrix(double rollDeg, double pitchDeg, double yawDeg = 0) {
+    return rotationZ(yawDeg) * rotationY(pitchDeg) * rotationX(rollDeg);
+}
+
+// Smallest rotation taking the direction of `from` onto +Z (Rodrigues).
+// Yaw about Z can't be seen from gravity alone, so none is introduced.
+inline Mat3 alignToZ(const Vec3f& from) {
+    Vec3f g = from;
+    if (g.magnitude() <= 0.f) { return Mat3::identity(); }
+    g.normalize();
+    const float c = g[2];                               // cos(angle) = g . z
+    const Vec3f axis(g[1], -g[0], 0.f);                 // g x z, |axis| = sin(angle)
+    if (c < -0.9999f) { return rotationX(180); }        // Upside down: any half turn
+    const float k = 1.f / (1.f + c);
+    const float x = axis[0], y = axis[1];
+    return {{{c + x * x * k, x * y * k, y},
+             {x * y * k, c + y * y * k, -x},
+             {-y, x, c}}};
+}
+/**********************************************************************************/
+
+#endif
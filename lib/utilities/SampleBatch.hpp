@@ -0,0 +1,143 @@
+#ifndef SAMPLE_BATCH_HPP
+#define SAMPLE_BATCH_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+#include <type_traits>
+#include "vectors.hpp"
+
+// esp-dsp ships with the ESP32 Arduino core; its float kernels use the
+// S3's SIMD/loop instructions. Elsewhere the plain loops below are written
+// so the compiler can vectorise them.
+#if defined(ARDUINO_ARCH_ESP32) && __has_include(<esp_dsp.h>)
+#include <esp_dsp.h>
+#define SAMPLE_BATCH_DSP 1
+#else
+#define SAMPLE_BATCH_DSP 0
+#endif
+
+/**********************************************************************************/
+// atan2 for the batch tilt projection: a branch-free polynomial (selects,
+// not jumps) that vectorises, unlike libm's. Max error ~2e-6 rad (1e-4
+// deg), far below accelerometer noise.
+inline float fastAtan2(float y, float x) {
+    const float ax = fabsf(x), ay = fabsf(y);
+    const float a = fminf(ax, ay) / (fmaxf(ax, ay) + 1e-30f);
+    const float s = a * a;
+    float r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f
+            + s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+    r = ay > ax ? 1.57079637f - r : r;
+    r = x < 0.f ? 3.14159274f - r : r;
+    return y < 0.f ? -r : r;
+}
+
+/**********************************************************************************/
+// A run of Vector<T, N> samples stored structure-of-arrays: one contiguous,
+// aligned lane per component. The kernels sweep whole lanes, so a FIFO
+// burst or a replayed log is processed in one pass per step instead of one
+// call chain per sample.
+template<typename T, size_t N, size_t Capacity>
+class SampleBatch {
+    static_assert(std::is_arithmetic<T>::value, "SampleBatch must use arithmetic types");
+    static_assert(Capacity >= 1, "SampleBatch needs room for a sample");
+
+private:
+    alignas(16) T _lane[N][Capacity];
+    size_t _count = 0;
+
+    static constexpr bool DSP = SAMPLE_BATCH_DSP && std::is_same<T, float>::value;
+
+public:
+
+    bool push(const Vector<T, N>& sample) {
+        if (_count >= Capacity) { return false; }
+        for (size_t k = 0; k < N; k++) { _lane[k][_count] = sample[k]; }
+        _count++;
+        return true;
+    }
+
+    Vector<T, N> get(size_t i) const {
+        Vector<T, N> sample;
+        for (size_t k = 0; k < N; k++) { sample[k] = _lane[k][i]; }
+        return sample;
+    }
+
+    // Direct lane access, for producers that fill lanes themselves; call
+    // resize() with the sample count afterwards
+    T* lane(size_t k) { return _lane[k]; }
+    const T* lane(size_t k) const { return _lane[k]; }
+    void resize(size_t count) { _count = min(count, Capacity); }
+
+    void clear() { _count = 0; }
+    size_t size() const { return _count; }
+    bool full() const { return _count >= Capacity; }
+    static constexpr size_t capacity() { return Capacity; }
+    static constexpr size_t dimension() { return N; }
+
+    // sample -= offset
+    void subtract(const Vector<T, N>& offset) {
+        for (size_t k = 0; k < N; k++) {
+            T* __restrict x = _lane[k];
+            const T c = offset[k];
+            if constexpr (DSP) { dsps_addc_f32(x, x, _count, -c, 1, 1); }
+            else { for (size_t i = 0; i < _count; i++) { x[i] -= c; } }
+        }
+    }
+
+    // sample *= gain
+    void scale(T gain) {
+        for (size_t k = 0; k < N; k++) {
+            T* __restrict x = _lane[k];
+            if constexpr (DSP) { dsps_mulc_f32(x, x, _count, gain, 1, 1); }
+            else { for (size_t i = 0; i < _count; i++) { x[i] *= gain; } }
+        }
+    }
+
+    // Each component into [lo, hi]
+    void clip(T lo, T hi) {
+        for (size_t k = 0; k < N; k++) {
+            T* __restrict x = _lane[k];
+            for (size_t i = 0; i < _count; i++) {
+                const T v = x[i] < lo ? lo : x[i];
+                x[i] = v > hi ? hi : v;
+            }
+        }
+    }
+
+    // Cubic response curve, x -> x^3, as Joystick::read() applies it
+    void cube() {
+        for (size_t k = 0; k < N; k++) {
+            T* __restrict x = _lane[k];
+            if constexpr (DSP) {
+                float sq[Capacity];
+                dsps_mul_f32(x, x, sq, _count, 1, 1, 1);
+                dsps_mul_f32(sq, x, x, _count, 1, 1, 1);
+            } else {
+                for (size_t i = 0; i < _count; i++) { x[i] = x[i] * x[i] * x[i]; }
+            }
+        }
+    }
+};
+
+/**********************************************************************************/
+// Batch form of tiltProjection(): (pitch, roll) in degrees for every sample
+template<typename T, size_t Capacity>
+void tiltProjection(const SampleBatch<T, 3, Capacity>& in, SampleBatch<T, 2, Capacity>& out) {
+    static_assert(std::is_floating_point<T>::value, "Tilt projection requires floating point types");
+    const T* __restrict x = in.lane(0);
+    const T* __restrict y = in.lane(1);
+    const T* __restrict z = in.lane(2);
+    T* __restrict pitch = out.lane(0);
+    T* __restrict roll = out.lane(1);
+    const size_t n = in.size();
+    for (size_t i = 0; i < n; i++) {
+        pitch[i] = fastAtan2(-x[i], sqrtf(y[i] * y[i] + z[i] * z[i])) * static_cast<T>(RAD_TO_DEG);
+        roll[i] = fastAtan2(y[i], z[i]) * static_cast<T>(RAD_TO_DEG);
+    }
+    out.resize(n);
+}
+
+/**********************************************************************************/
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include <string.h>
+
+/****************************************************************************/
+// Single-writer, multi-reader publication of a small POD. The writer never
+// waits: it bumps the sequence to odd, copies, bumps it back to even.
+// Readers copy and retry if the sequence was odd or moved underneath them,
+// so they never see a torn value.
+//
+// A reader spins while a write is in progress, so keep the writer on the
+// other core (or at a higher priority) than its readers; tryRead() is the
+// non-spinning variant.
+template<typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock needs a trivially copyable type");
+
+private:
+    std::atomic<uint32_t> _seq{0};
+    T _data{};
+    mutable std::atomic<uint32_t> _retries{0};
+
+    bool attempt(T& out) const {
+        const uint32_t s0 = _seq.load(std::memory_order_acquire);
+        if (s0 & 1) { return false; }
+        memcpy(&out, &_data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _seq.load(std::memory_order_relaxed) == s0;
+    }
+
+public:
+
+    void write(const T& value) {
+        const uint32_t s = _seq.load(std::memory_order_relaxed);
+        _seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&_data, &value, sizeof(T));
+        _seq.store(s + 2, std::memory_order_release);
+    }
+
+    T read() const {
+        T out;
+        while (!attempt(out)) { _retries.fetch_add(1, std::memory_order_relaxed); }
+        return out;
+    }
+
+    // false if a write was in progress; `out` is then unspecified
+    bool tryRead(T& out) const {
+        if (attempt(out)) { return true; }
+        _retries.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Twice the number of completed writes, odd while one is in progress
+    uint32_t version() const { return _seq.load(std::memory_order_acquire); }
+    uint32_t retries() const { return _retries.load(std::memory_order_relaxed); }
+};
+/****************************************************************************/
+
+#endif
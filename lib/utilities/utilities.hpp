@@ -11,6 +11,11 @@ constexpr uint32_t I2C_CLK = 0x61A80; // 400 Hz, High Speed!
 
 constexpr float SMPL_FREQ = 100.f; 
 
+// Core split: sensors, filtering & buttons on one; USB HID, LEDs & display
+// (and the Arduino loop()) on the other
+constexpr uint8_t ACQUIRE_CORE = 0;
+constexpr uint8_t OUTPUT_CORE = 1;
+
 /****************************************************************************/
 static inline bool setWire(
     uint8_t sdaPin = SDA_PIN, 
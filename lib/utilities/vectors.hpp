@@ -6,123 +6,127 @@
 #include <Arduino.h>
 #include <math.h>
 #include <type_traits>
+#include <utility>
+
+/**********************************************************************************/
+// Component types a Vector accepts: arithmetic types, plus number-like
+// classes that opt in by specialising this (see Fixed.hpp)
+template<typename T>
+struct IsVectorScalar : std::is_arithmetic<T> {};
 
 /**********************************************************************************/
 // Templated Vector class - T: type, N: dimension
+// Trivially copyable and constexpr: copies are plain memberwise copies (safe
+// to memcpy into ring buffers and reports), and the element-wise operations
+// expand to one statement per component via fold expressions, so they are
+// unrolled for any N without relying on the optimiser.
 template<typename T, size_t N>
 class Vector {
     static_assert(N >= 1, "Vector dimension must be at least 1");
-    static_assert(std::is_arithmetic<T>::value, "Vector must use arithmetic types");
+    static_assert(IsVectorScalar<T>::value, "Vector must use arithmetic (or IsVectorScalar) types");
 
 private:
-    T data[N];
+    T data[N]{};
+
+    using Indices = std::make_index_sequence<N>;
+
+    template<size_t... I>
+    constexpr void fill(T value, std::index_sequence<I...>) { ((data[I] = value), ...); }
+    template<size_t... I>
+    constexpr void add(const Vector& other, std::index_sequence<I...>) { ((data[I] += other.data[I]), ...); }
+    template<size_t... I>
+    constexpr void sub(const Vector& other, std::index_sequence<I...>) { ((data[I] -= other.data[I]), ...); }
+    template<size_t... I>
+    constexpr void mul(T scalar, std::index_sequence<I...>) { ((data[I] *= scalar), ...); }
+    template<size_t... I>
+    constexpr void div(T scalar, std::index_sequence<I...>) { ((data[I] /= scalar), ...); }
+    template<size_t... I>
+    constexpr bool equal(const Vector& other, std::index_sequence<I...>) const { return ((data[I] == other.data[I]) && ...); }
+    template<size_t... I>
+    constexpr T dotWith(const Vector& other, std::index_sequence<I...>) const { return ((data[I] * other.data[I]) + ...); }
 
 public:
     // Constructors
-    Vector() { 
-        for(size_t i = 0; i < N; ++i) data[i] = T(0); 
-    }
+    constexpr Vector() = default;
     
     // Single value constructor (all components same value)
-    explicit Vector(T value) {
-        for(size_t i = 0; i < N; ++i) data[i] = value;
-    }
+    constexpr explicit Vector(T value) { fill(value, Indices{}); }
     
     // Variadic constructor for initializing all components
-    template<typename... Args>
-    Vector(Args... args) : data{static_cast<T>(args)...} {
-        static_assert(sizeof...(Args) == N, "Number of arguments must match vector dimension");
-    }
-    
-    // Copy constructor
-    Vector(const Vector& other) {
-        for(size_t i = 0; i < N; ++i) data[i] = other.data[i];
-    }
+    template<typename... Args, typename = std::enable_if_t<sizeof...(Args) == N>>
+    constexpr Vector(Args... args) : data{static_cast<T>(args)...} {}
 
     // Array subscript operator
-    T& operator[](size_t index) { 
+    constexpr T& operator[](size_t index) { 
         return data[index]; 
     }
     
-    const T& operator[](size_t index) const { 
+    constexpr const T& operator[](size_t index) const { 
         return data[index]; 
     }
 
-    // Assignment operator
-    Vector& operator=(const Vector& other) {
-        if (this != &other) {
-            for(size_t i = 0; i < N; ++i) data[i] = other.data[i];
-        }
-        return *this;
-    }
-
     // += Operator
-    Vector& operator+=(const Vector& other) {
-        for(size_t i = 0; i < N; ++i) data[i] += other.data[i];
+    constexpr Vector& operator+=(const Vector& other) {
+        add(other, Indices{});
         return *this;
     }
 
     // + Operator
-    Vector operator+(const Vector& other) const {
+    constexpr Vector operator+(const Vector& other) const {
         Vector result = *this;
         result += other;
         return result;
     }
 
     // -= Operator
-    Vector& operator-=(const Vector& other) {
-        for(size_t i = 0; i < N; ++i) data[i] -= other.data[i];
+    constexpr Vector& operator-=(const Vector& other) {
+        sub(other, Indices{});
         return *this;
     }
 
     // - Operator
-    Vector operator-(const Vector& other) const {
+    constexpr Vector operator-(const Vector& other) const {
         Vector result = *this;
         result -= other;
         return result;
     }
 
     // *= Scalar Operator
-    Vector& operator*=(T scalar) {
-        for(size_t i = 0; i < N; ++i) data[i] *= scalar;
+    constexpr Vector& operator*=(T scalar) {
+        mul(scalar, Indices{});
         return *this;
     }
 
     // * Scalar Operators
-    Vector operator*(T scalar) const {
+    constexpr Vector operator*(T scalar) const {
         Vector result = *this;
         result *= scalar;
         return result;
     }
 
-    friend Vector operator*(T scalar, const Vector& vec) {
+    friend constexpr Vector operator*(T scalar, const Vector& vec) {
         return vec * scalar;
     }
 
     // /= Scalar Operator
-    Vector& operator/=(T scalar) {
-        if (scalar != T(0)) {
-            for(size_t i = 0; i < N; ++i) data[i] /= scalar;
-        }
+    constexpr Vector& operator/=(T scalar) {
+        if (scalar != T(0)) { div(scalar, Indices{}); }
         return *this;
     }
 
     // / Scalar Operator
-    Vector operator/(T scalar) const {
+    constexpr Vector operator/(T scalar) const {
         Vector result = *this;
         result /= scalar;
         return result;
     }
 
     // Equality operators
-    bool operator==(const Vector& other) const {
-        for(size_t i = 0; i < N; ++i) {
-            if(data[i] != other.data[i]) return false;
-        }
-        return true;
+    constexpr bool operator==(const Vector& other) const {
+        return equal(other, Indices{});
     }
 
-    bool operator!=(const Vector& other) const {
+    constexpr bool operator!=(const Vector& other) const {
         return !(*this == other);
     }
 
@@ -130,29 +134,24 @@ public:
     template<typename U = T>
     typename std::enable_if<std::is_floating_point<U>::value, float>::type
     magnitude() const {
-        float sum = 0;
-        for(size_t i = 0; i < N; ++i) {
-            sum += static_cast<float>(data[i]) * static_cast<float>(data[i]);
-        }
-        return sqrtf(sum);
+        return sqrtf(static_cast<float>(magnitudeSquared()));
+    }
+
+    // Magnitude for number-like classes, via their vectorMagnitude()
+    template<typename U = T>
+    constexpr typename std::enable_if<!std::is_arithmetic<U>::value, U>::type
+    magnitude() const {
+        return vectorMagnitude(*this);
     }
 
     // Magnitude squared (works for all arithmetic types)
-    T magnitudeSquared() const {
-        T sum = T(0);
-        for(size_t i = 0; i < N; ++i) {
-            sum += data[i] * data[i];
-        }
-        return sum;
+    constexpr T magnitudeSquared() const {
+        return dotWith(*this, Indices{});
     }
 
     // Dot product
-    T dot(const Vector& other) const {
-        T result = T(0);
-        for(size_t i = 0; i < N; ++i) {
-            result += data[i] * other.data[i];
-        }
-        return result;
+    constexpr T dot(const Vector& other) const {
+        return dotWith(other, Indices{});
     }
 
     // Normalize (only for floating point types)
@@ -166,10 +165,18 @@ public:
         return *this;
     }
 
+    // Normalize for number-like classes; a zero vector stays zero
+    template<typename U = T>
+    constexpr typename std::enable_if<!std::is_arithmetic<U>::value, Vector&>::type
+    normalize() {
+        return *this /= magnitude();
+    }
+
     // Print to stream
     void print(Stream& stream, int precision = 2, String delim = "\t", bool newLine = true) const {
         for(size_t i = 0; i < N; ++i) {
-            stream.print(data[i], precision);
+            if constexpr (std::is_arithmetic<T>::value) { stream.print(data[i], precision); }
+            else { stream.print(static_cast<float>(data[i]), precision); }
             if(i < N - 1) stream.print(delim);
         }
         if(newLine) stream.println();
@@ -180,15 +187,19 @@ public:
 
     // Valid Entry Checks
     bool hasNaN() const {
-        for(size_t i = 0; i < N; ++i) {
-            if (isnan(data[i])) return true;
+        if constexpr (std::is_floating_point<T>::value) {
+            for(size_t i = 0; i < N; ++i) {
+                if (isnan(data[i])) return true;
+            }
         }
         return false;
     }
     
     bool isValid() const {
-        for(size_t i = 0; i < N; ++i) {
-            if (isnan(data[i]) || isinf(data[i])) return false;
+        if constexpr (std::is_floating_point<T>::value) {
+            for(size_t i = 0; i < N; ++i) {
+                if (isnan(data[i]) || isinf(data[i])) return false;
+            }
         }
         return true;
     }
@@ -196,7 +207,7 @@ public:
 /**********************************************************************************/
 // Specialized cross product for 3D vectors
 template<typename T>
-Vector<T, 3> cross(const Vector<T, 3>& a, const Vector<T, 3>& b) {
+constexpr Vector<T, 3> cross(const Vector<T, 3>& a, const Vector<T, 3>& b) {
     return Vector<T, 3>(
         a[1] * b[2] - a[2] * b[1],
         a[2] * b[0] - a[0] * b[2],
@@ -225,5 +236,23 @@ using Vec2i = Vector<int, 2>;
 using Vec3i = Vector<int, 3>;
 using Vec2d = Vector<double, 2>;
 using Vec3d = Vector<double, 3>;
+
+static_assert(std::is_trivially_copyable<Vec3f>::value && std::is_trivially_copyable<Vec2i>::value,
+              "Vector must stay trivially copyable");
+static_assert(sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Vec2d) == 2 * sizeof(double),
+              "Vector must carry no padding or extra state");
+/**********************************************************************************/
+// Compile-time checks of the vector math
+namespace VectorChecks {
+    constexpr Vec3i a(1, 2, 3), b(4, 5, 6);
+    static_assert(Vec3i() == Vec3i(0, 0, 0), "Default not zero");
+    static_assert(Vec3i(7) == Vec3i(7, 7, 7), "Fill constructor");
+    static_assert(a + b == Vec3i(5, 7, 9) && b - a == Vec3i(3, 3, 3), "Addition / subtraction");
+    static_assert(a * 2 == 2 * a && a * 2 == Vec3i(2, 4, 6) && b / 2 == Vec3i(2, 2, 3), "Scaling");
+    static_assert(a / 0 == a, "Division by zero leaves the vector alone");
+    static_assert(a.dot(b) == 32 && a.magnitudeSquared() == 14, "Dot product");
+    static_assert(cross(a, b) == Vec3i(-3, 6, -3) && cross(a, b).dot(a) == 0, "Cross product");
+    static_assert((Vec2f(1.5f, -2.f) * 2.f)[1] == -4.f, "Float scaling");
+}
 /**********************************************************************************/
 #endif
\ No newline at end of file
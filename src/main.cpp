@@ -1,29 +1,27 @@
 #include "Solenoid.hpp"
+#include "CoilScheduler.hpp"
 
 Solenoid solenoid(1, 0);
+CoilScheduler coils;
+int8_t thumper = -1;
+
+// 20 ms full kick, then hold at ~30% until released
+constexpr PulseProfile THUMPER_PULSE = {20000, 4095, 1229, 3000000};
+
+uint32_t lastFire = 0;
 
 void setup() {
     Serial.begin(115200);
     solenoid.begin();
-    
-    // Simple on/off test - no PWM
-    Serial.println("TEST: Turning solenoid ON");
-    digitalWrite(1, HIGH);  // Bypass PWM, force pin high
-    delay(2000);
-    
-    Serial.println("TEST: Turning solenoid OFF"); 
-    digitalWrite(1, LOW);   // Force pin low
-    delay(2000);
+    thumper = coils.add(solenoid, THUMPER_PULSE);
 }
 
 void loop() {
-    // Your 30% duty cycle test
-    Serial.println("30% duty cycle for 3s");
-    solenoid.setDutyPercentage(30.0f);
-    Serial.printf("Duty set to: %d (%.1f%%)\n", solenoid.getDuty(), solenoid.getDutyPercentage());
-    delay(3000);
-    
-    solenoid.off();
-    Serial.println("OFF for 10s");
-    delay(10000);
-}
\ No newline at end of file
+    // Fire for 3s every 13s; the scheduler runs kick/hold/release itself
+    if (millis() - lastFire >= 13000) {
+        lastFire = millis();
+        Serial.println("Kick then 30% hold for 3s");
+        coils.fire(thumper, 3000000);
+        coils.printStats();
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef NATIVE_ADAFRUIT_ADXL345_U_H
+#define NATIVE_ADAFRUIT_ADXL345_U_H
+
+// Adafruit ADXL345 driver over the Wire stand-in. Every register access is
+// a real I2C transaction, so a test that plugs a device model into
+// native::i2c[ADXL345_DEFAULT_ADDRESS] sees the driver's bus traffic.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "Adafruit_Sensor.h"
+
+#define ADXL345_DEFAULT_ADDRESS (0x53)
+#define ADXL345_REG_DEVID (0x00)
+#define ADXL345_REG_BW_RATE (0x2C)
+#define ADXL345_REG_POWER_CTL (0x2D)
+#define ADXL345_REG_DATA_FORMAT (0x31)
+#define ADXL345_REG_DATAX0 (0x32)
+#define ADXL345_REG_FIFO_CTL (0x38)
+#define ADXL345_REG_FIFO_STATUS (0x39)
+#define ADXL345_MG2G_MULTIPLIER (0.004)
+
+typedef enum {
+    ADXL345_RANGE_16_G = 0b11,
+    ADXL345_RANGE_8_G = 0b10,
+    ADXL345_RANGE_4_G = 0b01,
+    ADXL345_RANGE_2_G = 0b00
+} range_t;
+
+typedef enum {
+    ADXL345_DATARATE_3200_HZ = 0b1111,
+    ADXL345_DATARATE_1600_HZ = 0b1110,
+    ADXL345_DATARATE_800_HZ = 0b1101,
+    ADXL345_DATARATE_400_HZ = 0b1100,
+    ADXL345_DATARATE_200_HZ = 0b1011,
+    ADXL345_DATARATE_100_HZ = 0b1010,
+    ADXL345_DATARATE_50_HZ = 0b1001,
+    ADXL345_DATARATE_25_HZ = 0b1000,
+    ADXL345_DATARATE_12_5_HZ = 0b0111,
+    ADXL345_DATARATE_6_25HZ = 0b0110,
+    ADXL345_DATARATE_3_13_HZ = 0b0101,
+    ADXL345_DATARATE_1_56_HZ = 0b0100,
+    ADXL345_DATARATE_0_78_HZ = 0b0011,
+    ADXL345_DATARATE_0_39_HZ = 0b0010,
+    ADXL345_DATARATE_0_20_HZ = 0b0001,
+    ADXL345_DATARATE_0_10_HZ = 0b0000
+} dataRate_t;
+
+class Adafruit_ADXL345_Unified {
+private:
+    int32_t _sensorID;
+    uint8_t _address = ADXL345_DEFAULT_ADDRESS;
+
+public:
+    explicit Adafruit_ADXL345_Unified(int32_t sensorID = -1) : _sensorID(sensorID) {}
+
+    bool begin(uint8_t address = ADXL345_DEFAULT_ADDRESS) {
+        _address = address;
+        if (readRegister(ADXL345_REG_DEVID) != 0xE5) { return false; }
+        writeRegister(ADXL345_REG_POWER_CTL, 0x08);
+        return true;
+    }
+
+    void writeRegister(uint8_t reg, uint8_t value) {
+        Wire.beginTransmission(_address);
+        Wire.write(reg);
+        Wire.write(value);
+        Wire.endTransmission();
+    }
+
+    uint8_t readRegister(uint8_t reg) {
+        Wire.beginTransmission(_address);
+        Wire.write(reg);
+        Wire.endTransmission();
+        Wire.requestFrom(_address, static_cast<size_t>(1));
+        return static_cast<uint8_t>(Wire.read());
+    }
+
+    int16_t read16(uint8_t reg) {
+        Wire.beginTransmission(_address);
+        Wire.write(reg);
+        Wire.endTransmission();
+        Wire.requestFrom(_address, static_cast<size_t>(2));
+        const uint8_t lo = static_cast<uint8_t>(Wire.read());
+        return static_cast<int16_t>(lo | (Wire.read() << 8));
+    }
+
+    int16_t getX() { return read16(ADXL345_REG_DATAX0); }
+    int16_t getY() { return read16(ADXL345_REG_DATAX0 + 2); }
+    int16_t getZ() { return read16(ADXL345_REG_DATAX0 + 4); }
+
+    void setRange(range_t range) {
+        writeRegister(ADXL345_REG_DATA_FORMAT, (readRegister(ADXL345_REG_DATA_FORMAT) & ~0x0F) | range | 0x08);
+    }
+    range_t getRange() { return static_cast<range_t>(readRegister(ADXL345_REG_DATA_FORMAT) & 0x03); }
+    void setDataRate(dataRate_t rate) { writeRegister(ADXL345_REG_BW_RATE, rate); }
+    dataRate_t getDataRate() { return static_cast<dataRate_t>(readRegister(ADXL345_REG_BW_RATE) & 0x0F); }
+
+    bool getEvent(sensors_event_t* event) {
+        memset(event, 0, sizeof(sensors_event_t));
+        event->sensor_id = _sensorID;
+        event->timestamp = static_cast<int32_t>(millis());
+        event->acceleration.x = getX() * ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD;
+        event->acceleration.y = getY() * ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD;
+        event->acceleration.z = getZ() * ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD;
+        return true;
+    }
+};
+
+#endif
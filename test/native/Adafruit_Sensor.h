@@ -0,0 +1,30 @@
+#ifndef NATIVE_ADAFRUIT_SENSOR_H
+#define NATIVE_ADAFRUIT_SENSOR_H
+
+// Unified sensor types, as much of them as the accelerometer code reads
+
+#include <Arduino.h>
+
+#define SENSORS_GRAVITY_STANDARD (9.80665F)
+#define SENSORS_GRAVITY_EARTH (SENSORS_GRAVITY_STANDARD)
+
+typedef struct {
+    union {
+        float v[3];
+        struct { float x, y, z; };
+    };
+} sensors_vec_t;
+
+typedef struct {
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    int32_t reserved0;
+    int32_t timestamp;
+    union {
+        float data[4];
+        sensors_vec_t acceleration;
+    };
+} sensors_event_t;
+
+#endif
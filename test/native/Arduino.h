@@ -0,0 +1,223 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Host stand-in for the slice of the Arduino-ESP32 core the libraries use,
+// so their hardware-free logic builds and runs under `pio test -e native`.
+// Time is virtual: micros()/millis() only move when a test advances them
+// (native::advanceUs(), delay()), which keeps timing tests deterministic.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+
+/****************************************************************************/
+#define IRAM_ATTR
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define HEX 16
+#define DEC 10
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+using std::min;
+using std::max;
+using std::isnan;
+using std::isinf;
+
+template<typename T, typename L, typename H>
+constexpr T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+typedef uint8_t byte;
+
+/****************************************************************************/
+namespace native {
+    inline uint64_t clockUs = 0;
+
+    // Run as the clock moves; esp_timer.h uses it to fire due timers
+    inline void (*clockHook)(uint64_t target) = nullptr;
+
+    inline void advanceUs(uint64_t us) {
+        const uint64_t target = clockUs + us;
+        if (clockHook) { clockHook(target); }
+        clockUs = target;
+    }
+
+    inline void resetClock(uint64_t us = 0) { clockUs = us; }
+
+    // Pin levels written by digitalWrite(), readable by the test
+    inline uint8_t pinLevel[64] = {};
+    inline uint8_t pinModeOf[64] = {};
+}
+
+// 32 bits wide, as unsigned long is on the target, so they wrap the same way
+inline uint32_t micros() { return static_cast<uint32_t>(native::clockUs); }
+inline uint32_t millis() { return static_cast<uint32_t>(native::clockUs / 1000); }
+inline void delay(uint32_t ms) { native::advanceUs(static_cast<uint64_t>(ms) * 1000); }
+inline void delayMicroseconds(uint32_t us) { native::advanceUs(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t pin, uint8_t mode) { native::pinModeOf[pin & 63] = mode; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { native::pinLevel[pin & 63] = level ? HIGH : LOW; }
+inline int digitalRead(uint8_t pin) { return native::pinLevel[pin & 63]; }
+
+inline long random(long hi) { return hi > 0 ? std::rand() % hi : 0; }
+inline long random(long lo, long hi) { return hi > lo ? lo + std::rand() % (hi - lo) : lo; }
+inline void randomSeed(unsigned long seed) { std::srand(static_cast<unsigned>(seed)); }
+
+/****************************************************************************/
+class String {
+    std::string _s;
+public:
+    String(const char* s = "") : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v, unsigned char base = DEC) : _s(fmt(static_cast<long>(v), base)) {}
+    String(unsigned v, unsigned char base = DEC) : _s(fmt(static_cast<long>(v), base)) {}
+    String(long v, unsigned char base = DEC) : _s(fmt(v, base)) {}
+    String(unsigned long v, unsigned char base = DEC) : _s(fmt(static_cast<long>(v), base)) {}
+    String(float v, unsigned char decimals = 2) : _s(fmtf(v, decimals)) {}
+    String(double v, unsigned char decimals = 2) : _s(fmtf(v, decimals)) {}
+
+    size_t length() const { return _s.size(); }
+    const char* c_str() const { return _s.c_str(); }
+    String operator+(const String& o) const { return String(_s + o._s); }
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator!=(const String& o) const { return _s != o._s; }
+
+private:
+    static std::string fmt(long v, unsigned char base) {
+        char buf[40];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", v);
+        return buf;
+    }
+    static std::string fmtf(double v, unsigned char decimals) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        return buf;
+    }
+};
+inline String operator+(const char* a, const String& b) { return String(a) + b; }
+
+/****************************************************************************/
+// Output goes to stdout only when a test asks for it, so suites stay quiet
+class Stream {
+public:
+    bool echo = false;
+
+    void begin(unsigned long) {}
+    void flush() {}
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t write(uint8_t c) { if (echo) { putchar(c); } return 1; }
+
+    // No format checking: the libraries print uint32_t with %lu, which is
+    // right on the target and only mismatched on a 64-bit host
+    size_t printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        const int n = echo ? vprintf(format, args) : vsnprintf(nullptr, 0, format, args);
+        va_end(args);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    size_t print(const String& s) { return printf("%s", s.c_str()); }
+    size_t print(const char* s) { return printf("%s", s); }
+    size_t print(char c) { return printf("%c", c); }
+    size_t print(int v, int base = DEC) { return print(String(v, static_cast<unsigned char>(base))); }
+    size_t print(unsigned v, int base = DEC) { return print(String(v, static_cast<unsigned char>(base))); }
+    size_t print(long v, int base = DEC) { return print(String(v, static_cast<unsigned char>(base))); }
+    size_t print(unsigned long v, int base = DEC) { return print(String(v, static_cast<unsigned char>(base))); }
+    size_t print(double v, int decimals = 2) { return print(String(v, static_cast<unsigned char>(decimals))); }
+
+    template<typename T>
+    size_t println(const T& v) { return print(v) + println(); }
+    template<typename T>
+    size_t println(const T& v, int format) { return print(v, format) + println(); }
+    size_t println() { return print("\n"); }
+
+    explicit operator bool() const { return true; }
+};
+using Print = Stream;
+using HardwareSerial = Stream;
+
+inline Stream Serial;
+
+/****************************************************************************/
+// Cycle counter at a nominal 240 MHz of virtual time
+class EspClass {
+public:
+    uint32_t getCycleCount() const { return static_cast<uint32_t>(native::clockUs * 240); }
+    uint32_t getCpuFreqMHz() const { return 240; }
+    uint32_t getFreeHeap() const { return 0; }
+};
+inline EspClass ESP;
+
+/****************************************************************************/
+// Critical sections are no-ops: host tests that race threads use their own
+// synchronisation
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+/****************************************************************************/
+// FreeRTOS task API. No task ever runs: tests drive the task bodies (pump(),
+// update()) by hand, on the virtual clock.
+typedef void* TaskHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+
+namespace native {
+    inline uint32_t taskNotifications = 0;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(void (*)(void*), const char*, uint32_t, void*, UBaseType_t,
+                                          TaskHandle_t* handle, BaseType_t) {
+    static int dummy;
+    if (handle) { *handle = &dummy; }
+    return pdPASS;
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline TickType_t xTaskGetTickCount() { return static_cast<TickType_t>(native::clockUs / 1000); }
+inline void vTaskDelay(TickType_t ticks) { native::advanceUs(static_cast<uint64_t>(ticks) * 1000); }
+inline void vTaskDelayUntil(TickType_t* wake, TickType_t ticks) {
+    *wake += ticks;
+    const uint64_t due = static_cast<uint64_t>(*wake) * 1000;
+    if (due > native::clockUs) { native::advanceUs(due - native::clockUs); }
+}
+inline void xTaskNotifyGive(TaskHandle_t) { native::taskNotifications++; }
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) {
+    const uint32_t n = native::taskNotifications;
+    native::taskNotifications = 0;
+    return n;
+}
+
+#include "esp32-hal-ledc.h"
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef NATIVE_BLE_GAMEPAD_H
+#define NATIVE_BLE_GAMEPAD_H
+
+// ESP32-BLE-Gamepad. sendReport() records the buttons and axes as they
+// would go out in one notification.
+
+#include <Arduino.h>
+#include <vector>
+#include "NimBLEDevice.h"
+
+#define CONTROLLER_TYPE_JOYSTICK 0x04
+#define CONTROLLER_TYPE_GAMEPAD 0x05
+
+namespace native {
+    struct BleNotification {
+        uint32_t buttons;                   // Bit k = button k+1
+        int16_t axes[3];
+        uint64_t atUs;
+    };
+    inline std::vector<BleNotification> bleNotifications;
+}
+
+class BleGamepadConfiguration {
+public:
+    bool autoReport = true;
+    uint16_t buttonCount = 16;
+    int16_t axesMin = 0, axesMax = 32767;
+
+    void setAutoReport(bool value) { autoReport = value; }
+    void setControllerType(uint8_t) {}
+    void setButtonCount(uint16_t value) { buttonCount = value; }
+    void setHatSwitchCount(uint8_t) {}
+    void setWhichAxes(bool, bool, bool, bool, bool, bool, bool, bool) {}
+    void setAxesMin(int16_t value) { axesMin = value; }
+    void setAxesMax(int16_t value) { axesMax = value; }
+};
+
+class BleGamepad {
+private:
+    uint32_t _buttons = 0;
+    int16_t _axes[3] = {};
+    bool _autoReport = true;
+
+public:
+    explicit BleGamepad(std::string name = "ESP32 BLE Gamepad", std::string manufacturer = "Espressif", uint8_t battery = 100) {}
+
+    void begin(BleGamepadConfiguration* config) { _autoReport = config->autoReport; }
+    bool isConnected() { return native::ble.connected; }
+
+    void press(uint8_t b) { if (b >= 1 && b <= 32) { _buttons |= 1u << (b - 1); } if (_autoReport) { sendReport(); } }
+    void release(uint8_t b) { if (b >= 1 && b <= 32) { _buttons &= ~(1u << (b - 1)); } if (_autoReport) { sendReport(); } }
+    void setAxes(int16_t x, int16_t y, int16_t z, int16_t, int16_t, int16_t, int16_t, int16_t) {
+        _axes[0] = x;
+        _axes[1] = y;
+        _axes[2] = z;
+        if (_autoReport) { sendReport(); }
+    }
+    void sendReport() {
+        if (!native::ble.connected) { return; }
+        native::bleNotifications.push_back({_buttons, {_axes[0], _axes[1], _axes[2]}, native::clockUs});
+    }
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef NATIVE_NIMBLE_DEVICE_H
+#define NATIVE_NIMBLE_DEVICE_H
+
+// The one BLE link the gamepad talks over. A test connects it and picks the
+// interval the central settles on; updateConnParams() records the request.
+
+#include <Arduino.h>
+
+namespace native {
+    struct BleLink {
+        bool connected = false;
+        uint16_t interval = 6;              // x1.25 ms
+        uint32_t paramRequests = 0;
+        uint16_t requestedMin = 0, requestedMax = 0, requestedLatency = 0, requestedTimeout = 0;
+    };
+    inline BleLink ble;
+
+    inline void resetBle() { ble = BleLink(); }
+}
+
+class NimBLEConnInfo {
+public:
+    uint16_t getConnHandle() const { return 0; }
+    uint16_t getConnInterval() const { return native::ble.interval; }
+    uint16_t getConnLatency() const { return 0; }
+};
+
+class NimBLEServer {
+public:
+    size_t getConnectedCount() { return native::ble.connected ? 1 : 0; }
+    NimBLEConnInfo getPeerInfo(size_t) { return NimBLEConnInfo(); }
+    void updateConnParams(uint16_t, uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout) {
+        native::ble.paramRequests++;
+        native::ble.requestedMin = minInterval;
+        native::ble.requestedMax = maxInterval;
+        native::ble.requestedLatency = latency;
+        native::ble.requestedTimeout = timeout;
+    }
+};
+
+class NimBLEDevice {
+public:
+    static NimBLEServer* getServer() {
+        static NimBLEServer server;
+        return &server;
+    }
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef NATIVE_USB_H
+#define NATIVE_USB_H
+
+#include <Arduino.h>
+
+class ESPUSB {
+public:
+    bool begin() { return true; }
+    explicit operator bool() const { return true; }
+};
+inline ESPUSB USB;
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef NATIVE_USBHID_H
+#define NATIVE_USBHID_H
+
+// TinyUSB HID device class. SendReport() records the last report per ID so
+// tests can decode what a device would have put on the wire.
+
+#include <Arduino.h>
+#include <vector>
+
+class USBHIDDevice {
+public:
+    virtual uint16_t _onGetDescriptor(uint8_t* buffer) { return 0; }
+    virtual uint16_t _onGetFeature(uint8_t report_id, uint8_t* buffer, uint16_t len) { return 0; }
+    virtual void _onSetFeature(uint8_t report_id, const uint8_t* buffer, uint16_t len) {}
+    virtual void _onOutput(uint8_t report_id, const uint8_t* buffer, uint16_t len) {}
+    virtual ~USBHIDDevice() = default;
+};
+
+namespace native {
+    struct HidReport {
+        uint8_t id;
+        std::vector<uint8_t> data;
+        uint64_t atUs;
+    };
+    inline std::vector<HidReport> hidReports;
+    inline bool hidReady = true;
+    inline std::vector<USBHIDDevice*> hidDevices;
+}
+
+class USBHID {
+public:
+    void begin() {}
+    void end() {}
+    bool ready() { return native::hidReady; }
+    bool SendReport(uint8_t id, const void* data, size_t len, uint32_t timeout_ms = 100) {
+        if (!native::hidReady) { return false; }
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        native::hidReports.push_back({id, std::vector<uint8_t>(p, p + len), native::clockUs});
+        return true;
+    }
+    static bool addDevice(USBHIDDevice* device, uint16_t descriptorLen) {
+        native::hidDevices.push_back(device);
+        return true;
+    }
+};
+
+#endif
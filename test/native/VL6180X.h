@@ -0,0 +1,29 @@
+#ifndef NATIVE_VL6180X_H
+#define NATIVE_VL6180X_H
+
+// Pololu VL6180X driver; a test sets `range` to what the sensor reports
+
+#include <Arduino.h>
+
+class VL6180X {
+private:
+    uint8_t _address = 0x29;
+    bool _timeout = false;
+
+public:
+    uint16_t range = 255;
+
+    void setAddress(uint8_t address) { _address = address; }
+    uint8_t getAddress() { return _address; }
+    bool init() { return true; }
+    void configureDefault() {}
+    void setScaling(uint8_t) {}
+    void setTimeout(uint16_t) {}
+    bool timeoutOccurred() { const bool t = _timeout; _timeout = false; return t; }
+    void startRangeContinuous(uint16_t = 100) {}
+    void stopContinuous() {}
+    uint8_t readRangeSingleMillimeters() { return static_cast<uint8_t>(range); }
+    uint8_t readRangeContinuousMillimeters() { return static_cast<uint8_t>(range); }
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+// I2C master on the virtual clock. A test plugs a model of each slave into
+// native::i2c[address]; every transaction moves the clock by its time on
+// the bus (address byte plus data, 9 bits each), so drivers that read more
+// than they need show it in micros(). i2cStops counts the transactions that
+// ended with a stop, so a burst joined by repeated starts counts once.
+
+#include <Arduino.h>
+
+namespace native {
+    struct I2cDevice {
+        virtual ~I2cDevice() = default;
+        // Bytes the master wrote in one transaction
+        virtual void received(const uint8_t* data, size_t len) = 0;
+        // Fill up to len bytes for a read; returns how many the slave sent
+        virtual size_t requested(uint8_t* data, size_t len) = 0;
+    };
+
+    inline I2cDevice* i2c[128] = {};
+    inline uint32_t i2cHz = 400000;
+    inline uint32_t i2cTransactions = 0;
+    inline uint32_t i2cBytes = 0;
+    inline uint32_t i2cStops = 0;
+
+    inline void i2cBus(size_t bytes) {
+        i2cTransactions++;
+        i2cBytes += bytes;
+        advanceUs((bytes + 1) * 9 * 1000000ull / i2cHz);
+    }
+
+    inline void resetI2c() {
+        for (I2cDevice*& d : i2c) { d = nullptr; }
+        i2cTransactions = i2cBytes = i2cStops = 0;
+        i2cHz = 400000;
+    }
+}
+
+class TwoWire {
+private:
+    uint8_t _address = 0;
+    uint8_t _tx[128];
+    size_t _txLen = 0;
+    uint8_t _rx[128];
+    size_t _rxLen = 0, _rxPos = 0;
+    bool _began = false;
+
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t freq = 0) { _began = true; return true; }
+    void setClock(uint32_t hz) { native::i2cHz = hz; }
+
+    void beginTransmission(uint8_t address) {
+        _address = address & 0x7F;
+        _txLen = 0;
+    }
+
+    size_t write(uint8_t b) {
+        if (_txLen >= sizeof(_tx)) { return 0; }
+        _tx[_txLen++] = b;
+        return 1;
+    }
+
+    // 0 ok, 2 address NACK, 4 bus not begun
+    uint8_t endTransmission(bool stop = true) {
+        if (!_began) { return 4; }
+        native::I2cDevice* d = native::i2c[_address];
+        native::i2cBus(_txLen);
+        native::i2cStops += stop;
+        if (!d) { return 2; }
+        d->received(_tx, _txLen);
+        return 0;
+    }
+
+    uint8_t requestFrom(uint8_t address, size_t len, bool stop = true) {
+        native::I2cDevice* d = native::i2c[address & 0x7F];
+        _rxPos = 0;
+        _rxLen = 0;
+        if (!_began || !d) { return 0; }
+        _rxLen = d->requested(_rx, min(len, sizeof(_rx)));
+        native::i2cBus(_rxLen);
+        native::i2cStops += stop;
+        return static_cast<uint8_t>(_rxLen);
+    }
+    uint8_t requestFrom(int address, int len) { return requestFrom(static_cast<uint8_t>(address), static_cast<size_t>(len)); }
+
+    int available() { return static_cast<int>(_rxLen - _rxPos); }
+    int read() { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+};
+
+inline TwoWire Wire;
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef NATIVE_DRIVER_LEDC_H
+#define NATIVE_DRIVER_LEDC_H
+
+// ESP-IDF LEDC fade API on top of the recorded channels. A fade lands on
+// its target at once; native::endFades() then runs the fade-end callbacks,
+// as the peripheral's interrupt would when the time is up. As on the part,
+// a duty written while a fade runs does not stop it: the fade still ends
+// on its target unless ledc_fade_stop() came first.
+
+#include <Arduino.h>
+#include <esp_err.h>
+
+typedef enum { LEDC_LOW_SPEED_MODE, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+typedef int ledc_channel_t;
+typedef enum { LEDC_FADE_NO_WAIT, LEDC_FADE_WAIT_DONE } ledc_fade_mode_t;
+typedef enum { LEDC_FADE_END_EVT } ledc_cb_event_t;
+
+typedef struct {
+    ledc_cb_event_t event;
+    uint32_t speed_mode;
+    uint32_t channel;
+    uint32_t duty;
+} ledc_cb_param_t;
+
+typedef bool (*ledc_cb_t)(const ledc_cb_param_t* param, void* arg);
+typedef struct { ledc_cb_t fade_cb; } ledc_cbs_t;
+
+namespace native {
+    struct LedcFade {
+        ledc_cb_t cb = nullptr;
+        void* arg = nullptr;
+        uint32_t target = 0;
+        uint32_t ms = 0;
+        bool running = false;
+    };
+    inline LedcFade ledcFade[16];
+
+    // Finish every running fade and report it
+    inline uint8_t endFades() {
+        uint8_t ended = 0;
+        for (uint32_t ch = 0; ch < 16; ch++) {
+            LedcFade& f = ledcFade[ch];
+            if (!f.running) { continue; }
+            f.running = false;
+            ended++;
+            ledc[ch].duty = f.target;
+            const ledc_cb_param_t param = {LEDC_FADE_END_EVT, LEDC_LOW_SPEED_MODE, ch, f.target};
+            if (f.cb) { f.cb(&param, f.arg); }
+        }
+        return ended;
+    }
+}
+
+inline esp_err_t ledc_fade_func_install(int) { return ESP_OK; }
+inline esp_err_t ledc_cb_register(ledc_mode_t, ledc_channel_t ch, ledc_cbs_t* cbs, void* arg) {
+    native::ledcFade[ch & 15].cb = cbs->fade_cb;
+    native::ledcFade[ch & 15].arg = arg;
+    return ESP_OK;
+}
+inline esp_err_t ledc_set_fade_with_time(ledc_mode_t, ledc_channel_t ch, uint32_t target, int ms) {
+    native::ledcFade[ch & 15].target = target;
+    native::ledcFade[ch & 15].ms = static_cast<uint32_t>(ms);
+    return ESP_OK;
+}
+inline esp_err_t ledc_fade_start(ledc_mode_t, ledc_channel_t ch, ledc_fade_mode_t) {
+    native::ledcFade[ch & 15].running = true;
+    native::ledc[ch & 15].duty = native::ledcFade[ch & 15].target;
+    return ESP_OK;
+}
+inline esp_err_t ledc_fade_stop(ledc_mode_t, ledc_channel_t ch) {
+    native::ledcFade[ch & 15].running = false;             // No end event
+    return ESP_OK;
+}
+inline esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t ch, uint32_t duty) {
+    native::ledc[ch & 15].duty = duty;
+    return ESP_OK;
+}
+inline esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t ch) {
+    native::ledc[ch & 15].writes++;
+    return ESP_OK;
+}
+
+#endif
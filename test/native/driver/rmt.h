@@ -0,0 +1,61 @@
+#ifndef NATIVE_DRIVER_RMT_H
+#define NATIVE_DRIVER_RMT_H
+
+// ESP-IDF legacy RMT TX API. rmt_write_items() keeps a copy of the items
+// and marks the channel busy until the test calls native::rmtDone().
+
+#include <Arduino.h>
+#include <esp_err.h>
+#include <vector>
+
+typedef int rmt_channel_t;
+typedef int gpio_num_t;
+
+typedef struct {
+    uint32_t val;
+} rmt_item32_t;
+
+typedef struct {
+    rmt_channel_t channel;
+    gpio_num_t gpio_num;
+    uint8_t clk_div;
+    uint8_t mem_block_num;
+} rmt_config_t;
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, chan) rmt_config_t{(chan), (gpio), 80, 1}
+
+namespace native {
+    struct RmtChannel {
+        rmt_config_t config = {};
+        bool installed = false;
+        bool busy = false;
+        uint32_t frames = 0;
+        std::vector<uint32_t> items;
+    };
+    inline RmtChannel rmt[8];
+
+    inline void rmtDone(rmt_channel_t ch) { rmt[ch & 7].busy = false; }
+    inline void resetRmt() { for (RmtChannel& c : rmt) { c = RmtChannel(); } }
+}
+
+inline esp_err_t rmt_config(const rmt_config_t* config) {
+    native::rmt[config->channel & 7].config = *config;
+    return ESP_OK;
+}
+inline esp_err_t rmt_driver_install(rmt_channel_t ch, size_t, int) {
+    if (native::rmt[ch & 7].installed) { return ESP_ERR_INVALID_STATE; }
+    native::rmt[ch & 7].installed = true;
+    return ESP_OK;
+}
+inline esp_err_t rmt_wait_tx_done(rmt_channel_t ch, uint32_t) {
+    return native::rmt[ch & 7].busy ? ESP_ERR_TIMEOUT : ESP_OK;
+}
+inline esp_err_t rmt_write_items(rmt_channel_t ch, const rmt_item32_t* items, int count, bool) {
+    native::RmtChannel& c = native::rmt[ch & 7];
+    c.items.assign(&items->val, &items->val + count);
+    c.busy = true;
+    c.frames++;
+    return ESP_OK;
+}
+
+#endif
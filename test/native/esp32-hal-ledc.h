@@ -0,0 +1,37 @@
+#ifndef NATIVE_ESP32_HAL_LEDC_H
+#define NATIVE_ESP32_HAL_LEDC_H
+
+// Arduino-core LEDC calls, recorded per channel so tests can read back
+// what a driver wrote
+
+#include <cstdint>
+
+namespace native {
+    struct LedcChannel {
+        uint32_t freq = 0;
+        uint8_t bits = 0;
+        int pin = -1;
+        uint32_t duty = 0;
+        uint32_t writes = 0;
+    };
+    inline LedcChannel ledc[16];
+
+    inline void resetLedc() { for (LedcChannel& c : ledc) { c = LedcChannel(); } }
+}
+
+inline uint32_t ledcSetup(uint8_t chan, uint32_t freq, uint8_t bits) {
+    native::ledc[chan & 15].freq = freq;
+    native::ledc[chan & 15].bits = bits;
+    return freq;
+}
+inline void ledcAttachPin(uint8_t pin, uint8_t chan) { native::ledc[chan & 15].pin = pin; }
+inline void ledcDetachPin(uint8_t pin) {
+    for (native::LedcChannel& c : native::ledc) { if (c.pin == pin) { c.pin = -1; } }
+}
+inline void ledcWrite(uint8_t chan, uint32_t duty) {
+    native::ledc[chan & 15].duty = duty;
+    native::ledc[chan & 15].writes++;
+}
+inline uint32_t ledcRead(uint8_t chan) { return native::ledc[chan & 15].duty; }
+
+#endif
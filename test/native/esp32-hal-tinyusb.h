@@ -0,0 +1,19 @@
+#ifndef NATIVE_ESP32_HAL_TINYUSB_H
+#define NATIVE_ESP32_HAL_TINYUSB_H
+
+// String descriptors a device registered, by index (0 is the language ID)
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+namespace native {
+    inline std::vector<std::string> usbStrings;
+}
+
+inline uint8_t tinyusb_add_string_descriptor(const char* s) {
+    native::usbStrings.push_back(s);
+    return static_cast<uint8_t>(native::usbStrings.size() + 3);     // After the manufacturer/product/serial strings
+}
+
+#endif
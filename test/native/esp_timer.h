@@ -0,0 +1,112 @@
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+// esp_timer on the virtual clock. Timers fire from native::advanceUs(), in
+// deadline order, with the clock set to each deadline while its callback
+// runs, so callbacks see the micros() they would on target. Like the IDF,
+// starting a timer that is already running fails.
+
+#include <Arduino.h>
+#include <esp_err.h>
+
+typedef void (*esp_timer_cb_t)(void* arg);
+typedef enum { ESP_TIMER_TASK, ESP_TIMER_ISR } esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+    esp_timer_cb_t callback = nullptr;
+    void* arg = nullptr;
+    uint64_t due = 0;
+    uint64_t period = 0;            // 0 = one-shot
+    bool armed = false;
+    bool used = false;
+};
+typedef esp_timer* esp_timer_handle_t;
+
+namespace native {
+    constexpr uint8_t MAX_TIMERS = 32;
+    inline esp_timer timers[MAX_TIMERS];
+    inline uint32_t timerCallbacks = 0;
+
+    inline void runTimers(uint64_t target) {
+        for (;;) {
+            esp_timer* next = nullptr;
+            for (esp_timer& t : timers) {
+                if (t.used && t.armed && t.due <= target && (!next || t.due < next->due)) { next = &t; }
+            }
+            if (!next) { return; }
+            clockUs = next->due;
+            if (next->period) { next->due += next->period; } else { next->armed = false; }
+            timerCallbacks++;
+            next->callback(next->arg);
+        }
+    }
+
+    inline void resetTimers() {
+        for (esp_timer& t : timers) { t = esp_timer(); }
+        timerCallbacks = 0;
+        clockHook = &runTimers;
+    }
+
+    inline uint8_t armedTimers() {
+        uint8_t n = 0;
+        for (const esp_timer& t : timers) { n += t.used && t.armed; }
+        return n;
+    }
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    native::clockHook = &native::runTimers;
+    for (esp_timer& t : native::timers) {
+        if (t.used) { continue; }
+        t = esp_timer();
+        t.used = true;
+        t.callback = args->callback;
+        t.arg = args->arg;
+        *out = &t;
+        return ESP_OK;
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t us) {
+    if (!t || !t->used) { return ESP_ERR_INVALID_ARG; }
+    if (t->armed) { return ESP_ERR_INVALID_STATE; }
+    t->due = native::clockUs + us;
+    t->period = 0;
+    t->armed = true;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t us) {
+    if (!t || !t->used) { return ESP_ERR_INVALID_ARG; }
+    if (t->armed) { return ESP_ERR_INVALID_STATE; }
+    t->due = native::clockUs + us;
+    t->period = us ? us : 1;
+    t->armed = true;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+    if (!t || !t->armed) { return ESP_ERR_INVALID_STATE; }
+    t->armed = false;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+    if (!t || t->armed) { return ESP_ERR_INVALID_STATE; }
+    t->used = false;
+    return ESP_OK;
+}
+
+inline bool esp_timer_is_active(esp_timer_handle_t t) { return t && t->armed; }
+inline int64_t esp_timer_get_time() { return static_cast<int64_t>(native::clockUs); }
+
+#endif
@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "AutoCenter.hpp"
+
+// Small deterministic sensor noise, +-amp deg
+static uint32_t seed;
+static float noise(float amp) {
+    seed = seed * 1664525u + 1013904223u;
+    return amp * (((seed >> 8) & 0xFFFF) / 32767.5f - 1.f);
+}
+
+void setUp() { seed = 2024; }
+void tearDown() {}
+
+/****************************************************************************/
+// Rest away from the zero: the zero walks there at no more than maxRate
+void test_still_windows_step_the_zero_at_max_rate() {
+    AutoCenter center(2.f, 0.3f, 0.02f, 2.f, SMPL_FREQ);
+    Vec2f zero;
+    const uint32_t window = static_cast<uint32_t>(2.f * SMPL_FREQ);
+    for (uint32_t n = 0; n < 3 * window; n++) { center.update(Vec2f(0.5f + noise(0.1f), -0.3f), zero); }
+    TEST_ASSERT_EQUAL_UINT32(3, center.windows());
+    TEST_ASSERT_EQUAL_UINT32(3, center.stillWindows());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 3 * 0.04f, zero[0]);        // 0.02 deg/s x 2 s per window
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -3 * 0.04f, zero[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, zero[0], center.drift()[0]);
+
+    // Close enough to finish within one step
+    for (uint32_t n = 0; n < 20 * window; n++) { center.update(Vec2f(0.5f + noise(0.1f), -0.3f), zero); }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, zero[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -0.3f, zero[1]);
+}
+
+// A slow temperature drift under sensor noise is followed
+void test_slow_drift_is_followed() {
+    AutoCenter center;
+    Vec2f zero;
+    const uint32_t samples = static_cast<uint32_t>(30.f * 60.f * SMPL_FREQ);
+    const Vec2f total(0.8f, -0.5f);
+    for (uint32_t n = 0; n < samples; n++) {
+        const Vec2f truth = total * (static_cast<float>(n) / samples);
+        center.update(truth + Vec2f(noise(0.15f), noise(0.15f)), zero);
+    }
+    TEST_ASSERT_EQUAL_UINT32(center.windows(), center.stillWindows());
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05f, (total - zero).magnitude());
+}
+
+// A nudge breaks the window it lands in; nothing moves
+void test_nudge_breaks_the_window() {
+    AutoCenter center;
+    Vec2f zero;
+    const uint32_t window = static_cast<uint32_t>(2.f * SMPL_FREQ);
+    for (uint32_t n = 0; n < window; n++) {
+        const float shove = (n >= 50 && n < 80) ? 4.f * sinf(PI * (n - 50) / 30.f) : 0.f;
+        center.update(Vec2f(0.5f + shove, 0.f), zero);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, center.windows());
+    TEST_ASSERT_EQUAL_UINT32(0, center.stillWindows());
+    TEST_ASSERT_EQUAL_FLOAT(0.f, zero.magnitude());
+}
+
+// Resting far from the zero is a lean, not drift
+void test_lean_beyond_max_offset_is_ignored() {
+    AutoCenter center(2.f, 0.3f, 0.02f, 2.f);
+    Vec2f zero;
+    for (uint32_t n = 0; n < 10 * 200; n++) { center.update(Vec2f(0.f, 3.f + noise(0.05f)), zero); }
+    TEST_ASSERT_EQUAL_UINT32(10, center.windows());
+    TEST_ASSERT_EQUAL_UINT32(0, center.stillWindows());
+    TEST_ASSERT_EQUAL_FLOAT(0.f, zero.magnitude());
+}
+
+// interrupt() drops the window in progress; reset() clears the counters
+void test_interrupt_and_reset() {
+    AutoCenter center;
+    Vec2f zero;
+    for (uint32_t n = 0; n < 150; n++) { center.update(Vec2f(0.5f, 0.f), zero); }
+    center.interrupt();
+    for (uint32_t n = 0; n < 150; n++) { center.update(Vec2f(0.5f, 0.f), zero); }
+    TEST_ASSERT_EQUAL_UINT32(0, center.windows());
+    for (uint32_t n = 0; n < 50; n++) { center.update(Vec2f(0.5f, 0.f), zero); }
+    TEST_ASSERT_EQUAL_UINT32(1, center.windows());
+    TEST_ASSERT_EQUAL_UINT32(1, center.stillWindows());
+
+    center.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, center.windows());
+    TEST_ASSERT_EQUAL_UINT32(0, center.stillWindows());
+    TEST_ASSERT_EQUAL_FLOAT(0.f, center.drift().magnitude());
+}
+
+// Sums about the window's first sample: a far tilt keeps full precision
+void test_variance_is_exact_at_large_tilt() {
+    AutoCenter center(2.f, 0.3f, 0.02f, 100.f);
+    Vec2f zero(40.f, -40.f);
+    for (uint32_t n = 0; n < 200; n++) { center.update(Vec2f(40.5f + noise(0.2f), -40.f), zero); }
+    TEST_ASSERT_EQUAL_UINT32(1, center.stillWindows());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 40.04f, zero[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_still_windows_step_the_zero_at_max_rate);
+    RUN_TEST(test_slow_drift_is_followed);
+    RUN_TEST(test_nudge_breaks_the_window);
+    RUN_TEST(test_lean_beyond_max_offset_is_ignored);
+    RUN_TEST(test_interrupt_and_reset);
+    RUN_TEST(test_variance_is_exact_at_large_tilt);
+    return UNITY_END();
+}
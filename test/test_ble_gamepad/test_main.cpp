@@ -0,0 +1,149 @@
+#define BLE_GAMEPAD
+#include <Arduino.h>
+#include <unity.h>
+#include "BleGamepadHID.hpp"
+
+// A Gamepad whose states the test publishes by hand
+class ScriptedGamepad : public Gamepad {
+public:
+    GamepadState state;
+    uint32_t published = 0;
+
+    void publish(uint32_t buttons, int16_t x) {
+        state.buttons = buttons;
+        state.axis[AXIS_X] = x;
+        state.sampled = micros();
+        published++;
+    }
+
+    void update() override {}
+    GamepadState getState() override { return state; }
+    uint32_t version() const override { return published; }
+};
+
+static constexpr uint32_t INTERVAL_US = BLE_CONN_MIN * 1250u;
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetBle();
+    native::bleNotifications.clear();
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_asks_for_the_fastest_interval_once_connected() {
+    ScriptedGamepad pad;
+    BleGamepadHID ble(pad);
+    ble.begin();
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(0, native::ble.paramRequests);    // Advertising
+    TEST_ASSERT_EQUAL_UINT32(0, native::bleNotifications.size());
+
+    native::ble.connected = true;
+    native::ble.interval = BLE_CONN_MAX;                        // Before the update lands
+    ble.pump();
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(1, native::ble.paramRequests);
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_MIN, native::ble.requestedMin);
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_MAX, native::ble.requestedMax);
+    TEST_ASSERT_EQUAL_UINT16(BLE_CONN_LATENCY, native::ble.requestedLatency);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 15.f, ble.intervalMs());
+
+    native::ble.interval = BLE_CONN_MIN;
+    ble.pump();
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 7.5f, ble.intervalMs());
+
+    // A new connection asks again
+    native::ble.connected = false;
+    ble.pump();
+    native::ble.connected = true;
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(2, native::ble.paramRequests);
+}
+
+// Tilt at 1 kHz onto a 7.5 ms link: one notification per interval, each
+// carrying the newest state, and the states in between counted as superseded
+void test_fast_producer_coalesces_onto_the_connection_interval() {
+    ScriptedGamepad pad;
+    BleGamepadHID ble(pad);
+    ble.begin();
+    native::ble.connected = true;
+
+    uint32_t nextPump = micros() + INTERVAL_US;
+    uint32_t pumps = 0, first = 0, last = 0;
+    for (uint16_t ms = 0; ms < 750; ms++) {
+        pad.publish(0, static_cast<int16_t>(ms * 100 % 30000));
+        native::advanceUs(1000);
+        while (static_cast<int32_t>(micros() - nextPump) >= 0) {
+            ble.pump();
+            if (!pumps++) { first = pad.version(); }
+            last = pad.version();
+            const native::BleNotification& n = native::bleNotifications.back();
+            TEST_ASSERT_EQUAL_INT16(pad.state.axis[AXIS_X], n.axes[0]);
+            nextPump += INTERVAL_US;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(100, pumps);
+    TEST_ASSERT_EQUAL_UINT32(pumps, ble.sent());
+    TEST_ASSERT_EQUAL_UINT32(pumps, native::bleNotifications.size());
+    // Every version from the first send to the last either went out or was
+    // superseded
+    TEST_ASSERT_EQUAL_UINT32(last - first + 1 - pumps, ble.superseded());
+    // Newest state only: never older than one producer period
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1000, ble.latencyMax());
+}
+
+// Below the axis threshold nothing is sent, and nothing counts as superseded
+void test_unchanged_states_are_skipped_not_superseded() {
+    ScriptedGamepad pad;
+    BleGamepadHID ble(pad, "Pinball Controller", 64);
+    ble.begin();
+    native::ble.connected = true;
+
+    pad.publish(0, 1000);
+    ble.pump();
+    for (uint8_t k = 0; k < 20; k++) {
+        pad.publish(0, static_cast<int16_t>(1000 + k));
+        native::advanceUs(INTERVAL_US);
+        ble.pump();
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, ble.sent());
+    TEST_ASSERT_EQUAL_UINT32(0, ble.superseded());
+
+    // A button edge always goes out, with every button in the one report
+    pad.publish((1u << BTN_LAUNCH) | (1u << BTN_START), 1019);
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(2, native::bleNotifications.size());
+    TEST_ASSERT_EQUAL_HEX32((1u << BTN_LAUNCH) | (1u << BTN_START), native::bleNotifications.back().buttons);
+}
+
+// After a reconnect the central has nothing: the current state goes out
+// even though it matches what the old connection got last
+void test_reconnect_resends_the_current_state() {
+    ScriptedGamepad pad;
+    BleGamepadHID ble(pad);
+    ble.begin();
+    native::ble.connected = true;
+    pad.publish(1u << BTN_COIN, -2000);
+    ble.pump();
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(1, native::bleNotifications.size());
+
+    native::ble.connected = false;
+    ble.pump();
+    native::ble.connected = true;
+    ble.pump();
+    TEST_ASSERT_EQUAL_UINT32(2, native::bleNotifications.size());
+    TEST_ASSERT_EQUAL_HEX32(1u << BTN_COIN, native::bleNotifications.back().buttons);
+    TEST_ASSERT_EQUAL_INT16(-2000, native::bleNotifications.back().axes[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_asks_for_the_fastest_interval_once_connected);
+    RUN_TEST(test_fast_producer_coalesces_onto_the_connection_interval);
+    RUN_TEST(test_unchanged_states_are_skipped_not_superseded);
+    RUN_TEST(test_reconnect_resends_the_current_state);
+    return UNITY_END();
+}
@@ -0,0 +1,367 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <Wire.h>
+#include "CicFrontEnd.hpp"
+#include "Joystick.hpp"
+#include "Gamepad.hpp"
+// Library sources are not built for native tests
+#include "Accelerometer.cpp"
+#include "Joystick.cpp"
+#include "RangeLaser.cpp"
+
+/****************************************************************************/
+// ADXL345 on the bus: samples at the BW_RATE data rate on the virtual
+// clock, a 32-entry FIFO in stream mode (newest kept) or the data registers
+// alone in bypass. A read through DATAZ1 pops one entry; the register
+// pointer then runs on, as on the part.
+struct Adxl345 : native::I2cDevice {
+    uint8_t regs[64] = {};
+    uint8_t ptr = 0;
+    int16_t fifo[ADXL345_FIFO_DEPTH][3] = {};
+    uint8_t head = 0, count = 0;
+    uint64_t nextUs = 0;
+    uint32_t produced = 0, lost = 0;
+    int16_t (*signal)(uint32_t n, uint8_t axis) = nullptr;
+
+    Adxl345() { regs[ADXL345_REG_DEVID] = 0xE5; regs[ADXL345_REG_BW_RATE] = ADXL345_DATARATE_100_HZ; }
+
+    bool streaming() const { return (regs[ADXL345_REG_FIFO_CTL] & 0xC0) == 0x80; }
+    uint64_t periodUs() const { return (1000000ull << (15 - (regs[ADXL345_REG_BW_RATE] & 0x0F))) / 3200; }
+
+    void sample() {
+        int16_t s[3];
+        for (uint8_t a = 0; a < 3; a++) { s[a] = signal ? signal(produced, a) : 0; }
+        produced++;
+        if (!streaming()) { head = 0; count = 1; }
+        else if (count == ADXL345_FIFO_DEPTH) { head = (head + 1) % ADXL345_FIFO_DEPTH; count--; lost++; }
+        memcpy(fifo[(head + count++) % ADXL345_FIFO_DEPTH], s, sizeof(s));
+    }
+
+    void advance() {
+        if (!(regs[ADXL345_REG_POWER_CTL] & 0x08)) { nextUs = native::clockUs + periodUs(); return; }
+        while (native::clockUs >= nextUs) { sample(); nextUs += periodUs(); }
+    }
+
+    void received(const uint8_t* data, size_t len) override {
+        advance();
+        if (len == 0) { return; }
+        ptr = data[0];
+        for (size_t k = 1; k < len; k++) {
+            if (ptr == ADXL345_REG_FIFO_CTL) { head = count = 0; }
+            regs[ptr++ & 63] = data[k];
+        }
+    }
+
+    size_t requested(uint8_t* data, size_t len) override {
+        advance();
+        const uint8_t first = ptr;
+        for (size_t k = 0; k < len; k++, ptr++) {
+            if (ptr >= ADXL345_REG_DATAX0 && ptr < ADXL345_REG_DATAX0 + 6) {
+                const uint8_t b = ptr - ADXL345_REG_DATAX0;
+                const uint16_t v = count ? static_cast<uint16_t>(fifo[head][b / 2]) : 0;
+                data[k] = b & 1 ? v >> 8 : v & 0xFF;
+            } else if (ptr == ADXL345_REG_FIFO_STATUS) {
+                data[k] = streaming() ? count : 0;
+            } else {
+                data[k] = regs[ptr & 63];
+            }
+        }
+        const bool popped = first <= ADXL345_REG_DATAX0 + 5 && ptr > ADXL345_REG_DATAX0 + 5;
+        if (popped && streaming() && count) { head = (head + 1) % ADXL345_FIFO_DEPTH; count--; }
+        return len;
+    }
+};
+
+// Hands every second FIFO entry on unchanged, in LSB
+struct EverySecond : AccelDecimator {
+    bool odd = false;
+    uint8_t ratio() const override { return 2; }
+    void reset() override { odd = false; }
+    bool push(const int16_t (&raw)[3], Vec3f& out) override {
+        odd = !odd;
+        if (odd) { return false; }
+        out = Vec3f(raw[0], raw[1], raw[2]);
+        return true;
+    }
+};
+
+// Counts the samples a stage sees
+struct CountingStage : AccelStage {
+    uint32_t calls = 0;
+    float lastX = NAN;
+    void apply(Vec3f& coords) override { calls++; lastX = coords[0]; }
+};
+
+static int16_t counter(uint32_t n, uint8_t axis) { return axis == 0 ? static_cast<int16_t>(n) : axis == 2 ? 250 : 0; }
+
+static uint32_t seed;
+static float gauss() {                          // Irwin-Hall, 12 uniforms
+    float s = -6.f;
+    for (uint8_t i = 0; i < 12; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        s += (seed >> 8) / 16777216.f;
+    }
+    return s;
+}
+static int16_t noisyRest(uint32_t, uint8_t axis) { return static_cast<int16_t>(lroundf((axis == 2 ? 250.f : 0.f) + 4.f * gauss())); }
+
+static Adxl345* adxl;
+
+void setUp() {
+    native::resetClock();
+    native::resetI2c();
+    adxl = new Adxl345();
+    native::i2c[ADXL345_DEFAULT_ADDRESS] = adxl;
+    seed = 99;
+}
+void tearDown() {
+    native::i2c[ADXL345_DEFAULT_ADDRESS] = nullptr;
+    delete adxl;
+}
+
+/****************************************************************************/
+// DC passes with unit gain once the pipeline is full; one output per Ratio
+void test_cic_unit_dc_gain_and_rate() {
+    CicDecimator<8> cic;
+    const int16_t in[3] = {1000, -2000, 32767};
+    float out[3];
+    uint32_t outputs = 0;
+    for (uint32_t n = 0; n < 8 * 100; n++) {
+        if (!cic.push(in, out)) { continue; }
+        outputs++;
+        TEST_ASSERT_EQUAL_FLOAT(1000.f, out[0]);
+        TEST_ASSERT_EQUAL_FLOAT(-2000.f, out[1]);
+        TEST_ASSERT_EQUAL_FLOAT(32767.f, out[2]);   // Integrators wrap, combs undo it
+    }
+    TEST_ASSERT_EQUAL_UINT32(100 - (3 + 2), outputs);
+}
+
+// White noise comes down by about the averaging gain
+void test_cic_reduces_white_noise() {
+    CicDecimator<8, 3, 1> cic;
+    double in = 0, out = 0;
+    uint32_t n = 0;
+    for (uint32_t k = 0; k < 8 * 4000; k++) {
+        const int16_t x[1] = { static_cast<int16_t>(lroundf(8.f * gauss())) };
+        in += static_cast<double>(x[0]) * x[0];
+        float y[1];
+        if (cic.push(x, y)) { out += static_cast<double>(y[0]) * y[0]; n++; }
+    }
+    const float gain = 10.f * log10f(static_cast<float>((in / (8 * 4000)) / (out / n)));
+    TEST_ASSERT_GREATER_THAN_FLOAT(8.f, gain);
+}
+
+// Without a decimator begin() takes the sensor out of a stream mode an
+// earlier run left it in, and every read() is a fresh polled sample
+void test_begin_without_decimator_bypasses_the_fifo() {
+    adxl->regs[ADXL345_REG_FIFO_CTL] = 0x80 | 31;
+    Accelerometer accel;
+    TEST_ASSERT_TRUE(accel.begin());
+    TEST_ASSERT_EQUAL_HEX8(0x00, adxl->regs[ADXL345_REG_FIFO_CTL]);
+    TEST_ASSERT_EQUAL_HEX8(ADXL345_DATARATE_800_HZ, adxl->regs[ADXL345_REG_BW_RATE]);
+    TEST_ASSERT_TRUE(accel.read());
+    TEST_ASSERT_EQUAL_UINT8(0, accel.available());
+}
+
+// Every decimated sample is handed out by exactly one read(), oldest first,
+// one output period apart; a read with nothing new returns false
+void test_read_hands_out_every_sample_once() {
+    adxl->signal = counter;
+    Accelerometer accel;
+    EverySecond every;
+    TEST_ASSERT_TRUE(accel.attachDecimator(every));
+    TEST_ASSERT_TRUE(accel.begin());
+    TEST_ASSERT_EQUAL_HEX8(ADXL345_DATARATE_200_HZ, adxl->regs[ADXL345_REG_BW_RATE]);
+    native::i2cHz = 1000000000;                 // Bus time out of the way
+    while (accel.read()) {}
+    accel.resetStats();
+    const uint32_t start = adxl->produced;
+
+    delay(50);                                  // 10 entries -> 5 samples
+    float expected = NAN;
+    uint32_t prevUs = 0;
+    for (uint8_t k = 0; k < 5; k++) {
+        TEST_ASSERT_TRUE(accel.read());
+        if (k == 0) {                           // Either entry of the first pair
+            TEST_ASSERT_FLOAT_WITHIN(1.f, start + 0.5f, accel.coords[0]);
+            expected = accel.coords[0];
+        }
+        TEST_ASSERT_EQUAL_FLOAT(expected, accel.coords[0]);
+        if (k) { TEST_ASSERT_UINT32_WITHIN(1, 10000, accel._sampledUs - prevUs); }
+        prevUs = accel._sampledUs;
+        expected += 2.f;
+        TEST_ASSERT_EQUAL_UINT8(4 - k, accel.available());
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, accel.drains());
+    TEST_ASSERT_EQUAL_UINT32(0, accel.overruns());
+    const uint32_t next = adxl->produced;
+    TEST_ASSERT_FALSE(accel.read());            // Nothing since the drain but bus time
+    TEST_ASSERT_EQUAL_UINT32(5, accel.decimatedSamples());
+
+    delay(20);
+    TEST_ASSERT_TRUE(accel.read());
+    TEST_ASSERT_EQUAL_FLOAT(expected, accel.coords[0]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(next + 4, adxl->produced);
+    TEST_ASSERT_EQUAL_UINT32(0, adxl->lost);
+}
+
+// A poll too late for the FIFO finds it full and its oldest entries gone:
+// the drain counts an overrun, restarts the decimator on what is left and
+// still hands all of it out; the next, timely drain follows on cleanly
+void test_full_fifo_counts_an_overrun_and_restarts_the_decimator() {
+    adxl->signal = counter;
+    Accelerometer accel;
+    EverySecond every;
+    TEST_ASSERT_TRUE(accel.attachDecimator(every));
+    TEST_ASSERT_TRUE(accel.begin());
+    native::i2cHz = 1000000000;
+    while (accel.read()) {}
+    accel.resetStats();
+    adxl->lost = 0;
+
+    delay(300);                                 // 60 entries into 32
+    every.odd = true;                           // Mid-pair, as the last drain may leave it
+    TEST_ASSERT_TRUE(accel.read());
+    TEST_ASSERT_EQUAL_UINT32(1, accel.overruns());
+    TEST_ASSERT_GREATER_THAN_UINT32(0, adxl->lost);
+    const uint32_t oldest = adxl->produced - ADXL345_FIFO_DEPTH;
+    TEST_ASSERT_EQUAL_FLOAT(oldest + 1.f, accel.coords[0]);  // Pairs from the oldest kept
+    TEST_ASSERT_EQUAL_UINT8(ADXL345_FIFO_DEPTH / 2 - 1, accel.available());
+    float last = accel.coords[0];
+    while (accel.read()) {
+        TEST_ASSERT_EQUAL_FLOAT(last + 2.f, accel.coords[0]);
+        last = accel.coords[0];
+    }
+    TEST_ASSERT_EQUAL_UINT32(ADXL345_FIFO_DEPTH / 2, accel.decimatedSamples());
+
+    delay(20);
+    TEST_ASSERT_TRUE(accel.read());
+    TEST_ASSERT_EQUAL_FLOAT(last + 2.f, accel.coords[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, accel.overruns());
+}
+
+// A drain is one status read and one burst, however many entries it holds,
+// and its reported cost includes the time on the bus
+void test_drain_is_one_burst_and_costs_the_bus_time() {
+    adxl->signal = counter;
+    Accelerometer accel;
+    CicFrontEnd<32> frontEnd;
+    TEST_ASSERT_TRUE(accel.attachDecimator(frontEnd));
+    TEST_ASSERT_TRUE(accel.begin());
+    while (accel.read()) {}
+
+    // Entries that came in during the previous drain's bus time add up
+    for (uint8_t entries : {4, 16, 31}) {
+        native::advanceUs(entries * 1000000ull / 3200 + 100);
+        accel.resetStats();
+        const uint32_t stops = native::i2cStops, bytes = native::i2cBytes;
+        accel.read();
+        while (accel.available()) { accel.read(); }
+        TEST_ASSERT_EQUAL_UINT32(1, accel.drains());
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(entries, accel.fifoEntries());
+        TEST_ASSERT_EQUAL_UINT32(2 + 1, native::i2cStops - stops);     // FIFO_STATUS, then the burst
+        // Register address and 6 data bytes per entry, plus the status read
+        TEST_ASSERT_EQUAL_UINT32(7 * accel.fifoEntries() + 2, native::i2cBytes - bytes);
+        const uint32_t busUs = accel.fifoEntries() * ((1 + 1) * 9 * 1000000ull / 400000 + (6 + 1) * 9 * 1000000ull / 400000);
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(busUs, accel.lastDrainMicros());
+    }
+}
+
+// A CIC front end on a noisy resting sensor: m/s^2 out, a fraction of the noise
+void test_front_end_averages_a_noisy_sensor() {
+    adxl->signal = noisyRest;
+    Accelerometer accel;
+    CicFrontEnd<8> frontEnd;
+    TEST_ASSERT_TRUE(accel.attachDecimator(frontEnd));
+    TEST_ASSERT_TRUE(accel.begin());
+    while (accel.read()) {}
+    adxl->lost = 0;                             // Overrun while begin() paused
+    const float lsb = ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD;
+    double sumZ = 0, sumSqX = 0;
+    uint32_t n = 0;
+    for (uint32_t poll = 0; poll < 500; poll++) {
+        delay(getInterval());
+        while (accel.read()) {
+            if (poll < 10) { continue; }
+            sumZ += accel.coords[2];
+            sumSqX += static_cast<double>(accel.coords[0]) * accel.coords[0];
+            n++;
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(480, n);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 250.f * lsb, static_cast<float>(sumZ / n));
+    TEST_ASSERT_LESS_THAN_FLOAT(4.f * lsb / 2.5f, static_cast<float>(sqrt(sumSqX / n)));
+    TEST_ASSERT_EQUAL_UINT32(0, adxl->lost);
+}
+
+// Joystick::read() runs each sample through the stages once: a poll that
+// finds two samples feeds both, one that finds none feeds nothing
+void test_joystick_feeds_each_sample_to_the_stages_once() {
+    adxl->signal = counter;
+    Accelerometer accel;
+    EverySecond every;
+    accel.attachDecimator(every);
+    Joystick stick(accel);
+    CountingStage stage;
+    stick.attachCanceller(stage);
+    TEST_ASSERT_TRUE(stick.begin());
+    native::i2cHz = 1000000000;
+    while (accel.read()) {}
+
+    delay(20);                                  // Two samples
+    const Vec2f first = stick.read();
+    TEST_ASSERT_EQUAL_UINT32(2, stage.calls);
+    const float lastX = stage.lastX;
+    const Vec2f again = stick.read();           // None
+    TEST_ASSERT_EQUAL_UINT32(2, stage.calls);
+    TEST_ASSERT_EQUAL_FLOAT(first[0], again[0]);
+    TEST_ASSERT_EQUAL_FLOAT(first[1], again[1]);
+
+    delay(30);                                  // Three more
+    stick.read();
+    TEST_ASSERT_EQUAL_UINT32(5, stage.calls);
+    TEST_ASSERT_EQUAL_FLOAT(lastX + 6.f, stage.lastX);
+}
+
+// The gamepad state carries the time the sensor took the tilt sample, not
+// the time it was published: at least the drain's bus time earlier. It
+// never runs backwards.
+void test_gamepad_stamps_the_sensor_sample_time() {
+    adxl->signal = counter;
+    Accelerometer accel;
+    EverySecond every;
+    accel.attachDecimator(every);
+    Joystick stick(accel);
+    ButtonManager<> buttons;
+    MotionGamepad pad(stick, buttons);
+    TEST_ASSERT_TRUE(pad.begin());
+    while (accel.read()) {}
+
+    delay(25);
+    pad.update();
+    const GamepadState first = pad.getState();
+    TEST_ASSERT_EQUAL_UINT32(stick.sampledMicros(), first.sampled);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, accel.lastDrainMicros());
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(accel.lastDrainMicros(), micros() - first.sampled);
+
+    delay(10);
+    pad.update();
+    const GamepadState second = pad.getState();
+    TEST_ASSERT_EQUAL_UINT32(stick.sampledMicros(), second.sampled);
+    TEST_ASSERT_GREATER_THAN_INT32(0, static_cast<int32_t>(second.sampled - first.sampled));
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(accel.lastDrainMicros(), micros() - second.sampled);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cic_unit_dc_gain_and_rate);
+    RUN_TEST(test_cic_reduces_white_noise);
+    RUN_TEST(test_begin_without_decimator_bypasses_the_fifo);
+    RUN_TEST(test_read_hands_out_every_sample_once);
+    RUN_TEST(test_full_fifo_counts_an_overrun_and_restarts_the_decimator);
+    RUN_TEST(test_drain_is_one_burst_and_costs_the_bus_time);
+    RUN_TEST(test_front_end_averages_a_noisy_sensor);
+    RUN_TEST(test_joystick_feeds_each_sample_to_the_stages_once);
+    RUN_TEST(test_gamepad_stamps_the_sensor_sample_time);
+    return UNITY_END();
+}
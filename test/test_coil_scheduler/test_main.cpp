@@ -0,0 +1,143 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "CoilScheduler.hpp"
+
+static constexpr PulseProfile PROFILE = {20000, 4095, 1200, 500000};
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_fire_returns_before_the_coil_moves() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    TEST_ASSERT_EQUAL_INT8(0, sched.add(coil, PROFILE));
+    TEST_ASSERT_TRUE(sched.fire(0, 100000));
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    TEST_ASSERT_TRUE(sched.isActive(0));
+    TEST_ASSERT_FALSE(sched.fire(1));                       // Unknown coil
+}
+
+void test_kick_hold_release_timing_is_exact() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0, 100000);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty());
+    native::advanceUs(PROFILE.kickUs - 1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    native::advanceUs(100000 - PROFILE.kickUs - 1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    TEST_ASSERT_FALSE(sched.isActive(0));
+    TEST_ASSERT_EQUAL_UINT8(0, native::armedTimers());
+}
+
+void test_on_time_is_clamped_to_max_on() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0, 10 * PROFILE.maxOnUs);
+    native::advanceUs(PROFILE.maxOnUs - 1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+void test_short_fire_is_kick_only() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0, 5000);
+    native::advanceUs(4999);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+void test_release_ends_a_fire_early() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0);
+    native::advanceUs(30000);
+    sched.release(0);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());    // Applied by the timer task
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    native::advanceUs(PROFILE.maxOnUs);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+void test_delayed_fires_stagger_and_report_events() {
+    Solenoid a(1, 0), b(2, 1);
+    a.begin();
+    b.begin();
+    CoilScheduler sched;
+    CoilEventQueue events;
+    sched.setEventQueue(&events);
+    sched.add(a, PROFILE);
+    sched.add(b, PROFILE);
+    const uint32_t t0 = micros();
+    sched.fire(0, 50000);
+    sched.fire(1, 50000, 500);
+    native::advanceUs(499);
+    TEST_ASSERT_EQUAL_UINT32(0, b.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, b.getDuty());
+    CoilEvent e;
+    TEST_ASSERT_TRUE(events.pop(e));
+    TEST_ASSERT_EQUAL_UINT8(0, e.coil);
+    TEST_ASSERT_EQUAL_UINT32(t0, e.us);
+    TEST_ASSERT_TRUE(events.pop(e));
+    TEST_ASSERT_EQUAL_UINT8(1, e.coil);
+    TEST_ASSERT_EQUAL_UINT32(t0 + 500, e.us);
+    TEST_ASSERT_FALSE(events.pop(e));
+    // Deliberate delays are not latency
+    TEST_ASSERT_EQUAL_UINT32(0, sched.latencyMax());
+}
+
+void test_latency_stats_track_timer_lateness() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    for (uint32_t late = 0; late < 40; late += 10) {
+        const uint32_t since = micros();
+        native::advanceUs(late);                            // Request sat in a queue this long
+        sched.fire(0, 30000, 0, since);
+        native::advanceUs(40000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sched.latencyMin());
+    TEST_ASSERT_EQUAL_UINT32(30, sched.latencyMax());
+    TEST_ASSERT_EQUAL_UINT32(15, sched.latencyMean());
+    TEST_ASSERT_EQUAL_UINT32(30, sched.latencyJitter());
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fire_returns_before_the_coil_moves);
+    RUN_TEST(test_kick_hold_release_timing_is_exact);
+    RUN_TEST(test_on_time_is_clamped_to_max_on);
+    RUN_TEST(test_short_fire_is_kick_only);
+    RUN_TEST(test_release_ends_a_fire_early);
+    RUN_TEST(test_delayed_fires_stagger_and_report_events);
+    RUN_TEST(test_latency_stats_track_timer_lateness);
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "Fixed.hpp"
+
+void setUp() {}
+void tearDown() {}
+
+// Plain 64-bit reference with explicit clamping
+template<typename Q>
+static int64_t clampRaw(int64_t v) { return v > Q::RAW_MAX ? Q::RAW_MAX : v < Q::RAW_MIN ? Q::RAW_MIN : v; }
+static int64_t floorDiv(int64_t n, int64_t d) { return n / d - ((n % d != 0) && ((n < 0) != (d < 0))); }
+
+// Every operator on one pair of raw values against the reference
+template<typename Q>
+static void checkPair(int64_t a, int64_t b) {
+    const Q qa = Q::fromRaw(a), qb = Q::fromRaw(b);
+    TEST_ASSERT_EQUAL_INT32(clampRaw<Q>(a + b), (qa + qb).raw());
+    TEST_ASSERT_EQUAL_INT32(clampRaw<Q>(a - b), (qa - qb).raw());
+    TEST_ASSERT_EQUAL_INT32(clampRaw<Q>(floorDiv(a * b + Q::ONE / 2, Q::ONE)), (qa * qb).raw());
+    const int64_t quotient = b == 0 ? (a >= 0 ? Q::RAW_MAX : Q::RAW_MIN) : clampRaw<Q>(a * Q::ONE / b);
+    TEST_ASSERT_EQUAL_INT32(quotient, (qa / qb).raw());
+}
+
+static uint32_t seed;
+static int64_t randomRaw(int64_t lo, int64_t hi) {
+    seed = seed * 1664525u + 1013904223u;
+    const uint64_t r = (static_cast<uint64_t>(seed) << 32) | (seed * 22695477u + 1u);
+    return lo + static_cast<int64_t>(r % static_cast<uint64_t>(hi - lo + 1));
+}
+
+/****************************************************************************/
+// Every pair of 8-bit Q3.4 values through every operator, overflow and
+// divide-by-zero included
+void test_q3_4_saturates_exhaustively() {
+    using Q = Fixed<3, 4>;
+    for (int64_t a = Q::RAW_MIN; a <= Q::RAW_MAX; a++) {
+        TEST_ASSERT_EQUAL_INT32(clampRaw<Q>(-a), (-Q::fromRaw(a)).raw());
+        for (int64_t b = Q::RAW_MIN; b <= Q::RAW_MAX; b++) { checkPair<Q>(a, b); }
+    }
+}
+
+// Q15.16 is too wide to enumerate: the edges against each other, then
+// random pairs, half of them near full scale where products overflow
+void test_q15_16_saturates_at_the_edges_and_at_random() {
+    using Q = Fix16;
+    const int64_t edges[] = {Q::RAW_MIN, Q::RAW_MIN + 1, -Q::ONE - 1, -Q::ONE, -1, 0, 1,
+                             Q::ONE, Q::ONE + 1, Q::RAW_MAX - 1, Q::RAW_MAX};
+    for (int64_t a : edges) {
+        TEST_ASSERT_EQUAL_INT32(clampRaw<Q>(-a), (-Q::fromRaw(a)).raw());
+        for (int64_t b : edges) { checkPair<Q>(a, b); }
+    }
+    seed = 45;
+    for (uint32_t n = 0; n < 200000; n++) {
+        const int64_t span = (n & 1) ? Q::RAW_MAX : 8 * Q::ONE;
+        checkPair<Q>(randomRaw(-span - 1, span), randomRaw(-span - 1, span));
+    }
+}
+
+void test_conversions_saturate_and_round() {
+    using Q = Fixed<3, 4>;
+    TEST_ASSERT_EQUAL_INT32(Q::RAW_MAX, Q(100).raw());
+    TEST_ASSERT_EQUAL_INT32(Q::RAW_MIN, Q(-100).raw());
+    TEST_ASSERT_TRUE(Q(1e9f) == Q::max());
+    TEST_ASSERT_TRUE(Q(-1e9f) == Q::min());
+    TEST_ASSERT_TRUE(Q(NAN) == Q(0));
+    TEST_ASSERT_EQUAL_INT32(24, Q(1.5f).raw());
+    TEST_ASSERT_EQUAL_INT32(-24, Q(-1.5f).raw());
+    TEST_ASSERT_EQUAL_INT32(0, Q(0.03f).raw());
+    TEST_ASSERT_TRUE(-Q::min() == Q::max());                // Negating the minimum saturates
+    TEST_ASSERT_EQUAL_INT32(-1, Q(-0.5f).toInt());          // Floor
+    TEST_ASSERT_EQUAL_FLOAT(-0.5f, static_cast<float>(Q(-0.5f)));
+}
+
+// Squares are summed in 64 bits: no early saturation, and the result only
+// pins at full scale when the true magnitude is past it
+void test_magnitude_and_normalize() {
+    TEST_ASSERT_TRUE(Vec3x(Fix16(3), Fix16(4), Fix16(12)).magnitude() == Fix16(13));
+    TEST_ASSERT_TRUE(Vec3x(Fix16(20000), Fix16(20000), Fix16(0)).magnitude() > Fix16(28284));
+    TEST_ASSERT_TRUE(Vec3x(Fix16::max(), Fix16::max(), Fix16::max()).magnitude() == Fix16::max());
+    TEST_ASSERT_TRUE(Vec3x(Fix16(3), Fix16(4), Fix16(0)).dot(Vec3x(Fix16(1), Fix16(1), Fix16(1))) == Fix16(7));
+
+    Vec3x v(Fix16(3), Fix16(0), Fix16(-4));
+    v.normalize();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.6f, static_cast<float>(v[0]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -0.8f, static_cast<float>(v[2]));
+    Vec3x zero;
+    zero.normalize();                                       // x / 0 pins, 0 / 0 stays 0
+    TEST_ASSERT_TRUE(zero[0] == Fix16(0) && zero[1] == Fix16(0) && zero[2] == Fix16(0));
+}
+
+// CORDIC tilt against the float tiltProjection() over the whole sphere of
+// gravity directions (bar pitch +-90, where roll is undefined), and at the
+// extremes of the range
+void test_tilt_projection_matches_float() {
+    float worst = 0.f;
+    for (int pitch = -175; pitch <= 175; pitch += 5) {
+        if (abs(pitch) == 90) { continue; }
+        for (int roll = -175; roll <= 175; roll += 5) {
+            const float p = pitch * DEG_TO_RAD, r = roll * DEG_TO_RAD;
+            const Vec3f g(-9.81f * sinf(p), 9.81f * cosf(p) * sinf(r), 9.81f * cosf(p) * cosf(r));
+            const Vec2f f = tiltProjection(g);
+            const Vec2x x = tiltProjection(Vec3x(Fix16(g[0]), Fix16(g[1]), Fix16(g[2])));
+            for (size_t k = 0; k < 2; k++) {
+                float d = fabsf(static_cast<float>(x[k]) - f[k]);
+                d = min(d, 360.f - d);                      // +-180 are the same angle
+                worst = max(worst, d);
+            }
+        }
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(1e-3f, worst);
+
+    const Vec2x big = tiltProjection(Vec3x(Fix16::max(), Fix16::min(), Fix16::max()));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -35.264f, static_cast<float>(big[0]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -45.f, static_cast<float>(big[1]));
+    const Vec2x none = tiltProjection(Vec3x());
+    TEST_ASSERT_TRUE(none[0] == Fix16(0) && none[1] == Fix16(0));
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_q3_4_saturates_exhaustively);
+    RUN_TEST(test_q15_16_saturates_at_the_edges_and_at_random);
+    RUN_TEST(test_conversions_saturate_and_round);
+    RUN_TEST(test_magnitude_and_normalize);
+    RUN_TEST(test_tilt_projection_matches_float);
+    return UNITY_END();
+}
@@ -0,0 +1,98 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "GravityTracker.hpp"
+
+static constexpr float G = 9.81f;
+
+// Gravity of a cabinet pitched by `deg`, in m/s^2
+static Vec3f pitched(float deg) {
+    const float p = deg * DEG_TO_RAD;
+    return Vec3f(-G * sinf(p), 0.f, G * cosf(p));
+}
+
+void setUp() {}
+void tearDown() {}
+
+/****************************************************************************/
+void test_first_sample_primes_the_estimate() {
+    GravityTracker tracker;
+    tracker.update(pitched(3.f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.f, tracker.tilt()[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.f, tracker.nudge().magnitude());
+
+    tracker.reset();
+    tracker.update(pitched(-4.f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -4.f, tracker.tilt()[0]);
+}
+
+// A real tilt step is followed with the configured time constant
+void test_step_follows_with_the_time_constant() {
+    const float tau = 0.5f;
+    GravityTracker tracker(tau, 1.5f, SMPL_FREQ);
+    tracker.update(pitched(0.f));
+    const uint32_t n = static_cast<uint32_t>(tau * SMPL_FREQ);
+    for (uint32_t k = 0; k < n; k++) { tracker.update(pitched(5.f)); }
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, 5.f * (1.f - expf(-1.f)), tracker.tilt()[0]);
+    for (uint32_t k = 0; k < 5 * n; k++) { tracker.update(pitched(5.f)); }
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 5.f, tracker.tilt()[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.frozen());
+}
+
+// The slowly walking pitch with a 40 ms, 12 m/s^2 shove every 2 s: the raw
+// vector reads the shove as tens of degrees of tilt, the tracked gravity
+// barely moves, and the shove comes out whole in nudge()
+void test_shoves_stay_out_of_the_tilt_and_in_the_nudge() {
+    GravityTracker tracker;
+    const uint32_t every = static_cast<uint32_t>(2.f * SMPL_FREQ);
+    const uint32_t len = static_cast<uint32_t>(0.04f * SMPL_FREQ) + 2;
+    float rawErr = 0.f, trackedErr = 0.f, peakNudge = 0.f, restNudge = 0.f;
+    for (uint32_t n = 0; n < 6000; n++) {
+        const float deg = 5.f * sinf(2.f * PI * 0.05f * n / SMPL_FREQ);
+        const uint32_t phase = n % every;
+        const float shove = phase < len ? 12.f * sinf(PI * phase / len) : 0.f;
+        const Vec3f a = pitched(deg) + Vec3f(shove, 0.f, 0.f);
+        tracker.update(a);
+        if (n < every) { continue; }
+        if (shove != 0.f) {
+            rawErr = max(rawErr, fabsf(tiltProjection(a)[0] - deg));
+            trackedErr = max(trackedErr, fabsf(tracker.tilt()[0] - deg));
+            peakNudge = max(peakNudge, tracker.nudge()[0]);
+        } else if (phase > every / 2) {
+            restNudge = max(restNudge, tracker.nudge().magnitude());
+        }
+    }
+    TEST_ASSERT_GREATER_THAN_FLOAT(30.f, rawErr);
+    TEST_ASSERT_LESS_THAN_FLOAT(2.5f, trackedErr);
+    TEST_ASSERT_FLOAT_WITHIN(1.f, 12.f, peakNudge);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.2f, restNudge);          // Only the lag behind the walk
+}
+
+// Outside the |a| gate the estimate holds still, however long it lasts
+void test_gate_freezes_the_estimate_during_a_hard_hit() {
+    GravityTracker tracker(0.5f, 1.5f);
+    tracker.update(pitched(2.f));
+    const Vec3f before = tracker.gravity();
+    for (uint8_t k = 0; k < 50; k++) { tracker.update(pitched(2.f) + Vec3f(0.f, 8.f, 0.f)); }
+    TEST_ASSERT_EQUAL_UINT32(50, tracker.frozen());
+    TEST_ASSERT_EQUAL_FLOAT(before[1], tracker.gravity()[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 8.f, tracker.nudge()[1]);
+
+    // Free fall is outside the gate too
+    tracker.update(Vec3f());
+    TEST_ASSERT_EQUAL_UINT32(51, tracker.frozen());
+
+    // A wider gate follows the same hit
+    tracker.setGate(5.f);
+    tracker.update(pitched(2.f) + Vec3f(0.f, 8.f, 0.f));
+    TEST_ASSERT_EQUAL_UINT32(51, tracker.frozen());
+    TEST_ASSERT_GREATER_THAN_FLOAT(before[1], tracker.gravity()[1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_primes_the_estimate);
+    RUN_TEST(test_step_follows_with_the_time_constant);
+    RUN_TEST(test_shoves_stay_out_of_the_tilt_and_in_the_nudge);
+    RUN_TEST(test_gate_freezes_the_estimate_during_a_hard_hit);
+    return UNITY_END();
+}
@@ -0,0 +1,160 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "HapticPlayer.hpp"
+
+static const HapticEnvelope* const EFFECTS[] = {
+    &Haptic::FLIPPER_HIT, &Haptic::BUMPER, &Haptic::SLINGSHOT, &Haptic::KNOCKER,
+    &Haptic::DRAIN_RUMBLE, &Haptic::TILT_BUZZ, &Haptic::BALL_LAUNCH
+};
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+/****************************************************************************/
+// Every built-in effect, played on the timer, holds the exact envelope
+// value at every millisecond and ends at 0
+void test_effects_hit_every_millisecond_exactly() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    HapticPlayer<> player;
+    player.add(coil);
+    player.begin();
+    for (const HapticEnvelope* env : EFFECTS) {
+        player.play(0, *env);
+        for (uint32_t ms = 0; ms <= env->duration; ms++) {
+            native::advanceUs(ms ? 1000 : 0);
+            TEST_ASSERT_EQUAL_UINT16(Haptic::sampleAt(*env, ms), player.duty(0));
+            TEST_ASSERT_EQUAL_UINT32(player.duty(0), native::ledc[0].duty);
+        }
+        TEST_ASSERT_EQUAL_UINT8(0, player.activeVoices());
+        native::advanceUs(5000);
+    }
+}
+
+// Ramps wake the timer at most once a millisecond, flat segments and an
+// idle player not at all
+void test_timer_wakes_at_most_at_1khz() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    HapticPlayer<> player;
+    player.add(coil);
+    player.begin();
+
+    player.play(0, Haptic::DRAIN_RUMBLE);                   // Ramps end to end
+    native::advanceUs(Haptic::DRAIN_RUMBLE.duration * 1000 + 1000);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(Haptic::DRAIN_RUMBLE.duration + 1, native::timerCallbacks);
+    TEST_ASSERT_EQUAL_UINT8(0, native::armedTimers());
+
+    native::timerCallbacks = 0;
+    player.play(0, Haptic::KNOCKER);                        // On at 0, ramp 45..46, off
+    native::advanceUs(100000);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(4, native::timerCallbacks);
+
+    native::timerCallbacks = 0;
+    native::advanceUs(1000000);
+    TEST_ASSERT_EQUAL_UINT32(0, native::timerCallbacks);
+}
+
+// A voice started mid-ramp of another re-aligns the ticks; the first one
+// is still never more than one tick of its slope off
+void test_overlapping_voices_stay_within_one_tick() {
+    Solenoid a(1, 0), b(2, 1);
+    a.begin();
+    b.begin();
+    HapticPlayer<> player;
+    player.add(a);
+    player.add(b);
+    player.begin();
+
+    const uint32_t start = native::clockUs;
+    player.play(0, Haptic::BALL_LAUNCH);
+    native::advanceUs(10500);
+    player.play(1, Haptic::FLIPPER_HIT);
+    const float slope = 4095.f / 10;                        // Steepest ramp, 60..70 ms
+    for (uint32_t t = 10500; t < 70000; t += 50) {
+        native::advanceUs(50);
+        uint8_t cursor = 0;
+        const uint32_t elapsed = native::clockUs - start;
+        const float exact = sampleEnvelope(Haptic::BALL_LAUNCH, (elapsed << 4) / 1000, cursor);
+        TEST_ASSERT_FLOAT_WITHIN(slope + 1, exact, player.duty(0));
+    }
+}
+
+void test_voices_on_one_coil_mix_and_saturate() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    HapticPlayer<> player;
+    player.add(coil);
+    player.begin();
+
+    player.play(0, Haptic::BUMPER, 128);
+    player.play(0, Haptic::BUMPER, 64);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT16((4095 * 128 >> 8) + (4095 * 64 >> 8), player.duty(0));
+    TEST_ASSERT_EQUAL_UINT32(0, player.saturated());
+
+    player.play(0, Haptic::BUMPER);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT16(4095, player.duty(0));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, player.saturated());
+}
+
+void test_full_player_steals_the_oldest_voice() {
+    Solenoid a(1, 0), b(2, 1);
+    a.begin();
+    b.begin();
+    HapticPlayer<2> player;
+    player.add(a);
+    player.add(b);
+    player.begin();
+
+    player.play(0, Haptic::DRAIN_RUMBLE);
+    native::advanceUs(1000);
+    player.play(1, Haptic::DRAIN_RUMBLE);
+    native::advanceUs(1000);
+    TEST_ASSERT_EQUAL_INT8(0, player.play(1, Haptic::KNOCKER));
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(1, player.stolen());
+    TEST_ASSERT_EQUAL_UINT16(0, player.duty(0));            // Coil 0 lost its only voice
+    TEST_ASSERT_EQUAL_UINT16(4095, player.duty(1));
+}
+
+void test_stop_and_end_leave_the_coils_off() {
+    Solenoid a(1, 0), b(2, 1);
+    a.begin();
+    b.begin();
+    HapticPlayer<> player;
+    player.add(a);
+    player.add(b);
+    player.begin();
+
+    player.play(0, Haptic::KNOCKER);
+    player.play(1, Haptic::KNOCKER);
+    native::advanceUs(0);
+    player.stop(0);                                         // Mid flat segment: ticks anyway
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT16(0, player.duty(0));
+    TEST_ASSERT_EQUAL_UINT16(4095, player.duty(1));
+
+    player.end();
+    TEST_ASSERT_EQUAL_UINT16(0, player.duty(1));
+    TEST_ASSERT_EQUAL_UINT32(0, b.getDuty());
+    TEST_ASSERT_EQUAL_UINT8(0, native::armedTimers());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_effects_hit_every_millisecond_exactly);
+    RUN_TEST(test_timer_wakes_at_most_at_1khz);
+    RUN_TEST(test_overlapping_voices_stay_within_one_tick);
+    RUN_TEST(test_voices_on_one_coil_mix_and_saturate);
+    RUN_TEST(test_full_player_steals_the_oldest_voice);
+    RUN_TEST(test_stop_and_end_leave_the_coils_off);
+    return UNITY_END();
+}
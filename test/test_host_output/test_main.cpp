@@ -0,0 +1,183 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "HostOutput.hpp"
+
+static constexpr PulseProfile PROFILE = {20000, 4095, 1200, 500000};
+
+void setUp() {
+    native::resetClock(1000000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+static void batch(HostOutputProtocol& p, uint8_t port, uint8_t level) {
+    const uint8_t report[] = {HostOutputProtocol::CMD_BATCH, 1, port, level};
+    TEST_ASSERT_TRUE(p.apply(report, sizeof(report)));
+}
+
+/****************************************************************************/
+void test_batch_and_ledwiz_reports_set_levels() {
+    HostOutputProtocol p;
+    uint16_t lamp = 0;
+    FramePort port(lamp);
+    p.attach(3, port);
+    const uint8_t report[] = {HostOutputProtocol::CMD_BATCH, 2, 3, 255, 7, 10};
+    TEST_ASSERT_TRUE(p.apply(report, sizeof(report)));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, lamp);
+    TEST_ASSERT_EQUAL_UINT8(10, p.level(7));
+
+    const uint8_t sba[] = {HostOutputProtocol::CMD_LEDWIZ, 64, 0x08, 0, 0, 0, 2, 0, 0};
+    const uint8_t pba[] = {HostOutputProtocol::CMD_LEDWIZ, 0, 0, 0, 24, 0, 0, 0, 0};
+    TEST_ASSERT_TRUE(p.apply(sba, sizeof(sba)));
+    TEST_ASSERT_TRUE(p.apply(pba, sizeof(pba)));
+    TEST_ASSERT_EQUAL_UINT8(127, p.level(3));                  // 24 of 48, switched on
+    TEST_ASSERT_EQUAL_UINT8(0, p.level(7));                    // Switched off
+
+    const uint8_t shortBatch[] = {HostOutputProtocol::CMD_BATCH, 3, 1, 1};
+    TEST_ASSERT_FALSE(p.apply(shortBatch, sizeof(shortBatch)));
+}
+
+/****************************************************************************/
+void test_coil_port_fires_through_the_profile() {
+    Solenoid coil(1, 0);
+    TEST_ASSERT_TRUE(coil.begin());
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    HostOutputProtocol p;
+    CoilPort port(sched, 0);
+    p.attach(0, port);
+
+    const uint32_t received = micros();
+    native::advanceUs(150);                                     // USB task picks it up later
+    const uint8_t report[] = {HostOutputProtocol::CMD_BATCH, 1, 0, 40};
+    TEST_ASSERT_TRUE(p.apply(report, sizeof(report), received));
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());               // Never written from the USB task
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty()); // Level 40 is still a full kick
+    TEST_ASSERT_EQUAL_UINT32(150, sched.latencyMax());         // From receipt, not from fire()
+
+    native::advanceUs(PROFILE.kickUs);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    batch(p, 0, 255);                                           // Still on: no re-fire
+    native::advanceUs(1000);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    batch(p, 0, 0);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+void test_held_level_is_capped_at_max_on() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    HostOutputProtocol p;
+    p.setTimeout(0);
+    CoilPort port(sched, 0);
+    p.attach(0, port);
+    batch(p, 0, 255);
+    native::advanceUs(PROFILE.maxOnUs - 1);
+    TEST_ASSERT_NOT_EQUAL(0, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    TEST_ASSERT_EQUAL_UINT8(255, p.level(0));                   // The host still says on
+}
+
+void test_watchdog_releases_coils_when_reports_stop() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PulseProfile{20000, 4095, 1200, 5000000});
+    HostOutputProtocol p;
+    uint16_t lamp = 0;
+    CoilPort coilPort(sched, 0);
+    FramePort lampPort(lamp);
+    p.attach(0, coilPort);
+    p.attach(1, lampPort);
+    batch(p, 1, 255);
+    batch(p, 0, 255);
+
+    native::advanceUs((HOST_OUTPUT_TIMEOUT_MS - 1) * 1000ull);
+    p.update();
+    TEST_ASSERT_EQUAL_UINT32(1200, coil.getDuty());
+    native::advanceUs(1000);
+    p.update();
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, lamp);                  // Lamps may stay lit
+    TEST_ASSERT_EQUAL_UINT32(1, p.timeouts());
+    p.update();
+    TEST_ASSERT_EQUAL_UINT32(1, p.timeouts());                  // Once per silence
+
+    // The next on after a timeout fires again
+    batch(p, 0, 0);
+    batch(p, 0, 255);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(4095, coil.getDuty());
+}
+
+void test_power_deferred_fire_retries_from_update() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    PowerArbiter power(40000, 0, 32);
+    const int8_t pc = power.addCoil(coil, 3000);                // 40 W at full duty
+    const int8_t leds = power.addLeds(Rail::V12, 20);
+    power.scaleFrame(leds, 100u * 3 * LEVEL_MAX);               // Too much even at the floor
+    HostOutputProtocol p;
+    CoilPort port(sched, 0);
+    port.attachPower(power, pc);
+    p.attach(0, port);
+
+    batch(p, 0, 255);
+    native::advanceUs(0);
+    TEST_ASSERT_TRUE(port.pending());
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    native::advanceUs(5000);
+    p.update();
+    TEST_ASSERT_TRUE(port.pending());
+    power.scaleFrame(leds, 0);
+    p.update();
+    native::advanceUs(0);
+    TEST_ASSERT_FALSE(port.pending());
+    TEST_ASSERT_EQUAL_UINT32(4095, coil.getDuty());
+    TEST_ASSERT_EQUAL_UINT32(5000, sched.latencyMax());         // Deferral counts as latency
+}
+
+void test_thumper_port_goes_through_the_array() {
+    Solenoid a(1, 0), b(2, 1);
+    a.begin();
+    b.begin();
+    CoilScheduler sched;
+    sched.add(a, PROFILE);
+    sched.add(b, PROFILE);
+    ThumperArray<2> array(sched, 1, 500, 1000);                 // One coil at a time
+    array.add(0);
+    array.add(1);
+    HostOutputProtocol p;
+    ThumperPort<2> pa(array, 0), pb(array, 1);
+    p.attach(0, pa);
+    p.attach(1, pb);
+    batch(p, 0, 255);
+    batch(p, 1, 255);                                           // No slot within 1 ms
+    native::advanceUs(2000);
+    TEST_ASSERT_EQUAL_UINT32(4095, a.getDuty());
+    TEST_ASSERT_EQUAL_UINT32(0, b.getDuty());
+    TEST_ASSERT_EQUAL_UINT32(1, array.refusedBusy());
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_and_ledwiz_reports_set_levels);
+    RUN_TEST(test_coil_port_fires_through_the_profile);
+    RUN_TEST(test_held_level_is_capped_at_max_on);
+    RUN_TEST(test_watchdog_releases_coils_when_reports_stop);
+    RUN_TEST(test_power_deferred_fire_retries_from_update);
+    RUN_TEST(test_thumper_port_goes_through_the_array);
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "Gamepad.hpp"
+
+static const uint8_t BOUND[] = {
+    BTN_LEFT_FLIPPER, BTN_RIGHT_FLIPPER, BTN_LEFT_MAGNA, BTN_RIGHT_MAGNA, BTN_LAUNCH,
+    BTN_START, BTN_COIN, BTN_EXIT, BTN_FIRE, BTN_TILT
+};
+
+// Buttons a report says are held, read back through the keymap
+static uint32_t heldButtons(const uint8_t* data, const Keymap& map) {
+    KeyboardReport report;
+    memcpy(&report, data, sizeof(report));
+    uint32_t buttons = 0;
+    for (uint8_t b = 0; b < KEYBOARD_BUTTONS; b++) {
+        if (map.key[b] != HidKey::NONE && report.has(map.key[b])) { buttons |= 1u << b; }
+    }
+    return buttons;
+}
+
+// A Gamepad whose state the test sets by hand
+class ScriptedGamepad : public Gamepad {
+public:
+    GamepadState state;
+    void update() override {}
+    GamepadState getState() override { return state; }
+};
+
+void setUp() {
+    native::resetClock(1000);
+    native::hidReports.clear();
+    native::hidReady = true;
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_descriptor_matches_the_report() {
+    KeyboardHID keyboard;
+    uint8_t desc[128];
+    const uint16_t len = keyboard._onGetDescriptor(desc);
+    TEST_ASSERT_TRUE(hidReportMatches(desc, len, KEYBOARD_REPORT_ID, sizeof(KeyboardReport)));
+    TEST_ASSERT_FALSE(hidReportMatches(desc, len, GAMEPAD_REPORT_ID, sizeof(KeyboardReport)));
+}
+
+// N-key rollover: every one of the 1024 chords of the bound buttons goes
+// out exactly as held, nothing dropped and nothing extra
+void test_every_chord_of_bound_buttons_round_trips() {
+    KeyboardHID keyboard;
+    const uint16_t chords = 1u << sizeof(BOUND);
+    for (uint16_t c = 0; c < chords; c++) {
+        uint32_t buttons = 0;
+        for (uint8_t k = 0; k < sizeof(BOUND); k++) {
+            if ((c >> k) & 1) { buttons |= 1u << BOUND[k]; }
+        }
+        TEST_ASSERT_TRUE(keyboard.send(buttons));
+        const native::HidReport& r = native::hidReports.back();
+        TEST_ASSERT_EQUAL_UINT8(KEYBOARD_REPORT_ID, r.id);
+        TEST_ASSERT_EQUAL_size_t(sizeof(KeyboardReport), r.data.size());
+        TEST_ASSERT_EQUAL_HEX32(buttons, heldButtons(r.data.data(), VPX_KEYMAP));
+    }
+    TEST_ASSERT_EQUAL_size_t(chords, native::hidReports.size());
+}
+
+void test_vpx_chords_land_on_the_expected_usages() {
+    const KeyboardReport flippers = buildKeyboardReport((1u << BTN_LEFT_FLIPPER) | (1u << BTN_RIGHT_FLIPPER), VPX_KEYMAP);
+    TEST_ASSERT_TRUE(flippers.has(HidKey::LEFT_SHIFT));
+    TEST_ASSERT_TRUE(flippers.has(HidKey::RIGHT_SHIFT));
+    TEST_ASSERT_EQUAL_HEX8(0x22, flippers.modifiers);
+
+    const KeyboardReport all = buildKeyboardReport(VPX_KEYMAP.mapped(), VPX_KEYMAP);
+    const uint8_t keys[] = {HidKey::ENTER, HidKey::N1, HidKey::N5, HidKey::Q, HidKey::T};
+    uint8_t expected[KEYBOARD_BITMAP] = {};
+    for (uint8_t key : keys) { expected[key >> 3] |= 1 << (key & 7); }
+    TEST_ASSERT_EQUAL_HEX8(0x37, all.modifiers);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, all.keys, KEYBOARD_BITMAP);
+}
+
+void test_unbound_and_out_of_range_bindings_are_dropped() {
+    KeyboardHID keyboard;
+    TEST_ASSERT_EQUAL_HEX32(0x3FF, keyboard.mapped());
+    keyboard.setKey(31, HidKey::F1);
+    keyboard.setKey(30, 0x90);                              // Past the bitmap
+    keyboard.setKey(KEYBOARD_BUTTONS, HidKey::A);           // No such bit
+    keyboard.setKey(BTN_TILT, HidKey::NONE);                // Unbound again
+    TEST_ASSERT_EQUAL_HEX32(0x1FF | (3u << 30), keyboard.mapped());
+
+    TEST_ASSERT_TRUE(keyboard.send((1u << 31) | (1u << 30) | (1u << BTN_TILT)));
+    const KeyboardReport& r = *reinterpret_cast<const KeyboardReport*>(native::hidReports.back().data.data());
+    TEST_ASSERT_TRUE(r.has(HidKey::F1));
+    TEST_ASSERT_FALSE(r.has(HidKey::T));
+    TEST_ASSERT_EQUAL_HEX8(0, r.modifiers);
+    uint8_t bits = 0;
+    for (uint8_t k = 0; k < KEYBOARD_BITMAP; k++) { bits += __builtin_popcount(r.keys[k]); }
+    TEST_ASSERT_EQUAL_UINT8(1, bits);
+}
+
+// A button edge goes out as a key report ahead of the gamepad report in the
+// same slot, and the keyed buttons stay out of the gamepad report
+void test_pump_sends_keys_first_and_strips_them_from_the_gamepad() {
+    ScriptedGamepad pad;
+    GamepadHID hid;
+    KeyboardHID keyboard;
+    ReportPump pump(pad, hid);
+    pump.attachKeyboard(&keyboard);
+
+    pad.state.sampled = micros();
+    pump.pump();                                            // Both idle reports
+    TEST_ASSERT_EQUAL_size_t(2, native::hidReports.size());
+    native::hidReports.clear();
+
+    const uint32_t unbound = 1u << 20;
+    pad.state.buttons = (1u << BTN_LEFT_FLIPPER) | (1u << BTN_RIGHT_MAGNA) | unbound;
+    pad.state.sampled = micros();
+    native::advanceUs(300);
+    pump.pump();
+    TEST_ASSERT_EQUAL_size_t(2, native::hidReports.size());
+    TEST_ASSERT_EQUAL_UINT8(KEYBOARD_REPORT_ID, native::hidReports[0].id);
+    TEST_ASSERT_EQUAL_HEX32((1u << BTN_LEFT_FLIPPER) | (1u << BTN_RIGHT_MAGNA),
+                            heldButtons(native::hidReports[0].data.data(), VPX_KEYMAP));
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_REPORT_ID, native::hidReports[1].id);
+    uint32_t padButtons;
+    memcpy(&padButtons, native::hidReports[1].data.data(), sizeof(padButtons));
+    TEST_ASSERT_EQUAL_HEX32(unbound, padButtons);
+    TEST_ASSERT_EQUAL_UINT32(300, pump.keyLatencyMax());
+
+    // Held: nothing new
+    native::hidReports.clear();
+    pump.pump();
+    TEST_ASSERT_EQUAL_size_t(0, native::hidReports.size());
+
+    // A chord change that only touches keyed buttons sends keys alone
+    pad.state.buttons |= 1u << BTN_RIGHT_FLIPPER;
+    pump.pump();
+    TEST_ASSERT_EQUAL_size_t(1, native::hidReports.size());
+    TEST_ASSERT_EQUAL_UINT8(KEYBOARD_REPORT_ID, native::hidReports[0].id);
+    TEST_ASSERT_EQUAL_UINT32(3, pump.keySent());
+}
+
+// A key report the host did not take is retried in the next slot
+void test_failed_key_report_is_retried() {
+    ScriptedGamepad pad;
+    GamepadHID hid;
+    KeyboardHID keyboard;
+    ReportPump pump(pad, hid);
+    pump.attachKeyboard(&keyboard);
+    pump.pump();
+
+    pad.state.buttons = 1u << BTN_LAUNCH;
+    native::hidReady = false;
+    pump.pump();
+    TEST_ASSERT_EQUAL_UINT32(1, pump.keySent());
+    native::hidReady = true;
+    native::hidReports.clear();
+    pump.pump();
+    TEST_ASSERT_EQUAL_UINT32(2, pump.keySent());
+    TEST_ASSERT_EQUAL_UINT8(KEYBOARD_REPORT_ID, native::hidReports[0].id);
+    TEST_ASSERT_EQUAL_HEX32(1u << BTN_LAUNCH, heldButtons(native::hidReports[0].data.data(), VPX_KEYMAP));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_descriptor_matches_the_report);
+    RUN_TEST(test_every_chord_of_bound_buttons_round_trips);
+    RUN_TEST(test_vpx_chords_land_on_the_expected_usages);
+    RUN_TEST(test_unbound_and_out_of_range_bindings_are_dropped);
+    RUN_TEST(test_pump_sends_keys_first_and_strips_them_from_the_gamepad);
+    RUN_TEST(test_failed_key_report_is_retried);
+    return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "Effects.hpp"
+#include "Animator.hpp"
+
+void setUp() { native::resetClock(); }
+void tearDown() {}
+
+/****************************************************************************/
+void test_gamma_lut_is_monotonic_and_spans_12_bits() {
+    TEST_ASSERT_EQUAL_UINT16(0, GAMMA12[0]);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, GAMMA12[255]);
+    for (int k = 1; k < 256; k++) { TEST_ASSERT_TRUE(GAMMA12[k] >= GAMMA12[k - 1]); }
+    // Gamma 2.2: half input is about a fifth of full drive
+    TEST_ASSERT_UINT16_WITHIN(20, 900, GAMMA12[128]);
+}
+
+void test_easing_hits_both_endpoints() {
+    const Ease curves[] = {Ease::LINEAR, Ease::IN, Ease::OUT, Ease::IN_OUT};
+    for (Ease e : curves) {
+        TEST_ASSERT_EQUAL_UINT16(0, easeQ8(0, e));
+        TEST_ASSERT_EQUAL_UINT16(Q8_ONE, easeQ8(Q8_ONE, e));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, easeQ8(200, Ease::STEP));
+    TEST_ASSERT_LESS_THAN(128, easeQ8(128, Ease::IN));
+    TEST_ASSERT_GREATER_THAN(128, easeQ8(128, Ease::OUT));
+    TEST_ASSERT_EQUAL_UINT16(128, easeQ8(128, Ease::IN_OUT));
+}
+
+void test_lerp_is_exact_at_the_ends() {
+    TEST_ASSERT_EQUAL_UINT8(10, lerpQ8(10, 250, 0));
+    TEST_ASSERT_EQUAL_UINT8(250, lerpQ8(10, 250, Q8_ONE));
+    TEST_ASSERT_EQUAL_UINT8(130, lerpQ8(10, 250, 128));
+    TEST_ASSERT_EQUAL_UINT8(130, lerpQ8(250, 10, 128));
+}
+
+/****************************************************************************/
+void test_looping_track_interpolates_and_wraps() {
+    EffectPlayer p;
+    p.play(Effects::CHASE, 1000);
+    RGB c = p.evaluate(1000);
+    TEST_ASSERT_EQUAL_UINT8(255, c.r);
+    TEST_ASSERT_EQUAL_UINT8(0, c.g);
+    c = p.evaluate(2000);                       // On the second key
+    TEST_ASSERT_EQUAL_UINT8(0, c.r);
+    TEST_ASSERT_EQUAL_UINT8(255, c.g);
+    c = p.evaluate(2500);                       // Halfway green -> blue, eased out
+    TEST_ASSERT_GREATER_THAN(c.g, c.b);
+    TEST_ASSERT_GREATER_THAN(127, c.b);
+    c = p.evaluate(4000);                       // One period later: back on red
+    TEST_ASSERT_EQUAL_UINT8(255, c.r);
+    TEST_ASSERT_EQUAL_UINT8(0, c.b);
+}
+
+void test_loop_seam_blends_last_key_into_first() {
+    EffectPlayer p;
+    p.play(Effects::CHASE, 0);
+    p.evaluate(2000);
+    const RGB c = p.evaluate(2500);             // Blue -> red across the seam
+    TEST_ASSERT_GREATER_THAN(0, c.r);
+    TEST_ASSERT_GREATER_THAN(0, c.b);
+    TEST_ASSERT_EQUAL_UINT8(0, c.g);
+}
+
+void test_one_shot_holds_its_last_key() {
+    EffectPlayer p;
+    p.play(Effects::FLASH, 0);
+    TEST_ASSERT_EQUAL_UINT8(255, p.evaluate(0).r);
+    TEST_ASSERT_EQUAL_UINT8(0, p.evaluate(250).r);
+    TEST_ASSERT_EQUAL_UINT8(0, p.evaluate(60000).r);
+}
+
+void test_step_keys_hold_until_the_next() {
+    EffectPlayer p;
+    p.play(Effects::PULSE_RED, 0);
+    TEST_ASSERT_EQUAL_UINT8(255, p.evaluate(499).r);
+    TEST_ASSERT_EQUAL_UINT8(0, p.evaluate(500).r);
+    TEST_ASSERT_EQUAL_UINT8(0, p.evaluate(999).r);
+    TEST_ASSERT_EQUAL_UINT8(255, p.evaluate(1000).r);
+}
+
+void test_phase_offset_shifts_the_track() {
+    EffectPlayer a, b;
+    a.play(Effects::PULSE_RED, 0);
+    b.play(Effects::PULSE_RED, 0, 500);
+    TEST_ASSERT_EQUAL_UINT8(255, a.evaluate(100).r);
+    TEST_ASSERT_EQUAL_UINT8(0, b.evaluate(100).r);
+}
+
+/****************************************************************************/
+void test_animator_renders_at_the_frame_rate() {
+    Animator<4> anim;
+    anim.play(0, Effects::SOLID_RED, 0);
+    TEST_ASSERT_TRUE(anim.update(LED_FRAME_MS));
+    TEST_ASSERT_FALSE(anim.update(LED_FRAME_MS + 1));
+    TEST_ASSERT_TRUE(anim.update(2 * LED_FRAME_MS));
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, anim[0].r);
+    TEST_ASSERT_EQUAL_UINT16(0, anim[1].r);                 // Not playing
+    TEST_ASSERT_EQUAL_UINT32(2, anim.frameCount());
+}
+
+void test_animator_scale_dims_the_frame() {
+    Animator<2> anim;
+    anim.play(0, Effects::SOLID_RED, 0);
+    anim.setScale(Q8_ONE / 2);
+    anim.render(0);
+    TEST_ASSERT_UINT16_WITHIN(1, LEVEL_MAX / 2, anim[0].r);
+    TEST_ASSERT_EQUAL_UINT32(LEVEL_MAX, anim.demand());     // Demand is before scaling
+}
+
+void test_play_range_steps_phase() {
+    Animator<3> anim;
+    anim.playRange(0, 3, Effects::PULSE_GREEN, 0, 500);
+    anim.render(100);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, anim[0].g);
+    TEST_ASSERT_EQUAL_UINT16(0, anim[1].g);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, anim[2].g);
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_gamma_lut_is_monotonic_and_spans_12_bits);
+    RUN_TEST(test_easing_hits_both_endpoints);
+    RUN_TEST(test_lerp_is_exact_at_the_ends);
+    RUN_TEST(test_looping_track_interpolates_and_wraps);
+    RUN_TEST(test_loop_seam_blends_last_key_into_first);
+    RUN_TEST(test_one_shot_holds_its_last_key);
+    RUN_TEST(test_step_keys_hold_until_the_next);
+    RUN_TEST(test_phase_offset_shifts_the_track);
+    RUN_TEST(test_animator_renders_at_the_frame_rate);
+    RUN_TEST(test_animator_scale_dims_the_frame);
+    RUN_TEST(test_play_range_steps_phase);
+    return UNITY_END();
+}
@@ -0,0 +1,127 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "LedcAllocator.hpp"
+#include "FadeLED.hpp"
+#include "Solenoid.hpp"
+
+void setUp() {
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_siblings_must_share_a_timer_config() {
+    TEST_ASSERT_TRUE(LedcAllocator::claim(2, 4000, 12));
+    TEST_ASSERT_FALSE(LedcAllocator::claim(3, 20000, 10));     // Same timer, other config
+    TEST_ASSERT_TRUE(LedcAllocator::claim(3, 4000, 12));
+    TEST_ASSERT_FALSE(LedcAllocator::claim(3, 4000, 12));      // Already taken
+    LedcAllocator::release(2);
+    LedcAllocator::release(3);
+    TEST_ASSERT_TRUE(LedcAllocator::claim(3, 20000, 10));      // Timer free again
+}
+
+void test_dynamic_claim_fills_shared_timers_first() {
+    const int8_t a = LedcAllocator::claim(20000, 10);
+    const int8_t b = LedcAllocator::claim(20000, 10);
+    TEST_ASSERT_EQUAL_INT8(0, a);
+    TEST_ASSERT_EQUAL_INT8(1, b);
+    TEST_ASSERT_EQUAL_INT8(2, LedcAllocator::claim(4000, 12));
+}
+
+void test_reserved_channel_is_skipped_by_dynamic_claims() {
+    TEST_ASSERT_TRUE(LedcAllocator::reserve(0, 4000, 12));
+    // A shaker must not land on the reserved timer at its own frequency
+    TEST_ASSERT_EQUAL_INT8(2, LedcAllocator::claim(20000, 10));
+    TEST_ASSERT_EQUAL_INT8(3, LedcAllocator::claim(20000, 10));
+    // An LED may share the timer, but not the channel
+    TEST_ASSERT_EQUAL_INT8(1, LedcAllocator::claim(4000, 12));
+    TEST_ASSERT_TRUE(LedcAllocator::isReserved(0));
+    TEST_ASSERT_FALSE(LedcAllocator::claim(0, 20000, 10));      // Wrong config for the owner
+    TEST_ASSERT_TRUE(LedcAllocator::claim(0, 4000, 12));
+    TEST_ASSERT_FALSE(LedcAllocator::isReserved(0));
+    TEST_ASSERT_EQUAL_UINT8(4, LedcAllocator::freeChannels());
+}
+
+/****************************************************************************/
+void test_solenoid_begins_after_leds_took_channels() {
+    Solenoid solenoid(1, 0);
+    FadeLED led(10);
+    TEST_ASSERT_TRUE(led.begin());
+    TEST_ASSERT_NOT_EQUAL(0, led.getChannel());
+    TEST_ASSERT_TRUE(solenoid.begin());
+    solenoid.setDuty(1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, native::ledc[0].duty);
+    TEST_ASSERT_EQUAL_INT(1, native::ledc[0].pin);
+}
+
+void test_only_two_rgb_lamps_fit_beside_the_solenoid() {
+    Solenoid solenoid(1, 0);
+    RGBFadeLED lamps[LED_PWM_RGB_MAX + 1] = {{10, 11, 12}, {13, 14, 15}, {16, 17, 18}};
+    for (uint8_t k = 0; k < LED_PWM_RGB_MAX; k++) { TEST_ASSERT_TRUE(lamps[k].begin()); }
+    TEST_ASSERT_FALSE(lamps[LED_PWM_RGB_MAX].begin());
+    // The failed lamp gave back what it had claimed
+    TEST_ASSERT_EQUAL_UINT8(1, LedcAllocator::freeChannels());
+    TEST_ASSERT_TRUE(solenoid.begin());
+}
+
+void test_fade_led_breathes_between_levels() {
+    FadeLED led(10);
+    TEST_ASSERT_TRUE(led.begin());
+    const uint8_t ch = static_cast<uint8_t>(led.getChannel());
+    led.breathe(100, 3000, 400, 600);
+    TEST_ASSERT_EQUAL_UINT32(3000, native::ledc[ch].duty);
+    TEST_ASSERT_EQUAL_UINT32(400, native::ledcFade[ch].ms);
+    led.update();                                   // Fade still running: nothing to do
+    TEST_ASSERT_EQUAL_UINT32(3000, native::ledcFade[ch].target);
+    TEST_ASSERT_EQUAL_UINT8(1, native::endFades());
+    led.update();
+    TEST_ASSERT_EQUAL_UINT32(100, native::ledcFade[ch].target);
+    TEST_ASSERT_EQUAL_UINT32(600, native::ledcFade[ch].ms);
+    led.set(50);                                    // Stops breathing
+    native::endFades();
+    led.update();
+    TEST_ASSERT_EQUAL_UINT32(50, native::ledc[ch].duty);
+    led.end();
+    TEST_ASSERT_FALSE(LedcAllocator::isClaimed(ch));
+}
+
+// A level set while a fade runs wins: the fade is stopped, not left to
+// land on its target afterwards
+void test_set_cancels_a_running_fade() {
+    FadeLED led(10);
+    TEST_ASSERT_TRUE(led.begin());
+    const uint8_t ch = static_cast<uint8_t>(led.getChannel());
+    led.fadeTo(4000, 500);
+    TEST_ASSERT_TRUE(led.fading());
+    led.set(200);
+    TEST_ASSERT_FALSE(led.fading());
+    TEST_ASSERT_EQUAL_UINT8(0, native::endFades());         // Nothing left to end
+    TEST_ASSERT_EQUAL_UINT32(200, native::ledc[ch].duty);
+    TEST_ASSERT_EQUAL_UINT16(200, led.getLevel());
+
+    // Same through the RGB lamp's write()
+    RGBFadeLED lamp(11, 12, 13);
+    TEST_ASSERT_TRUE(lamp.begin());
+    lamp.breathe(RGB12{4000, 2000, 1000}, 300, 300);
+    lamp.write(RGB12{10, 20, 30});
+    native::endFades();
+    lamp.update();
+    const RGB12 level = lamp.getLevel();
+    TEST_ASSERT_EQUAL_UINT16(10, level.r);
+    TEST_ASSERT_EQUAL_UINT16(20, level.g);
+    TEST_ASSERT_EQUAL_UINT16(30, level.b);
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_siblings_must_share_a_timer_config);
+    RUN_TEST(test_dynamic_claim_fills_shared_timers_first);
+    RUN_TEST(test_reserved_channel_is_skipped_by_dynamic_claims);
+    RUN_TEST(test_solenoid_begins_after_leds_took_channels);
+    RUN_TEST(test_only_two_rgb_lamps_fit_beside_the_solenoid);
+    RUN_TEST(test_fade_led_breathes_between_levels);
+    RUN_TEST(test_set_cancels_a_running_fade);
+    return UNITY_END();
+}
@@ -0,0 +1,125 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <thread>
+#include <atomic>
+#include "MountTransform.hpp"
+
+static constexpr float G = 9.81f;
+
+static void assertVecWithin(float tol, const Vec3f& expected, const Vec3f& actual) {
+    for (uint8_t k = 0; k < 3; k++) { TEST_ASSERT_FLOAT_WITHIN(tol, expected[k], actual[k]); }
+}
+
+static void assertRotation(const Mat3& m) {
+    const Mat3 i = m * m.transposed();
+    for (uint8_t r = 0; r < 3; r++) {
+        for (uint8_t c = 0; c < 3; c++) { TEST_ASSERT_FLOAT_WITHIN(1e-5f, r == c ? 1.f : 0.f, i.m[r][c]); }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/****************************************************************************/
+// The sensor on the sloped top of a level cabinet reads the slope as tilt;
+// through CABINET_MOUNT it reads level
+void test_cabinet_mount_levels_the_sloped_top() {
+    assertRotation(CABINET_MOUNT);
+    const Vec3f sensed = CABINET_MOUNT.transposed() * Vec3f(0.f, 0.f, G);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CABINET_SLOPE_DEG, fabsf(tiltProjection(sensed)[0]));
+
+    MountTransform mount;
+    Vec3f v = sensed;
+    mount.apply(v);
+    const Vec2f tilt = tiltProjection(v);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.f, tilt[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.f, tilt[1]);
+
+    // A real 2 deg tilt of the cabinet still comes through as 2 deg
+    Vec3f tilted = CABINET_MOUNT.transposed() * (rotationY(-2) * Vec3f(0.f, 0.f, G));
+    mount.apply(tilted);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 2.f, fabsf(tiltProjection(tilted)[0]));
+}
+
+void test_mount_matrix_composes_roll_pitch_yaw() {
+    const Mat3 m = mountMatrix(30, -20, 90);
+    assertRotation(m);
+    const Mat3 expect = rotationZ(90) * rotationY(-20) * rotationX(30);
+    for (uint8_t r = 0; r < 3; r++) {
+        for (uint8_t c = 0; c < 3; c++) { TEST_ASSERT_FLOAT_WITHIN(1e-6f, expect.m[r][c], m.m[r][c]); }
+    }
+    assertVecWithin(1e-6f, Vec3f(0.f, 1.f, 0.f), rotationZ(90) * Vec3f(1.f, 0.f, 0.f));
+}
+
+// Learning from rest gravity in any orientation brings it onto +Z
+void test_learn_levels_any_rest_orientation() {
+    MountTransform mount;
+    const Vec3f rests[] = {
+        Vec3f(0.f, 0.f, G), Vec3f(1.2f, -0.7f, 9.7f), Vec3f(G, 0.f, 0.f),
+        Vec3f(-3.f, 5.f, -7.f), Vec3f(0.f, 0.f, -G), Vec3f(0.001f, 0.f, -G)
+    };
+    for (const Vec3f& rest : rests) {
+        TEST_ASSERT_TRUE(mount.learn(rest));
+        assertRotation(mount.get());
+        Vec3f v = rest;
+        mount.apply(v);
+        assertVecWithin(2e-4f * G, Vec3f(0.f, 0.f, rest.magnitude()), v);
+    }
+
+    // A known yaw turns the horizontal axes and leaves gravity alone
+    TEST_ASSERT_TRUE(mount.learn(Vec3f(0.f, 0.f, G), 90));
+    Vec3f x(1.f, 0.f, 0.f);
+    mount.apply(x);
+    assertVecWithin(1e-6f, Vec3f(0.f, 1.f, 0.f), x);
+}
+
+void test_learn_refuses_a_cabinet_in_motion() {
+    MountTransform mount(mountMatrix(0, 10));
+    const Mat3 before = mount.get();
+    TEST_ASSERT_FALSE(mount.learn(Vec3f(0.f, 0.f, 3.f)));
+    TEST_ASSERT_FALSE(mount.learn(Vec3f(0.f, 12.f, 12.f)));
+    const Mat3 after = mount.get();
+    TEST_ASSERT_EQUAL_MEMORY(&before, &after, sizeof(Mat3));
+}
+
+// set() from another core while apply() runs: every sample goes through
+// one whole matrix, never rows of two. The reader starts once the writer
+// is running and keeps reading until it has seen WRITES sets go by, and
+// the writer keeps going until the reader is done, so the two overlap.
+void test_apply_never_sees_half_a_matrix() {
+    constexpr uint32_t READS = 200000, WRITES = 10000;
+    MountTransform mount(Mat3::identity());
+    const Mat3 turned = rotationZ(90);
+    std::atomic<bool> writing(false), done(false);
+    std::atomic<uint32_t> writes(0);
+    std::thread writer([&]() {
+        writing = true;
+        for (uint32_t n = 0; !done; n++) {
+            mount.set(n & 1 ? turned : Mat3::identity());
+            writes = n + 1;
+        }
+    });
+    while (!writing) { std::this_thread::yield(); }
+    const uint32_t first = writes;
+    uint32_t torn = 0;
+    for (uint32_t reads = 0; reads < READS || writes - first < WRITES; reads++) {
+        Vec3f v(1.f, 2.f, 3.f);
+        mount.apply(v);
+        const bool same = v[0] == 1.f && v[1] == 2.f;
+        const bool turnedOk = fabsf(v[0] + 2.f) < 1e-6f && fabsf(v[1] - 1.f) < 1e-6f;
+        torn += !(same || turnedOk) || v[2] != 3.f;
+    }
+    done = true;
+    writer.join();
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cabinet_mount_levels_the_sloped_top);
+    RUN_TEST(test_mount_matrix_composes_roll_pitch_yaw);
+    RUN_TEST(test_learn_levels_any_rest_orientation);
+    RUN_TEST(test_learn_refuses_a_cabinet_in_motion);
+    RUN_TEST(test_apply_never_sees_half_a_matrix);
+    return UNITY_END();
+}
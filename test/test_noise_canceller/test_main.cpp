@@ -0,0 +1,136 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "utilities.hpp"
+#include "NoiseCanceller.hpp"
+
+// Synthetic cabinet at SMPL_FREQ: each drive is a haptic-style burst
+// train, every change of drive rings the cabinet at 5-15 Hz (inside the
+// filter span, below Nyquist), and a slow player tilt rides on top
+template<uint8_t Refs, uint8_t Taps>
+struct Cabinet {
+    float h[3][Refs][Taps];
+    int16_t hist[Refs][Taps] = {};
+    int16_t level[Refs] = {};
+    uint32_t seed = 12345;
+    bool driving = true;
+
+    Cabinet() {
+        for (uint8_t a = 0; a < 3; a++) {
+            for (uint8_t r = 0; r < Refs; r++) {
+                for (uint8_t t = 0; t < Taps; t++) {
+                    const float f = (1 + (a + r) % 3) * 5.f / SMPL_FREQ;
+                    h[a][r][t] = 0.02f * expf(-4.f * t / Taps) * sinf(TWO_PI * f * t) / (1 + a);
+                }
+            }
+        }
+    }
+
+    // Next drive levels and sample; `tilt` and `noise` are the two parts of d
+    void step(uint32_t n, int16_t (&refs)[Refs], int32_t (&d)[3], int32_t (&tilt)[3], int32_t (&noise)[3]) {
+        for (uint8_t r = 0; r < Refs; r++) {
+            seed = seed * 1664525u + 1013904223u;
+            if (driving) {
+                if ((seed >> 24) < 8) { level[r] = (seed >> 12) & 0x0FFF; }
+                else if ((seed >> 24) < 12) { level[r] = 0; }
+            }
+            refs[r] = level[r];
+            memmove(&hist[r][1], &hist[r][0], (Taps - 1) * sizeof(int16_t));
+            hist[r][0] = refs[r];
+        }
+        for (uint8_t a = 0; a < 3; a++) {
+            float v = 0.f;
+            for (uint8_t r = 0; r < Refs; r++) {
+                for (uint8_t t = 1; t < Taps; t++) { v += h[a][r][t] * (hist[r][t - 1] - hist[r][t]); }
+            }
+            noise[a] = static_cast<int32_t>(lroundf(v * ACCEL_Q8));
+            tilt[a] = static_cast<int32_t>(ACCEL_Q8 * (a == 2 ? 9.8f : 0.5f * sinf(TWO_PI * 0.05f * (a + 1) * n / SMPL_FREQ)));
+            d[a] = tilt[a] + noise[a];
+        }
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+/****************************************************************************/
+void test_cancels_drive_rings_at_the_sample_rate() {
+    constexpr uint8_t REFS = 2, TAPS = 16;
+    NoiseCanceller<REFS, TAPS> canceller;
+    Cabinet<REFS, TAPS> cabinet;
+    const uint32_t samples = 120 * SMPL_FREQ;               // Two minutes
+    double before = 0, after = 0;
+    for (uint32_t n = 0; n < samples; n++) {
+        int16_t refs[REFS];
+        int32_t d[3], tilt[3], noise[3];
+        cabinet.step(n, refs, d, tilt, noise);
+        canceller.process(refs, d);
+        if (n < samples / 2) { continue; }
+        for (uint8_t a = 0; a < 3; a++) {
+            before += static_cast<double>(noise[a]) * noise[a];
+            after += static_cast<double>(d[a] - tilt[a]) * (d[a] - tilt[a]);
+        }
+    }
+    const double db = 10.0 * log10(before / after);
+    TEST_PRINTF("cancellation %.1f dB at %.0f Hz\n", db, SMPL_FREQ);
+    TEST_ASSERT_GREATER_THAN(20.0, db);
+}
+
+// Once the drives go quiet, what is left is the player: it passes through
+void test_player_tilt_passes_through_when_drives_settle() {
+    constexpr uint8_t REFS = 2, TAPS = 16;
+    NoiseCanceller<REFS, TAPS> canceller;
+    Cabinet<REFS, TAPS> cabinet;
+    uint32_t n = 0;
+    int16_t refs[REFS];
+    int32_t d[3], tilt[3], noise[3];
+    for (; n < 60 * SMPL_FREQ; n++) {
+        cabinet.step(n, refs, d, tilt, noise);
+        canceller.process(refs, d);
+    }
+    cabinet.driving = false;                                // Drives hold their levels
+    for (uint32_t end = n + 8 * 2.56f * SMPL_FREQ; n < end; n++) {     // 8 DC time constants
+        cabinet.step(n, refs, d, tilt, noise);
+        canceller.process(refs, d);
+    }
+    for (uint32_t end = n + 10 * SMPL_FREQ; n < end; n++) {
+        cabinet.step(n, refs, d, tilt, noise);
+        canceller.process(refs, d);
+        for (uint8_t a = 0; a < 3; a++) { TEST_ASSERT_INT_WITHIN(ACCEL_Q8 / 50, tilt[a], d[a]); }
+    }
+}
+
+void test_idle_references_leave_samples_alone() {
+    NoiseCanceller<2> canceller;
+    const int16_t refs[2] = {0, 0};
+    for (uint32_t n = 0; n < 1000; n++) {
+        int32_t d[3] = {static_cast<int32_t>(n % 97) - 48, 100, 9 * ACCEL_Q8};
+        const int32_t in[3] = {d[0], d[1], d[2]};
+        canceller.process(refs, d);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(in, d, 3);
+    }
+}
+
+// apply() reads the bound drives itself
+void test_apply_reads_bound_drives() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    NoiseCanceller<1> canceller;
+    TEST_ASSERT_EQUAL_INT8(0, canceller.addReference(coil));
+    TEST_ASSERT_EQUAL_INT8(-1, canceller.addReference(coil));
+    for (uint32_t n = 0; n < 2000; n++) {
+        coil.setDuty((n / 20) % 2 ? 4095 : 0);
+        Vec3f coords(0.f, 0.f, 9.81f);
+        canceller.apply(coords);
+        TEST_ASSERT_FLOAT_WITHIN(1.f / ACCEL_Q8, 9.81f, coords[2]);   // Nothing to cancel
+    }
+    TEST_ASSERT_EQUAL_UINT32(2000, canceller.samples());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cancels_drive_rings_at_the_sample_rate);
+    RUN_TEST(test_player_tilt_passes_through_when_drives_settle);
+    RUN_TEST(test_idle_references_leave_samples_alone);
+    RUN_TEST(test_apply_reads_bound_drives);
+    return UNITY_END();
+}
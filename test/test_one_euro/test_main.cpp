@@ -0,0 +1,145 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "OneEuro.hpp"
+
+static uint32_t seed;
+static float noise(float amp) {
+    seed = seed * 1664525u + 1013904223u;
+    return amp * (((seed >> 8) & 0xFFFF) / 32767.5f - 1.f);
+}
+
+// Std dev of the output over the second half of n noisy resting samples
+template<typename Filter>
+static float restJitter(Filter& filter, float amp, uint32_t n = 2000) {
+    double sum = 0, sumSq = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        const float y = filter.apply(Vector<float, 1>(noise(amp)))[0];
+        if (k >= n / 2) { sum += y; sumSq += static_cast<double>(y) * y; }
+    }
+    const double m = sum / (n / 2);
+    return static_cast<float>(sqrt(sumSq / (n / 2) - m * m));
+}
+
+// Samples of lag behind a clean ramp of `speed` units/s, once settled
+template<typename Filter>
+static float rampLag(Filter& filter, float speed, uint32_t n = 2000) {
+    float x = 0.f, y = 0.f;
+    for (uint32_t k = 0; k < n; k++) {
+        x = speed * k / SMPL_FREQ;
+        y = filter.apply(Vector<float, 1>(x))[0];
+    }
+    return (x - y) / (speed / SMPL_FREQ);
+}
+
+void setUp() { seed = 777; }
+void tearDown() {}
+
+/****************************************************************************/
+void test_first_sample_primes_the_output() {
+    OneEuroFilter<2> filter;
+    const Vector<float, 2> y = filter.apply(Vector<float, 2>(3.f, -2.f));
+    TEST_ASSERT_EQUAL_FLOAT(3.f, y[0]);
+    TEST_ASSERT_EQUAL_FLOAT(-2.f, y[1]);
+    filter.apply(Vector<float, 2>(0.f, 0.f));
+    filter.reset();
+    TEST_ASSERT_EQUAL_FLOAT(7.f, filter.apply(Vector<float, 2>(7.f, 0.f))[0]);
+}
+
+// With beta = 0 it is a plain one-pole at minCutoff
+void test_zero_beta_is_a_one_pole_at_min_cutoff() {
+    OneEuroFilter<1> filter(SMPL_FREQ, OneEuroParams{2.f, 0.f, 1.f});
+    const float tau = 1.f / (2.f * PI * 2.f);
+    const float a = 1.f / (1.f + tau * SMPL_FREQ);
+    filter.apply(0.f);
+    float expected = 0.f;
+    for (uint8_t k = 0; k < 20; k++) {
+        expected += a * (1.f - expected);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected, filter.apply(1.f));
+    }
+}
+
+// Resting noise is smoothed as hard as by the slow one-pole...
+void test_rest_jitter_is_suppressed() {
+    OneEuroFilter<1> euro(SMPL_FREQ, OneEuroParams{1.f, 0.05f, 1.f});
+    const float jitter = restJitter(euro, 0.05f);
+    seed = 777;
+    OneEuroFilter<1> plain(SMPL_FREQ, OneEuroParams{1.f, 0.f, 1.f});
+    const float plainJitter = restJitter(plain, 0.05f);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05f / sqrtf(3.f) / 3.f, jitter);     // Input std dev / 3
+    TEST_ASSERT_LESS_THAN_FLOAT(plainJitter * 1.2f, jitter);
+}
+
+// ...while a moving input opens the cutoff: less lag than a Butterworth
+// tuned to the same rest jitter
+void test_ramp_lags_less_than_butterworth_at_equal_jitter() {
+    const OneEuroParams params{1.f, 0.05f, 1.f};
+    OneEuroFilter<1> euro(SMPL_FREQ, params);
+    const float jitter = restJitter(euro, 0.05f);
+    ButterworthFilter<1> butter(1.f);
+    float lo = 0.01f, hi = 0.45f * SMPL_FREQ;
+    for (uint8_t i = 0; i < 30; i++) {
+        const float mid = sqrtf(lo * hi);
+        butter.setCutoff(mid);
+        seed = 777;
+        if (restJitter(butter, 0.05f) > jitter) { hi = mid; } else { lo = mid; }
+    }
+    butter.setCutoff(lo);
+    euro.reset();
+    const float euroLag = rampLag(euro, 2.f);
+    const float butterLag = rampLag(butter, 2.f);
+    TEST_ASSERT_LESS_THAN_FLOAT(butterLag / 1.5f, euroLag);
+
+    OneEuroFilter<1> plain(SMPL_FREQ, OneEuroParams{1.f, 0.f, 1.f});
+    TEST_ASSERT_LESS_THAN_FLOAT(rampLag(plain, 2.f) / 1.5f, euroLag);
+}
+
+// apply(x, dt) at the nominal dt matches apply(x); dt <= 0 holds the output
+void test_irregular_dt() {
+    OneEuroFilter<1> nominal, timed;
+    for (uint32_t k = 0; k < 200; k++) {
+        const float x = sinf(k * 0.05f) + noise(0.02f);
+        const float y = nominal.apply(x);
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, y, timed.apply(Vector<float, 1>(x), 1.f / SMPL_FREQ)[0]);
+    }
+    const float held = timed.current()[0];
+    TEST_ASSERT_EQUAL_FLOAT(held, timed.apply(Vector<float, 1>(50.f), 0.f)[0]);
+
+    // A longer gap moves further towards the input
+    OneEuroFilter<1> a, b;
+    a.apply(Vector<float, 1>(0.f), 0.01f);
+    b.apply(Vector<float, 1>(0.f), 0.01f);
+    TEST_ASSERT_GREATER_THAN_FLOAT(a.apply(Vector<float, 1>(1.f), 0.01f)[0],
+                                   b.apply(Vector<float, 1>(1.f), 0.05f)[0]);
+}
+
+// Every channel keeps its own tunables and state
+void test_channels_are_independent() {
+    OneEuroFilter<2> filter;
+    filter.setParams(1, OneEuroParams{20.f, 0.f, 1.f});
+    TEST_ASSERT_EQUAL_FLOAT(20.f, filter.getParams(1).minCutoff);
+    TEST_ASSERT_EQUAL_FLOAT(1.f, filter.getParams(0).minCutoff);
+    filter.apply(Vector<float, 2>(0.f, 0.f));
+    const Vector<float, 2> y = filter.apply(Vector<float, 2>(1.f, 1.f));
+    TEST_ASSERT_GREATER_THAN_FLOAT(y[0] * 5.f, y[1]);
+}
+
+void test_butterworth_starts_settled_with_unit_dc_gain() {
+    ButterworthFilter<1> butter(5.f);
+    for (uint8_t k = 0; k < 10; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.5f, butter.apply(Vector<float, 1>(2.5f))[0]);
+    }
+    for (uint32_t k = 0; k < 500; k++) { butter.apply(Vector<float, 1>(-1.f)); }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, -1.f, butter.apply(Vector<float, 1>(-1.f))[0]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_primes_the_output);
+    RUN_TEST(test_zero_beta_is_a_one_pole_at_min_cutoff);
+    RUN_TEST(test_rest_jitter_is_suppressed);
+    RUN_TEST(test_ramp_lags_less_than_butterworth_at_equal_jitter);
+    RUN_TEST(test_irregular_dt);
+    RUN_TEST(test_channels_are_independent);
+    RUN_TEST(test_butterworth_starts_settled_with_unit_dc_gain);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "PinballHID.hpp"
+
+static constexpr float G = 9.80665f;
+
+// A Gamepad whose state the test sets by hand
+class ScriptedGamepad : public Gamepad {
+public:
+    GamepadState state;
+    void update() override {}
+    GamepadState getState() override { return state; }
+};
+
+// 40 ms half-sine shove of `peak` m/s^2 along X, starting at t = 0
+static float shove(float t, float peak) {
+    return t >= 0.f && t < 0.04f ? peak * sinf(PI * t / 0.04f) : 0.f;
+}
+
+// Feeds the shove at `periodUs` and returns the peak and final vxNudge
+static void runShove(uint32_t periodUs, float peak, int16_t& vPeak, int16_t& vEnd) {
+    PinballEncoder encoder;
+    GamepadState state;
+    PinballReport report;
+    vPeak = 0;
+    for (uint32_t us = 0; us <= 2000000; us += periodUs) {
+        state.sampled = 1000000 + us;
+        state.nudge[0] = toNudge(shove(us * 1e-6f, peak));
+        encoder.encode(state, report);
+        vPeak = max(vPeak, report.vxNudge);
+    }
+    vEnd = report.vxNudge;
+}
+
+void setUp() {
+    native::resetClock(1000);
+    native::hidReports.clear();
+    native::hidReady = true;
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_nudge_scale_is_two_g_full_range() {
+    TEST_ASSERT_INT_WITHIN(1, AXIS_MAX / 2, toNudge(G));
+    TEST_ASSERT_INT_WITHIN(1, -AXIS_MAX / 4, toNudge(-0.5f * G));
+    TEST_ASSERT_EQUAL_INT16(0, toNudge(0.f));
+    TEST_ASSERT_EQUAL_INT16(AXIS_MAX, toNudge(3.f * G));
+    TEST_ASSERT_EQUAL_INT16(-AXIS_MAX, toNudge(-3.f * G));
+}
+
+// The report carries the nudge residual, never the tilt: a cabinet held at
+// full tilt reads no acceleration and builds no velocity
+void test_tilt_is_not_a_nudge() {
+    PinballEncoder encoder;
+    GamepadState state;
+    PinballReport report;
+    state.axis[AXIS_X] = AXIS_MAX;
+    state.axis[AXIS_Y] = -AXIS_MAX;
+    for (uint32_t n = 0; n < 1000; n++) {
+        state.sampled = n * 1000;
+        encoder.encode(state, report);
+    }
+    TEST_ASSERT_EQUAL_INT16(0, report.axNudge);
+    TEST_ASSERT_EQUAL_INT16(0, report.ayNudge);
+    TEST_ASSERT_EQUAL_INT16(0, report.vxNudge);
+    TEST_ASSERT_EQUAL_INT16(0, report.vyNudge);
+
+    state.nudge[0] = toNudge(-1.f);
+    state.nudge[1] = toNudge(2.f);
+    encoder.encode(state, report);
+    TEST_ASSERT_EQUAL_INT16(toNudge(-1.f), report.axNudge);
+    TEST_ASSERT_EQUAL_INT16(toNudge(2.f), report.ayNudge);
+}
+
+// A held acceleration a settles at a * tau (the leak), in mm/s
+void test_velocity_is_the_leaky_integral_in_mm_per_s() {
+    PinballEncoder encoder;
+    GamepadState state;
+    PinballReport report;
+    state.nudge[0] = toNudge(1.f);
+    state.nudge[1] = toNudge(-2.f);
+    for (uint32_t n = 0; n <= 3000; n++) {
+        state.sampled = n * 1000;
+        encoder.encode(state, report);
+        if (n == 10) { TEST_ASSERT_INT_WITHIN(1, 10, report.vxNudge); }   // 1 m/s^2 for 10 ms
+    }
+    TEST_ASSERT_INT_WITHIN(3, 1000.f * NUDGE_VELOCITY_TAU_S, report.vxNudge);
+    TEST_ASSERT_INT_WITHIN(3, -2000.f * NUDGE_VELOCITY_TAU_S, report.vyNudge);
+}
+
+// A shove: the velocity rises to about its integral, returns to rest, and
+// does not depend on how often states arrive
+void test_shove_velocity_is_rate_independent_and_settles() {
+    const float peak = 12.f;
+    const float area = peak * 0.04f * 2.f / PI;                         // m/s, without the leak
+    int16_t fastPeak, fastEnd, slowPeak, slowEnd;
+    runShove(1000, peak, fastPeak, fastEnd);
+    runShove(10000, peak, slowPeak, slowEnd);
+    TEST_ASSERT_INT_WITHIN(0.1f * area * 1000.f, 0.92f * area * 1000.f, fastPeak);
+    TEST_ASSERT_INT_WITHIN(0.1f * fastPeak, fastPeak, slowPeak);
+    TEST_ASSERT_EQUAL_INT16(0, fastEnd);
+    TEST_ASSERT_EQUAL_INT16(0, slowEnd);
+
+    // A hard hit saturates rather than wrapping
+    runShove(1000, 3.f * G, fastPeak, fastEnd);
+    TEST_ASSERT_GREATER_THAN(0, fastPeak);
+}
+
+void test_buttons_and_plunger() {
+    PinballEncoder encoder;
+    GamepadState state;
+    PinballReport report;
+    state.sampled = 1000;
+    state.buttons = (1u << BTN_LEFT_FLIPPER) | (1u << BTN_LAUNCH) | (1u << BTN_TILT);
+    encoder.encode(state, report);
+    TEST_ASSERT_EQUAL_HEX32(state.buttons, report.genericButtons);
+    TEST_ASSERT_EQUAL_HEX32((1u << OPD_LEFT_FLIPPER) | (1u << OPD_LAUNCH) | (1u << OPD_TILT_BOB), report.pinballButtons);
+    TEST_ASSERT_EQUAL_UINT8(255, report.llFlipper);
+    TEST_ASSERT_EQUAL_UINT8(0, report.lrFlipper);
+
+    // Pulled back over 100 ms at 10 ms plunger updates, 1 ms states
+    for (uint32_t ms = 1; ms <= 100; ms++) {
+        state.sampled = 1000 + ms * 1000;
+        if (ms % 10 == 0) { state.axis[AXIS_Z] = static_cast<int16_t>(ms * 300); }
+        encoder.encode(state, report);
+    }
+    TEST_ASSERT_EQUAL_INT16(30000, report.plungerPos);
+    TEST_ASSERT_INT_WITHIN(1, 300000.f * PLUNGER_SPEED_FULL_S, report.plungerSpeed);
+    state.sampled += PLUNGER_STILL_US + 1000;
+    encoder.encode(state, report);
+    TEST_ASSERT_EQUAL_INT16(0, report.plungerSpeed);
+}
+
+void test_pump_sends_only_changes_and_patches_the_usage_string() {
+    ScriptedGamepad pad;
+    PinballHID hid;
+    PinballPump pump(pad, hid);
+    uint8_t desc[64];
+    const uint16_t len = hid._onGetDescriptor(desc);
+    TEST_ASSERT_TRUE(hidReportMatches(desc, len, PINBALL_REPORT_ID, sizeof(PinballReport)));
+    TEST_ASSERT_EQUAL_STRING(PINBALL_USAGE_STRING, native::usbStrings.back().c_str());
+    TEST_ASSERT_NOT_EQUAL(0, desc[11]);                                 // String Index filled in
+
+    pad.state.sampled = micros();
+    pump.pump();
+    native::advanceUs(1000);
+    pad.state.sampled = micros();
+    pump.pump();                                                        // Only the timestamp moved
+    TEST_ASSERT_EQUAL_UINT32(1, pump.sent());
+
+    pad.state.nudge[0] = toNudge(3.f);
+    native::advanceUs(1000);
+    pad.state.sampled = micros();
+    pump.pump();
+    TEST_ASSERT_EQUAL_UINT32(2, pump.sent());
+    const native::HidReport& r = native::hidReports.back();
+    TEST_ASSERT_EQUAL_UINT8(PINBALL_REPORT_ID, r.id);
+    TEST_ASSERT_EQUAL_size_t(sizeof(PinballReport), r.data.size());
+    PinballReport sent;
+    memcpy(&sent, r.data.data(), sizeof(sent));
+    TEST_ASSERT_EQUAL_INT16(toNudge(3.f), sent.axNudge);
+    TEST_ASSERT_EQUAL_INT16(3, sent.vxNudge);                           // 3 m/s^2 for 1 ms
+    TEST_ASSERT_EQUAL_UINT64(pad.state.sampled, sent.timestamp);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_nudge_scale_is_two_g_full_range);
+    RUN_TEST(test_tilt_is_not_a_nudge);
+    RUN_TEST(test_velocity_is_the_leaky_integral_in_mm_per_s);
+    RUN_TEST(test_shove_velocity_is_rate_independent_and_settles);
+    RUN_TEST(test_buttons_and_plunger);
+    RUN_TEST(test_pump_sends_only_changes_and_patches_the_usage_string);
+    return UNITY_END();
+}
@@ -0,0 +1,190 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "PowerArbiter.hpp"
+#include "Compositor.hpp"
+#include "Effects.hpp"
+#include "CoilScheduler.hpp"
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+// Same estimate as the arbiter, from what was actually written
+static uint32_t mw(Rail rail, uint32_t mA) {
+    const RailSpec& r = RAILS[static_cast<uint8_t>(rail)];
+    return (mA * r.mV / 1000) * 100 / r.efficiency;
+}
+
+template<size_t N>
+static uint32_t frameMa(const RGB12* frame, uint16_t mAPerChannel) {
+    uint64_t sum = 0;
+    for (size_t k = 0; k < N; k++) { sum += frame[k].r + frame[k].g + frame[k].b; }
+    return static_cast<uint32_t>(sum * mAPerChannel / LEVEL_MAX);
+}
+
+/****************************************************************************/
+void test_demand_jump_is_scaled_in_the_same_frame() {
+    PowerArbiter power(40000);
+    const int8_t group = power.addLeds(Rail::V12, 20);
+    Compositor<100> strip;
+    strip.attachPower(power, group);
+    strip.render(0);                                        // Dark frame: no scaling
+    TEST_ASSERT_EQUAL_UINT16(256, power.groupScale(group));
+
+    strip.flash(Effects::WHITE, 1000, 20);                           // 300 channels x 20 mA = 6 A at 12 V
+    strip.render(20);
+    const uint32_t drawn = mw(Rail::V12, frameMa<100>(strip.frame(), 20));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(40000, drawn);
+    TEST_ASSERT_GREATER_THAN(35000, drawn);                 // And not needlessly dim
+}
+
+void test_groups_share_what_the_others_left() {
+    PowerArbiter power(30000);
+    const int8_t strip = power.addLeds(Rail::V12, 20);
+    const int8_t buttons = power.addLeds(Rail::V5, 20);
+    Animator<100> a;
+    Animator<100> b;
+    a.attachPower(power, strip);
+    b.attachPower(power, buttons);
+    a.playRange(0, 100, Effects::SOLID_RED, 0);
+    a.render(0);                                            // Alone: 2 A at 12 V fits
+    TEST_ASSERT_EQUAL_UINT16(256, a.scale());
+    b.playRange(0, 100, Effects::SOLID_RED, 0);
+    b.render(0);                                            // Only what the strip left
+    const uint32_t total = mw(Rail::V12, frameMa<100>(a.frame(), 20)) + mw(Rail::V5, frameMa<100>(b.frame(), 20));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(30000, total);
+    a.render(20);                                           // Next frame: fair shares
+    b.render(20);
+    TEST_ASSERT_UINT16_WITHIN(2, a.scale(), b.scale());
+}
+
+void test_coil_waits_for_leds_to_dim() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    PowerArbiter power(60000, 0);
+    const int8_t c = power.addCoil(coil, 3000);             // 40 W at full duty
+    const int8_t group = power.addLeds(Rail::V12, 20);
+    Animator<100> leds;
+    leds.attachPower(power, group);
+    leds.playRange(0, 100, Effects::SOLID_RED, 0);
+    leds.render(0);                                         // 26.7 W, unscaled
+    native::advanceUs(1000);
+    TEST_ASSERT_FALSE(power.admit(c, 20000));               // Fits at the floor, not as lit now
+    TEST_ASSERT_EQUAL_UINT32(1, power.claims());
+    leds.render(20);                                        // Makes room for the claim
+    TEST_ASSERT_LESS_THAN(256, leds.scale());
+    TEST_ASSERT_TRUE(power.admit(c, 20000));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(60000, power.totalMilliwatts());
+}
+
+// A claim and a reservation left behind by a deferred fire must not come
+// back once micros() has moved on by more than 2^31 us
+void test_stale_claims_stay_gone_across_a_wrap() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    PowerArbiter power(60000, 0);
+    const int8_t c = power.addCoil(coil, 3000);
+    const int8_t group = power.addLeds(Rail::V12, 20);
+    Animator<100> leds;
+    leds.attachPower(power, group);
+    leds.playRange(0, 100, Effects::SOLID_RED, 0);
+    leds.render(0);
+    TEST_ASSERT_FALSE(power.admit(c, 20000));               // Leaves a claim
+    TEST_ASSERT_EQUAL_UINT32(1, power.claims());
+
+    native::advanceUs((1ull << 31) + 1000);                 // Idle, nothing rendered
+    leds.render(millis());
+    TEST_ASSERT_EQUAL_UINT32(0, power.coilMilliwatts());
+    TEST_ASSERT_EQUAL_UINT16(256, leds.scale());
+
+    TEST_ASSERT_FALSE(power.admit(c, 20000));               // A fresh claim, then the kick
+    TEST_ASSERT_EQUAL_UINT32(2, power.claims());
+    leds.render(millis());
+    TEST_ASSERT_TRUE(power.admit(c, 20000));
+    native::advanceUs(20000);
+    native::advanceUs((1ull << 31) + 1000);
+    leds.render(millis());                                  // A reservation long over
+    TEST_ASSERT_EQUAL_UINT32(0, power.coilMilliwatts());
+    TEST_ASSERT_EQUAL_UINT16(256, leds.scale());
+}
+
+/****************************************************************************/
+// Multiball storm for one simulated minute. Strip flashes and button
+// effects switch demand from dark to full white between frames; two
+// flippers and two thumpers are hammered and retried until admitted.
+// Every 100 us the draw is recomputed from the duties and frames actually
+// written and must stay within the budget.
+void test_event_storm_never_exceeds_the_budget() {
+    constexpr uint32_t STEP_US = 100;
+    constexpr PulseProfile FLIPPER = {30000, 4095, 800, 2000000};
+    constexpr PulseProfile THUMPER = {20000, 4095, 1200, 100000};
+    constexpr uint16_t COIL_MA[4] = {3000, 3000, 2500, 2500};
+
+    Solenoid coils[4] = {{1, 0}, {2, 1}, {3, 2}, {4, 3}};
+    CoilScheduler sched;
+    PowerArbiter power;
+    for (uint8_t k = 0; k < 4; k++) {
+        coils[k].begin();
+        sched.add(coils[k], k < 2 ? FLIPPER : THUMPER);
+        power.addCoil(coils[k], COIL_MA[k], k < 2 ? PowerArbiter::PRIORITY_HIGH : 0);
+    }
+    const int8_t stripGroup = power.addLeds(Rail::V12, 20);
+    const int8_t buttonGroup = power.addLeds(Rail::V5, 20);
+    Compositor<300> strip;
+    Animator<48> buttons;
+    strip.attachPower(power, stripGroup);
+    buttons.attachPower(power, buttonGroup);
+
+    uint32_t seed = 4242;
+    auto rnd = [&](uint32_t n) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % n; };
+    bool want[4] = {};
+    uint32_t fired = 0, frames = 0, worst = 0;
+
+    for (uint32_t step = 0; step < 60u * 1000000 / STEP_US; step++) {
+        const uint32_t ms = millis();
+        if (rnd(200) == 0) { strip.flash(Effects::WHITE, 50 + rnd(400), ms); }
+        if (rnd(300) == 0) { strip.base().playRange(0, 300, rnd(2) ? Effects::CHASE : Effects::OFF, ms, 10); }
+        if (rnd(300) == 0) { buttons.playRange(0, 48, rnd(2) ? Effects::PULSE_RED : Effects::BREATHING_RAINBOW, ms, 20); }
+        for (uint8_t k = 0; k < 4; k++) {
+            if (rnd(k < 2 ? 400 : 150) == 0) { want[k] = true; }
+            if (k < 2 && sched.isActive(k) && rnd(1000) == 0) { sched.release(k); }
+            if (want[k] && !sched.isActive(k) && power.admit(k, sched.getProfile(k).kickUs)) {
+                sched.fire(k);
+                want[k] = false;
+                fired++;
+            }
+        }
+        if (strip.update(ms)) { frames++; }
+        buttons.update(ms);
+        native::advanceUs(STEP_US);
+
+        uint32_t draw = mw(Rail::V12, frameMa<300>(strip.frame(), 20)) + mw(Rail::V5, frameMa<48>(buttons.frame(), 20));
+        for (uint8_t k = 0; k < 4; k++) { draw += mw(Rail::V12, COIL_MA[k] * coils[k].getDuty() / 4095); }
+        worst = max(worst, draw);
+        if (draw > SUPPLY_BUDGET_MW) {
+            TEST_PRINTF("over budget at %lu us: %lu mW\n", static_cast<unsigned long>(micros()), static_cast<unsigned long>(draw));
+            TEST_FAIL_MESSAGE("Storm exceeded the supply budget");
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(500, fired);
+    TEST_ASSERT_GREATER_THAN(2900, frames);
+    TEST_ASSERT_GREATER_THAN(0, power.scaledFrames());
+    TEST_ASSERT_GREATER_THAN(0, power.deferred());
+    TEST_ASSERT_GREATER_THAN(SUPPLY_BUDGET_MW * 9 / 10, worst);     // The storm did push the limit
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_demand_jump_is_scaled_in_the_same_frame);
+    RUN_TEST(test_groups_share_what_the_others_left);
+    RUN_TEST(test_coil_waits_for_leds_to_dim);
+    RUN_TEST(test_stale_claims_stay_gone_across_a_wrap);
+    RUN_TEST(test_event_storm_never_exceeds_the_budget);
+    return UNITY_END();
+}
@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "GamepadHID.hpp"
+
+static GamepadState state(uint32_t buttons, int16_t x = 0, int16_t y = 0, int16_t z = 0) {
+    GamepadState s;
+    s.buttons = buttons;
+    s.axis[AXIS_X] = x;
+    s.axis[AXIS_Y] = y;
+    s.axis[AXIS_Z] = z;
+    return s;
+}
+
+void setUp() {
+    native::resetClock(1000);
+    native::hidReports.clear();
+    native::hidReady = true;
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_filter_reports_first_state_and_button_edges() {
+    ReportFilter filter(64);
+    TEST_ASSERT_TRUE(filter.changed(state(0)));             // Nothing sent yet
+    filter.sent(state(0));
+    TEST_ASSERT_FALSE(filter.changed(state(0)));
+    TEST_ASSERT_TRUE(filter.changed(state(1u << BTN_LAUNCH)));
+    filter.sent(state(1u << BTN_LAUNCH));
+    TEST_ASSERT_TRUE(filter.changed(state(0)));             // Release is an edge too
+    filter.reset();
+    TEST_ASSERT_TRUE(filter.changed(state(1u << BTN_LAUNCH)));
+}
+
+void test_filter_thresholds_axes_against_the_last_sent_state() {
+    ReportFilter filter(64);
+    filter.sent(state(0, 1000));
+    TEST_ASSERT_FALSE(filter.changed(state(0, 1064)));
+    TEST_ASSERT_TRUE(filter.changed(state(0, 1065)));
+    TEST_ASSERT_TRUE(filter.changed(state(0, 935)));
+
+    // A slow drift never moves 64 between two states, but adds up
+    int16_t x = 1000;
+    uint16_t reports = 0;
+    for (uint16_t k = 0; k < 100; k++) {
+        x += 10;
+        if (filter.changed(state(0, x))) {
+            filter.sent(state(0, x));
+            reports++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(1000 / 70, reports);
+    TEST_ASSERT_INT_WITHIN(64, x, filter.last().axis[AXIS_X]);
+}
+
+void test_filter_thresholds_per_axis() {
+    ReportFilter filter(64);
+    filter.setThreshold(AXIS_Z, 0);                         // Plunger: every count
+    filter.setThreshold(GAMEPAD_AXES, 0);                   // Ignored
+    filter.sent(state(0));
+    TEST_ASSERT_TRUE(filter.changed(state(0, 0, 0, 1)));
+    TEST_ASSERT_FALSE(filter.changed(state(0, 64, -64, 0)));
+}
+
+void test_coalescer_counts_superseded_states() {
+    Coalescer co;
+    TEST_ASSERT_EQUAL_UINT32(0, co.take(7));                // First send: nothing before it counts
+    TEST_ASSERT_EQUAL_UINT32(0, co.take(8));
+    TEST_ASSERT_EQUAL_UINT32(3, co.take(12));               // 9, 10, 11 never went out
+    co.skip(13);                                            // Unneeded, not superseded
+    TEST_ASSERT_EQUAL_UINT32(0, co.take(14));
+    TEST_ASSERT_EQUAL_UINT32(3, co.superseded());
+    co.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, co.take(0xFFFFFFF0u));
+    TEST_ASSERT_EQUAL_UINT32(17, co.take(2));               // Across the version wrap
+}
+
+// Producer at 4 kHz, link at 1 kHz: every button state that holds across
+// a send gets out, the states in between coalesce
+void test_coalescing_a_fast_producer_onto_a_slow_link() {
+    ReportFilter filter(64);
+    Coalescer co;
+    uint32_t version = 0, sent = 0, edges = 0, edgesSent = 0;
+    uint32_t lastButtons = 0;
+    for (uint32_t t = 0; t < 40000; t++) {                  // 10 s in 250 us steps
+        const GamepadState latest = state((t / 400) & 1, static_cast<int16_t>(20000 * sinf(t * 0.001f)));
+        edges += t && latest.buttons != ((t - 1) / 400 & 1);
+        version++;
+        if (t % 4 != 3) { continue; }
+        if (!filter.changed(latest)) { co.skip(version); continue; }
+        co.take(version);
+        edgesSent += latest.buttons != lastButtons;
+        lastButtons = latest.buttons;
+        filter.sent(latest);
+        sent++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(edges, edgesSent);
+    TEST_ASSERT_GREATER_THAN_UINT32(1000, sent);
+    TEST_ASSERT_LESS_THAN_UINT32(10000, sent);              // Some slots had nothing new
+    TEST_ASSERT_EQUAL_UINT32(3 * (sent - 1), co.superseded());
+}
+
+void test_hid_report_layout() {
+    GamepadHID hid;
+    uint8_t desc[128];
+    const uint16_t len = hid._onGetDescriptor(desc);
+    TEST_ASSERT_TRUE(hidReportMatches(desc, len, GAMEPAD_REPORT_ID, 4 + 2 * GAMEPAD_AXES));
+
+    TEST_ASSERT_TRUE(hid.send(state(0x80000001u, -32767, 1, 32767)));
+    TEST_ASSERT_EQUAL_size_t(1, native::hidReports.size());
+    const native::HidReport& r = native::hidReports[0];
+    TEST_ASSERT_EQUAL_UINT8(GAMEPAD_REPORT_ID, r.id);
+    const uint8_t expect[] = {0x01, 0x00, 0x00, 0x80, 0x01, 0x80, 0x01, 0x00, 0xFF, 0x7F};
+    TEST_ASSERT_EQUAL_size_t(sizeof(expect), r.data.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, r.data.data(), sizeof(expect));
+
+    native::hidReady = false;
+    TEST_ASSERT_FALSE(hid.send(state(0)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_filter_reports_first_state_and_button_edges);
+    RUN_TEST(test_filter_thresholds_axes_against_the_last_sent_state);
+    RUN_TEST(test_filter_thresholds_per_axis);
+    RUN_TEST(test_coalescer_counts_superseded_states);
+    RUN_TEST(test_coalescing_a_fast_producer_onto_a_slow_link);
+    RUN_TEST(test_hid_report_layout);
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "SampleBatch.hpp"
+
+static constexpr float MAX_TILT = 12.5f;
+
+// Cabinet rocking through +-20 deg, as a FIFO burst would bring it
+template<size_t Size>
+static void rocking(Vec3f (&input)[Size]) {
+    for (size_t i = 0; i < Size; i++) {
+        const float a = 0.35f * sinf(i * 0.2f);
+        input[i] = Vec3f(9.81f * sinf(a), 9.81f * sinf(0.5f * a), 9.81f * cosf(a));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+/****************************************************************************/
+void test_fast_atan2_matches_libm_in_every_quadrant() {
+    float worst = 0.f;
+    for (int i = -50; i <= 50; i++) {
+        for (int j = -50; j <= 50; j++) {
+            const float y = i * 0.37f, x = j * 0.41f;
+            if (i == 0 && j == 0) { continue; }
+            worst = max(worst, fabsf(fastAtan2(y, x) - atan2f(y, x)));
+        }
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(3e-6f, worst);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, HALF_PI, fastAtan2(1.f, 0.f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, PI, fastAtan2(0.f, -1.f));
+}
+
+void test_push_get_and_capacity() {
+    SampleBatch<float, 3, 4> batch;
+    TEST_ASSERT_EQUAL_size_t(4, batch.capacity());
+    TEST_ASSERT_EQUAL_size_t(3, batch.dimension());
+    for (uint8_t k = 0; k < 4; k++) { TEST_ASSERT_TRUE(batch.push(Vec3f(k, 10.f + k, 20.f + k))); }
+    TEST_ASSERT_TRUE(batch.full());
+    TEST_ASSERT_FALSE(batch.push(Vec3f()));
+    TEST_ASSERT_EQUAL_FLOAT(12.f, batch.get(2)[1]);
+    TEST_ASSERT_EQUAL_FLOAT(23.f, batch.lane(2)[3]);
+
+    batch.resize(99);                                   // Clamped to capacity
+    TEST_ASSERT_EQUAL_size_t(4, batch.size());
+    batch.clear();
+    TEST_ASSERT_EQUAL_size_t(0, batch.size());
+}
+
+// Kernels on integer lanes, which skip esp-dsp
+void test_integer_kernels() {
+    SampleBatch<int16_t, 2, 8> batch;
+    for (int16_t k = 0; k < 5; k++) { batch.push(Vector<int16_t, 2>(k * 100, -k * 100)); }
+    batch.subtract(Vector<int16_t, 2>(50, -50));
+    batch.scale(3);
+    batch.clip(-600, 600);
+    const int16_t x[] = {-150, 150, 450, 600, 600};
+    const int16_t y[] = {150, -150, -450, -600, -600};
+    TEST_ASSERT_EQUAL_INT16_ARRAY(x, batch.lane(0), 5);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(y, batch.lane(1), 5);
+}
+
+void test_batch_tilt_projection_matches_the_scalar_one() {
+    Vec3f input[32];
+    rocking(input);
+    SampleBatch<float, 3, 32> raw;
+    SampleBatch<float, 2, 32> tilt;
+    for (const Vec3f& v : input) { raw.push(v); }
+    tiltProjection(raw, tilt);
+    TEST_ASSERT_EQUAL_size_t(32, tilt.size());
+    for (size_t i = 0; i < 32; i++) {
+        const Vec2f expected = tiltProjection(input[i]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[0], tilt.get(i)[0]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, expected[1], tilt.get(i)[1]);
+    }
+}
+
+// The whole shaping chain in one batch gives what Joystick's per-sample
+// path gives (offset, scale, projection, zero, clip, cubic response)
+void test_batch_chain_matches_the_per_sample_chain() {
+    const Vec3f offset(0.12f, -0.08f, 0.21f);
+    const Vec2f zero(0.4f, -0.3f);
+    Vec3f input[32];
+    rocking(input);
+
+    SampleBatch<float, 3, 32> raw;
+    SampleBatch<float, 2, 32> tilt;
+    for (const Vec3f& v : input) { raw.push(v); }
+    raw.subtract(offset);
+    raw.scale(1.02f);
+    tiltProjection(raw, tilt);
+    tilt.subtract(zero);
+    tilt.clip(-MAX_TILT, MAX_TILT);
+    tilt.scale(1.f / MAX_TILT);
+    tilt.cube();
+
+    uint8_t clipped = 0;
+    for (size_t i = 0; i < 32; i++) {
+        Vec2f t = tiltProjection((input[i] - offset) * 1.02f) - zero;
+        clipped += fabsf(t[0]) > MAX_TILT;
+        t[0] = constrain(t[0], -MAX_TILT, MAX_TILT);
+        t[1] = constrain(t[1], -MAX_TILT, MAX_TILT);
+        t /= MAX_TILT;
+        for (size_t k = 0; k < 2; k++) { t[k] = t[k] * t[k] * t[k]; }
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, t[0], tilt.get(i)[0]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, t[1], tilt.get(i)[1]);
+        TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.f, fabsf(tilt.get(i)[0]));
+    }
+    TEST_ASSERT_GREATER_THAN(0, clipped);              // The clip was exercised
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fast_atan2_matches_libm_in_every_quadrant);
+    RUN_TEST(test_push_get_and_capacity);
+    RUN_TEST(test_integer_kernels);
+    RUN_TEST(test_batch_tilt_projection_matches_the_scalar_one);
+    RUN_TEST(test_batch_chain_matches_the_per_sample_chain);
+    return UNITY_END();
+}
@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <thread>
+#include <atomic>
+#include "Seqlock.hpp"
+#include "GamepadState.hpp"
+#include "ButtonManager.hpp"
+#include "ArcadeButton.hpp"
+
+// Every field derived from one counter, so any mix of two writes shows
+static GamepadState stamped(uint32_t n) {
+    GamepadState s;
+    s.buttons = n;
+    s.sampled = ~n;
+    s.axis[AXIS_X] = static_cast<int16_t>(n);
+    s.axis[AXIS_Y] = static_cast<int16_t>(n >> 16);
+    s.axis[AXIS_Z] = static_cast<int16_t>(n * 7);
+    return s;
+}
+
+static bool whole(const GamepadState& s) {
+    const GamepadState e = stamped(s.buttons);
+    return s.sampled == e.sampled && s.axis[AXIS_X] == e.axis[AXIS_X] &&
+           s.axis[AXIS_Y] == e.axis[AXIS_Y] && s.axis[AXIS_Z] == e.axis[AXIS_Z];
+}
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+/****************************************************************************/
+// One writer, one reader on another thread, flat out: the reader never
+// sees a torn state, and never one older than the last it saw
+void test_two_threads_never_see_a_torn_state() {
+    Seqlock<GamepadState> lock;
+    lock.write(stamped(0));
+    std::atomic<bool> done{false};
+    uint32_t torn = 0, backwards = 0, reads = 0, tries = 0, misses = 0;
+
+    std::thread reader([&] {
+        uint32_t last = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            const GamepadState s = lock.read();
+            torn += !whole(s);
+            backwards += s.buttons < last;
+            last = s.buttons;
+            reads++;
+            GamepadState t;
+            tries++;
+            if (lock.tryRead(t)) { torn += !whole(t); } else { misses++; }
+        }
+    });
+    for (uint32_t n = 1; n <= 2000000; n++) { lock.write(stamped(n)); }
+    done = true;
+    reader.join();
+
+    TEST_PRINTF("%u reads, %u retries, %u/%u tryRead misses\n", reads, lock.retries(), misses, tries);
+    TEST_ASSERT_EQUAL_UINT32(0, torn);
+    TEST_ASSERT_EQUAL_UINT32(0, backwards);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, reads);
+    TEST_ASSERT_EQUAL_UINT32(2 * 2000001u, lock.version());
+    TEST_ASSERT_TRUE(whole(lock.read()));
+}
+
+// The manager debounces every switch, including an ArcadeButton's; the
+// button's own update() (output core) only runs the callbacks
+static int presses = 0, releases = 0;
+static char order[8];
+static uint8_t orderLen = 0;
+
+void test_manager_debounces_button_switches_for_their_owner() {
+    presses = releases = orderLen = 0;
+    ArcadeButton arcade(4, 5, 6, 7, 50);
+    arcade.onPress([] { presses++; order[orderLen++] = 'p'; });
+    arcade.onRelease([] { releases++; order[orderLen++] = 'r'; });
+    ButtonManager<> buttons;
+    TEST_ASSERT_TRUE(buttons.add(arcade.getSwitch(), BTN_FIRE, false));
+
+    native::pinLevel[4] = LOW;                              // Pressed, held
+    for (uint8_t k = 0; k < 100; k++) {
+        arcade.update();                                    // Owner alone never debounces...
+        native::advanceUs(1000);
+    }
+    TEST_ASSERT_FALSE(arcade.isPressed());
+    TEST_ASSERT_EQUAL_UINT32(0, buttons.getState());
+
+    for (uint8_t k = 0; k < 100; k++) {                     // ...the manager does
+        buttons.update();
+        native::advanceUs(1000);
+    }
+    TEST_ASSERT_TRUE(arcade.isPressed());
+    TEST_ASSERT_EQUAL_UINT32(1u << BTN_FIRE, buttons.getState());
+    TEST_ASSERT_EQUAL_INT(0, presses);                      // Callbacks wait for the owner
+
+    native::pinLevel[4] = HIGH;                             // Released before the owner looks
+    for (uint8_t k = 0; k < 100; k++) {
+        buttons.update();
+        native::advanceUs(1000);
+    }
+    arcade.update();
+    TEST_ASSERT_EQUAL_INT(1, presses);
+    TEST_ASSERT_EQUAL_INT(1, releases);
+    TEST_ASSERT_EQUAL_MEMORY("pr", order, 2);               // In the order they happened
+    arcade.update();
+    TEST_ASSERT_EQUAL_INT(1, presses);
+}
+
+// Bouncing contacts settle into one edge
+void test_bounces_inside_the_debounce_time_are_one_press() {
+    presses = releases = 0;
+    CallbackSwitch sw(9, 20);
+    sw.onPress([] { presses++; });
+    ButtonManager<> buttons;
+    buttons.add(sw, 0);
+    native::pinLevel[9] = HIGH;
+    buttons.update();
+    for (uint8_t k = 0; k < 10; k++) {                      // 10 ms of chatter
+        native::pinLevel[9] = k & 1 ? HIGH : LOW;
+        native::advanceUs(1000);
+        buttons.update();
+    }
+    native::pinLevel[9] = LOW;
+    for (uint8_t k = 0; k < 40; k++) {
+        native::advanceUs(1000);
+        buttons.update();
+    }
+    TEST_ASSERT_EQUAL_INT(1, presses);                      // Bare switch: run by the manager
+    TEST_ASSERT_EQUAL_UINT32(1, buttons.getState());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_two_threads_never_see_a_torn_state);
+    RUN_TEST(test_manager_debounces_button_switches_for_their_owner);
+    RUN_TEST(test_bounces_inside_the_debounce_time_are_one_press);
+    return UNITY_END();
+}
@@ -0,0 +1,164 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "ShakerMotor.hpp"
+
+static constexpr uint8_t IN1 = 10, IN2 = 11;
+static constexpr uint32_t FULL = (1u << SHAKER_PWM_BITS) - 1;
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+static const native::LedcChannel& pwm(uint8_t pin) {
+    for (const native::LedcChannel& c : native::ledc) {
+        if (c.pin == pin) { return c; }
+    }
+    TEST_FAIL_MESSAGE("pin not attached");
+    return native::ledc[0];
+}
+
+/****************************************************************************/
+void test_slew_ramp_steps_at_rate_and_reverses_through_zero() {
+    SlewRamp ramp;
+    ramp.rate = 100;
+    ramp.target = 350;
+    TEST_ASSERT_EQUAL_INT16(100, ramp.step());
+    TEST_ASSERT_EQUAL_INT16(200, ramp.step());
+    TEST_ASSERT_EQUAL_INT16(300, ramp.step());
+    TEST_ASSERT_EQUAL_INT16(350, ramp.step());
+    TEST_ASSERT_TRUE(ramp.settled());
+
+    ramp.target = -150;
+    const int16_t expect[] = {250, 150, 50, -50, -150, -150};
+    for (int16_t e : expect) { TEST_ASSERT_EQUAL_INT16(e, ramp.step()); }
+
+    ramp.rate = 0;                                          // Jump
+    ramp.target = 4095;
+    TEST_ASSERT_EQUAL_INT16(4095, ramp.step());
+}
+
+void test_forward_ramps_one_step_per_tick() {
+    ShakerMotor motor(IN1, IN2, 400);
+    TEST_ASSERT_TRUE(motor.begin());
+    TEST_ASSERT_EQUAL_UINT32(SHAKER_PWM_FREQ, pwm(IN1).freq);
+    TEST_ASSERT_EQUAL_UINT8(SHAKER_PWM_BITS, pwm(IN1).bits);
+
+    motor.setIntensity(4095);
+    TEST_ASSERT_EQUAL_UINT32(0, pwm(IN1).duty);             // Nothing until the tick
+    for (uint32_t k = 1; k <= 12; k++) {
+        native::advanceUs(SHAKER_TICK_US);
+        const uint32_t level = min<uint32_t>(400 * k, 4095);
+        TEST_ASSERT_EQUAL_UINT32(level >> (12 - SHAKER_PWM_BITS), pwm(IN1).duty);
+        TEST_ASSERT_EQUAL_UINT32(0, pwm(IN2).duty);
+    }
+    TEST_ASSERT_EQUAL_INT16(4095, motor.getIntensity());
+    motor.end();
+}
+
+// Fast decay: only one input is ever driven, so a reversal ramps IN1 down
+// to zero before IN2 comes up
+void test_reversal_never_drives_both_inputs() {
+    ShakerMotor motor(IN1, IN2, 400);
+    motor.begin();
+    motor.setIntensity(4000);
+    native::advanceUs(20 * SHAKER_TICK_US);
+    motor.setIntensity(-4000);
+    bool crossed = false;
+    uint32_t last1 = pwm(IN1).duty;
+    for (uint32_t k = 0; k < 30; k++) {
+        native::advanceUs(SHAKER_TICK_US);
+        const uint32_t in1 = pwm(IN1).duty, in2 = pwm(IN2).duty;
+        TEST_ASSERT_FALSE(in1 && in2);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(last1, in1);
+        crossed |= in1 == 0 && in2 == 0;
+        last1 = in1;
+    }
+    TEST_ASSERT_TRUE(crossed);
+    TEST_ASSERT_EQUAL_UINT32(4000 >> (12 - SHAKER_PWM_BITS), pwm(IN2).duty);
+    motor.end();
+}
+
+// Slow decay: the idle input is held high and the other gets the inverse
+void test_slow_decay_inverts_the_driven_input() {
+    ShakerMotor motor(IN1, IN2, 4095, ShakerMotor::Decay::SLOW);
+    motor.begin();
+    motor.setIntensity(2048);
+    native::advanceUs(SHAKER_TICK_US);
+    TEST_ASSERT_EQUAL_UINT32(FULL, pwm(IN1).duty);
+    TEST_ASSERT_EQUAL_UINT32(FULL - (2048 >> 2), pwm(IN2).duty);
+    motor.setIntensity(-2048);
+    native::advanceUs(2 * SHAKER_TICK_US);                  // 4096 counts is two steps
+    TEST_ASSERT_EQUAL_UINT32(FULL - (2048 >> 2), pwm(IN1).duty);
+    TEST_ASSERT_EQUAL_UINT32(FULL, pwm(IN2).duty);
+    motor.end();
+}
+
+void test_brake_and_coast_skip_the_ramp() {
+    ShakerMotor motor(IN1, IN2, 100);
+    motor.begin();
+    motor.setIntensity(4095);
+    native::advanceUs(50 * SHAKER_TICK_US);
+    motor.brake();
+    native::advanceUs(SHAKER_TICK_US);
+    TEST_ASSERT_TRUE(motor.braking());
+    TEST_ASSERT_EQUAL_UINT32(FULL, pwm(IN1).duty);
+    TEST_ASSERT_EQUAL_UINT32(FULL, pwm(IN2).duty);
+    TEST_ASSERT_EQUAL_INT16(0, motor.getIntensity());
+    motor.coast();
+    native::advanceUs(SHAKER_TICK_US);
+    TEST_ASSERT_EQUAL_UINT32(0, pwm(IN1).duty);
+    TEST_ASSERT_EQUAL_UINT32(0, pwm(IN2).duty);
+    motor.end();
+}
+
+// Commands stream in faster than the tick: the motor follows the latest,
+// and the bridge is only written when the output moves
+void test_streamed_commands_take_the_latest() {
+    ShakerMotor motor(IN1, IN2, 4095);
+    motor.begin();
+    for (int16_t level = 100; level <= 1000; level += 100) { motor.setIntensity(level); }
+    native::advanceUs(SHAKER_TICK_US);
+    TEST_ASSERT_EQUAL_INT16(1000, motor.getIntensity());
+    TEST_ASSERT_EQUAL_UINT32(10, motor.commands());
+    const uint32_t writes = pwm(IN1).writes;
+    native::advanceUs(100 * SHAKER_TICK_US);
+    TEST_ASSERT_EQUAL_UINT32(writes, pwm(IN1).writes);
+    motor.setIntensity(9999);                               // Clamped
+    TEST_ASSERT_EQUAL_INT16(4095, motor.getTarget());
+    motor.end();
+}
+
+void test_begin_without_channels_fails_and_end_releases() {
+    const uint8_t spare = LedcAllocator::freeChannels();
+    for (uint8_t k = 0; k + 1 < spare; k++) { LedcAllocator::claim(1000, 8); }
+    ShakerMotor starved(IN1, IN2);
+    TEST_ASSERT_FALSE(starved.begin());
+    TEST_ASSERT_EQUAL_UINT8(1, LedcAllocator::freeChannels());
+    TEST_ASSERT_FALSE(starved.attached());
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+
+    ShakerMotor motor(IN1, IN2);
+    TEST_ASSERT_TRUE(motor.begin());
+    TEST_ASSERT_EQUAL_UINT8(spare - 2, LedcAllocator::freeChannels());
+    TEST_ASSERT_EQUAL_UINT8(1, native::armedTimers());
+    motor.end();
+    TEST_ASSERT_EQUAL_UINT8(spare, LedcAllocator::freeChannels());
+    TEST_ASSERT_EQUAL_UINT8(0, native::armedTimers());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_slew_ramp_steps_at_rate_and_reverses_through_zero);
+    RUN_TEST(test_forward_ramps_one_step_per_tick);
+    RUN_TEST(test_reversal_never_drives_both_inputs);
+    RUN_TEST(test_slow_decay_inverts_the_driven_input);
+    RUN_TEST(test_brake_and_coast_skip_the_ramp);
+    RUN_TEST(test_streamed_commands_take_the_latest);
+    RUN_TEST(test_begin_without_channels_fails_and_end_releases);
+    return UNITY_END();
+}
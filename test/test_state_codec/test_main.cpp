@@ -0,0 +1,144 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "StateCodec.hpp"
+
+static GamepadState state(uint32_t buttons, uint32_t sampled, int16_t x, int16_t y, int16_t z,
+                          int16_t nx = 0, int16_t ny = 0) {
+    GamepadState s;
+    s.buttons = buttons;
+    s.sampled = sampled;
+    s.axis[AXIS_X] = x;
+    s.axis[AXIS_Y] = y;
+    s.axis[AXIS_Z] = z;
+    s.nudge[0] = nx;
+    s.nudge[1] = ny;
+    return s;
+}
+
+static void assertStatesEqual(const GamepadState& expected, const GamepadState& actual) {
+    TEST_ASSERT_EQUAL_HEX32(expected.buttons, actual.buttons);
+    TEST_ASSERT_EQUAL_UINT32(expected.sampled, actual.sampled);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected.axis, actual.axis, GAMEPAD_AXES);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected.nudge, actual.nudge, 2);
+}
+
+// Tilt wandering, nudges, plunger pulls and button chords at 1 ms
+static GamepadState step(GamepadState s, uint32_t& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    if ((seed >> 24) < 4) { s.buttons ^= 1u << ((seed >> 8) & 31); }
+    if ((seed >> 20) & 1) { s.axis[AXIS_X] += static_cast<int16_t>((seed >> 4) & 0x3F) - 32; }
+    if ((seed >> 21) & 1) { s.axis[AXIS_Y] += static_cast<int16_t>((seed >> 10) & 0x3F) - 32; }
+    if ((seed >> 24) < 16) { s.axis[AXIS_Z] = static_cast<int16_t>(seed & 0x7FFF); }
+    if ((seed >> 22) & 1) { s.nudge[0] = static_cast<int16_t>(seed >> 3); }
+    if ((seed >> 23) & 1) { s.nudge[1] = static_cast<int16_t>(seed >> 7); }
+    s.sampled += 1000;
+    return s;
+}
+
+void setUp() {}
+void tearDown() {}
+
+/****************************************************************************/
+void test_pack_is_little_endian_in_field_order() {
+    const GamepadState s = state(0x04030201u, 0x08070605u, 0x0A09, 0x0C0B, -2, 0x100F, -32767);
+    uint8_t packed[STATE_BYTES];
+    packState(s, packed);
+    const uint8_t expected[STATE_BYTES] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0xFE, 0xFF, 0x0F, 0x10, 0x01, 0x80};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, packed, STATE_BYTES);
+
+    GamepadState back;
+    unpackState(packed, back);
+    assertStatesEqual(s, back);
+}
+
+void test_first_record_is_a_keyframe_then_only_changes() {
+    DeltaEncoder encoder;
+    uint8_t record[DELTA_MAX];
+    const GamepadState s = state(0, 0, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(DELTA_MAX, encoder.encode(s, record));      // Even all zero
+    TEST_ASSERT_EQUAL_HEX8(FIELDS_ALL, record[0]);
+    TEST_ASSERT_EQUAL_UINT8(0, encoder.encode(s, record));              // Nothing changed
+
+    GamepadState moved = s;
+    moved.axis[AXIS_Y] = 300;
+    TEST_ASSERT_EQUAL_UINT8(1 + sizeof(int16_t), encoder.encode(moved, record));
+    TEST_ASSERT_EQUAL_HEX8(1u << FIELD_Y, record[0]);
+    TEST_ASSERT_EQUAL_INT16(300, static_cast<int16_t>(record[1] | (record[2] << 8)));
+
+    encoder.reset();
+    TEST_ASSERT_EQUAL_UINT8(DELTA_MAX, encoder.encode(moved, record));
+}
+
+void test_untracked_fields_never_go_out() {
+    DeltaEncoder encoder(FIELDS_ALL & ~(1u << FIELD_SAMPLED));
+    uint8_t record[DELTA_MAX];
+    GamepadState s = state(1, 1000, 10, 20, 30);
+    TEST_ASSERT_EQUAL_UINT8(DELTA_MAX - sizeof(uint32_t), encoder.encode(s, record));
+    TEST_ASSERT_FALSE(record[0] & (1u << FIELD_SAMPLED));
+    s.sampled += 1000;                                                  // Timestamp only
+    TEST_ASSERT_EQUAL_UINT8(0, encoder.encode(s, record));
+}
+
+// A long session through a byte stream of back-to-back records decodes to
+// every source state
+void test_session_round_trips_through_a_record_stream() {
+    DeltaEncoder encoder;
+    GamepadState s;
+    uint32_t seed = 12345;
+    std::vector<GamepadState> states;
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> lengths;
+    for (uint32_t n = 0; n < 10000; n++) {
+        s = step(s, seed);
+        if (n == 5000) { encoder.reset(); }                            // A keyframe mid-stream
+        uint8_t record[DELTA_MAX];
+        const uint8_t len = encoder.encode(s, record);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, len);                        // sampled always moves
+        stream.insert(stream.end(), record, record + len);
+        states.push_back(s);
+        lengths.push_back(len);
+    }
+    TEST_ASSERT_LESS_THAN(STATE_BYTES * states.size(), stream.size());
+
+    DeltaDecoder decoder;
+    size_t pos = 0;
+    for (size_t k = 0; k < states.size(); k++) {
+        GamepadState out;
+        const uint8_t used = decoder.decode(stream.data() + pos, stream.size() - pos, out);
+        TEST_ASSERT_EQUAL_UINT8(lengths[k], used);
+        assertStatesEqual(states[k], out);
+        pos += used;
+    }
+    TEST_ASSERT_EQUAL_size_t(stream.size(), pos);
+
+    // Joining at the keyframe needs nothing from before it
+    DeltaDecoder late;
+    size_t at = 0;
+    for (size_t k = 0; k < 5000; k++) { at += lengths[k]; }
+    GamepadState out;
+    TEST_ASSERT_EQUAL_UINT8(DELTA_MAX, late.decode(stream.data() + at, stream.size() - at, out));
+    assertStatesEqual(states[5000], out);
+}
+
+void test_decoder_rejects_malformed_records() {
+    DeltaDecoder decoder;
+    GamepadState out = state(7, 7, 7, 7, 7);
+    const uint8_t badMask[] = {0x80, 0, 0};
+    TEST_ASSERT_EQUAL_UINT8(0, decoder.decode(badMask, sizeof(badMask), out));
+    const uint8_t truncated[] = {1u << FIELD_BUTTONS, 1, 2, 3};         // Needs 4 bytes of buttons
+    TEST_ASSERT_EQUAL_UINT8(0, decoder.decode(truncated, sizeof(truncated), out));
+    TEST_ASSERT_EQUAL_UINT8(0, decoder.decode(truncated, 0, out));
+    assertStatesEqual(state(7, 7, 7, 7, 7), out);                       // Left alone
+    assertStatesEqual(GamepadState(), decoder.state());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pack_is_little_endian_in_field_order);
+    RUN_TEST(test_first_record_is_a_keyframe_then_only_changes);
+    RUN_TEST(test_untracked_fields_never_go_out);
+    RUN_TEST(test_session_round_trips_through_a_record_stream);
+    RUN_TEST(test_decoder_rejects_malformed_records);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+#include <Arduino.h>
+#include <unity.h>
+#include "LedStrip.hpp"
+#include "Compositor.hpp"
+#include "Effects.hpp"
+
+void setUp() { native::resetClock(); native::resetRmt(); }
+void tearDown() {}
+
+static uint16_t high(uint32_t item) { return item & 0x7FFF; }
+static uint16_t low(uint32_t item) { return (item >> 16) & 0x7FFF; }
+
+/****************************************************************************/
+void test_bit_timings_are_within_ws2812_tolerance() {
+    using namespace StripTiming;
+    // Datasheet windows are +-150 ns around the nominal
+    TEST_ASSERT_UINT16_WITHIN(150, 400, T0H * NS_PER_TICK);
+    TEST_ASSERT_UINT16_WITHIN(150, 850, T0L * NS_PER_TICK);
+    TEST_ASSERT_UINT16_WITHIN(150, 800, T1H * NS_PER_TICK);
+    TEST_ASSERT_UINT16_WITHIN(150, 450, T1L * NS_PER_TICK);
+    TEST_ASSERT_EQUAL_UINT16(1250, BIT_NS);
+}
+
+void test_item_layout_matches_rmt_item32() {
+    const uint32_t it = StripTiming::item(16, 34);
+    TEST_ASSERT_EQUAL_UINT16(16, high(it));
+    TEST_ASSERT_EQUAL_UINT32(1u << 15, it & (1u << 15));   // level0 high
+    TEST_ASSERT_EQUAL_UINT16(34, low(it));
+    TEST_ASSERT_EQUAL_UINT32(0, it & (1u << 31));           // level1 low
+}
+
+void test_encode_is_msb_first() {
+    const uint8_t bytes[] = {0xA5, 0x01};
+    uint32_t items[16];
+    TEST_ASSERT_EQUAL_size_t(16, StripTiming::encode(bytes, 2, items));
+    const uint8_t bits[] = {1, 0, 1, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1};
+    for (uint8_t k = 0; k < 16; k++) {
+        TEST_ASSERT_EQUAL_HEX32(bits[k] ? StripTiming::BIT1 : StripTiming::BIT0, items[k]);
+    }
+    StripTiming::terminate(items, 16);
+    TEST_ASSERT_EQUAL_UINT16(StripTiming::T1H, high(items[15]));
+    TEST_ASSERT_EQUAL_UINT16(StripTiming::RESET_TICKS, low(items[15]));
+}
+
+/****************************************************************************/
+void test_strip_sends_grb_and_waits_for_the_wire() {
+    LedStrip<2> strip(5, 1);
+    TEST_ASSERT_TRUE(strip.begin());
+    TEST_ASSERT_EQUAL_UINT8(StripTiming::CLK_DIV, native::rmt[1].config.clk_div);
+    const RGB12 frame[2] = {{0xFFF, 0x000, 0x800}, {0x010, 0x020, 0x030}};
+    TEST_ASSERT_TRUE(strip.show(frame));
+    TEST_ASSERT_EQUAL_size_t(strip.ITEMS, native::rmt[1].items.size());
+
+    uint8_t bytes[6] = {};
+    for (size_t k = 0; k < 48; k++) {
+        if (high(native::rmt[1].items[k]) == StripTiming::T1H) { bytes[k / 8] |= 0x80 >> (k % 8); }
+    }
+    const uint8_t expect[6] = {0x00, 0xFF, 0x80, 0x02, 0x01, 0x03};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, bytes, 6);
+
+    TEST_ASSERT_TRUE(strip.busy());
+    TEST_ASSERT_FALSE(strip.show(frame));                   // Never blocks, never tears
+    native::rmtDone(1);
+    TEST_ASSERT_TRUE(strip.show(frame));
+    TEST_ASSERT_EQUAL_UINT32(2, native::rmt[1].frames);
+}
+
+void test_grbw_moves_the_common_part_to_white() {
+    LedStrip<1, StripType::SK6812_GRBW> strip(5, 2);
+    TEST_ASSERT_TRUE(strip.begin());
+    const RGB12 frame[1] = {{0x400, 0x600, 0x300}};
+    TEST_ASSERT_TRUE(strip.show(frame));
+    uint8_t bytes[4] = {};
+    for (size_t k = 0; k < 32; k++) {
+        if (high(native::rmt[2].items[k]) == StripTiming::T1H) { bytes[k / 8] |= 0x80 >> (k % 8); }
+    }
+    const uint8_t expect[4] = {0x30, 0x10, 0x00, 0x30};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expect, bytes, 4);
+}
+
+void test_transmit_time_of_a_hundred_leds() {
+    // 2400 bits at 1.25 us plus the latch
+    TEST_ASSERT_EQUAL_UINT32(3000 + StripTiming::RESET_US, (LedStrip<100>::transmitMicros()));
+}
+
+/****************************************************************************/
+void test_flash_overlays_and_decays() {
+    Compositor<4> comp;
+    comp.flash(RGB{255, 0, 0}, 100, 0, 1, 2);
+    comp.render(0);
+    TEST_ASSERT_EQUAL_UINT16(0, comp.frame()[0].r);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, comp.frame()[1].r);
+    TEST_ASSERT_EQUAL_UINT16(LEVEL_MAX, comp.frame()[2].r);
+    comp.render(50);
+    TEST_ASSERT_UINT16_WITHIN(20, LEVEL_MAX / 2, comp.frame()[1].r);
+    comp.render(100);
+    TEST_ASSERT_EQUAL_UINT16(0, comp.frame()[1].r);
+}
+
+void test_current_limit_caps_the_summed_draw() {
+    Compositor<10> comp;
+    comp.base().playRange(0, 10, Effects::SOLID_RED, 0);
+    comp.setCurrentLimit(100);                              // 5 channels' worth at 20 mA
+    comp.render(0);
+    uint32_t load = 0;
+    for (size_t k = 0; k < 10; k++) { load += comp.frame()[k].r; }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(5u * LEVEL_MAX, load);
+    TEST_ASSERT_UINT32_WITHIN(LEVEL_MAX / 10, 5u * LEVEL_MAX, load);
+    TEST_ASSERT_EQUAL_UINT32(10u * LEVEL_MAX, comp.demand());
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bit_timings_are_within_ws2812_tolerance);
+    RUN_TEST(test_item_layout_matches_rmt_item32);
+    RUN_TEST(test_encode_is_msb_first);
+    RUN_TEST(test_strip_sends_grb_and_waits_for_the_wire);
+    RUN_TEST(test_grbw_moves_the_common_part_to_white);
+    RUN_TEST(test_transmit_time_of_a_hundred_leds);
+    RUN_TEST(test_flash_overlays_and_decays);
+    RUN_TEST(test_current_limit_caps_the_summed_draw);
+    return UNITY_END();
+}
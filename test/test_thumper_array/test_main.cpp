@@ -0,0 +1,181 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include "ThumperArray.hpp"
+
+static constexpr PulseProfile PROFILE = {20000, 4095, 1200, 300000};
+
+void setUp() {
+    native::resetClock(1000);
+    native::resetTimers();
+    native::resetLedc();
+    for (uint8_t ch = 0; ch < LedcAllocator::CHANNELS; ch++) { LedcAllocator::release(ch); }
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_refire_in_hold_keeps_the_max_on_deadline() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0);
+    native::advanceUs(200000);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.holdDuty, coil.getDuty());
+    TEST_ASSERT_TRUE(sched.fire(0));                        // Kicks again...
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty());
+    native::advanceUs(PROFILE.maxOnUs - 200000);            // ...but is off by the first deadline
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    TEST_ASSERT_FALSE(sched.isActive(0));
+
+    sched.fire(0);                                          // Off again: a fresh deadline
+    native::advanceUs(PROFILE.maxOnUs - 1);
+    TEST_ASSERT_NOT_EQUAL(0, coil.getDuty());
+}
+
+void test_refire_past_the_deadline_releases() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PulseProfile{20000, 4095, 1200, 100000});
+    sched.fire(0);
+    native::advanceUs(99999);
+    sched.fire(0);                                          // Queued, timer not run yet
+    native::resetClock(native::clockUs + 5);                // Deadline slips by before it runs
+    TEST_ASSERT_FALSE(sched.fire(0));
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+void test_delayed_refire_drops_the_coil_until_its_kick() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    sched.fire(0);
+    native::advanceUs(100000);
+    sched.fire(0, 50000, 20000);
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());            // Not left at hold through the delay
+    native::advanceUs(19999);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coil.getDuty());
+    native::advanceUs(50000);
+    TEST_ASSERT_EQUAL_UINT32(0, coil.getDuty());
+}
+
+/****************************************************************************/
+void test_thermal_model_throttles_then_refuses() {
+    Solenoid coil(1, 0);
+    coil.begin();
+    CoilScheduler sched;
+    sched.add(coil, PROFILE);
+    ThumperArray<1> array(sched);
+    array.add(0, ThermalModel{2.0f, 30.0f});
+    uint32_t fires = 0;
+    while (array.refusedHot() == 0 && fires < 1000) {
+        if (array.fire(0)) { fires++; }
+        native::advanceUs(PROFILE.maxOnUs + 1000);
+    }
+    TEST_ASSERT_GREATER_THAN(0, array.throttled());
+    TEST_ASSERT_GREATER_THAN(0, array.refusedHot());
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.0f + 1e-3f, array.heat(0));
+    native::advanceUs(60000000);                            // Two time constants
+    TEST_ASSERT_LESS_THAN_FLOAT(0.2f, array.heat(0));
+    TEST_ASSERT_TRUE(array.fire(0));
+}
+
+// A fire after more than 2^31 us idle kicks at once: the last start is
+// long past, not a stagger deadline half a wrap ahead
+void test_fire_after_a_long_idle_is_not_staggered() {
+    Solenoid coils[2] = {{1, 0}, {2, 1}};
+    CoilScheduler sched;
+    ThumperArray<2> array(sched, 2, 500, 30000);
+    for (uint8_t k = 0; k < 2; k++) {
+        coils[k].begin();
+        sched.add(coils[k], PROFILE);
+        array.add(k);
+    }
+    TEST_ASSERT_TRUE(array.fire(0, 50000));
+    native::advanceUs(100000);
+    TEST_ASSERT_EQUAL_UINT32(0, coils[0].getDuty());
+
+    native::advanceUs((1ull << 31) + 1000);
+    TEST_ASSERT_TRUE(array.fire(1, 50000));
+    native::advanceUs(0);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coils[1].getDuty());
+    TEST_ASSERT_EQUAL_UINT32(0, array.deferred());
+
+    TEST_ASSERT_TRUE(array.fire(0, 50000));                 // A recent start still staggers
+    TEST_ASSERT_EQUAL_UINT32(1, array.deferred());
+    native::advanceUs(499);
+    TEST_ASSERT_EQUAL_UINT32(0, coils[0].getDuty());
+    native::advanceUs(1);
+    TEST_ASSERT_EQUAL_UINT32(PROFILE.kickDuty, coils[0].getDuty());
+}
+
+// Random rapid fire on four thumpers for ten simulated minutes, sampled
+// every 100 us. The duties actually written must respect every limit:
+// concurrency, stagger, max on-time, and heat recomputed from the duty
+// trace rather than taken from the array's own bookkeeping.
+void test_long_rapid_fire_holds_every_limit() {
+    constexpr uint8_t N = 4;
+    constexpr uint32_t STEP_US = 100;
+    constexpr ThermalModel THERMAL = {2.0f, 30.0f};
+    Solenoid coils[N] = {{1, 0}, {2, 1}, {3, 2}, {4, 3}};
+    CoilScheduler sched;
+    ThumperArray<N> array(sched, 2, 500, 30000);
+    for (uint8_t k = 0; k < N; k++) {
+        coils[k].begin();
+        sched.add(coils[k], PROFILE);
+        array.add(k, THERMAL);
+    }
+
+    uint32_t seed = 1234;
+    auto rnd = [&](uint32_t n) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % n; };
+    float heat[N] = {};
+    uint32_t onSince[N] = {}, maxOn = 0, kicks = 0;
+    bool wasOn[N] = {};
+    uint8_t peak = 0;
+    float peakHeat = 0.f;
+    const float rate = THERMAL.heatRate * 1e-6f * STEP_US / 4095.f;
+    const float decay = expf(-(STEP_US * 1e-6f) / THERMAL.tauS);
+
+    for (uint32_t step = 0; step < 600u * 1000000 / STEP_US; step++) {
+        if (rnd(40) == 0) {                                 // About 250 requests per second
+            const uint8_t k = rnd(N);
+            if (rnd(8) == 0) { array.release(k); } else { array.fire(k, 5000 + rnd(400000)); }
+        }
+        native::advanceUs(STEP_US);
+        uint8_t on = 0;
+        for (uint8_t k = 0; k < N; k++) {
+            const uint32_t duty = coils[k].getDuty();
+            heat[k] = heat[k] * decay + rate * duty;
+            peakHeat = max(peakHeat, heat[k]);
+            if (duty && !wasOn[k]) { onSince[k] = micros(); kicks++; }
+            if (duty) { on++; maxOn = max<uint32_t>(maxOn, micros() - onSince[k]); }
+            wasOn[k] = duty != 0;
+        }
+        peak = max(peak, on);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, peak);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(PROFILE.maxOnUs + STEP_US, maxOn);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.02f, peakHeat);       // Sampling error only
+    TEST_ASSERT_GREATER_THAN(1000, kicks);
+    TEST_ASSERT_GREATER_THAN(0, array.throttled() + array.refusedHot());
+    TEST_ASSERT_GREATER_THAN(0, array.refusedBusy() + array.deferred());
+}
+
+/****************************************************************************/
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_refire_in_hold_keeps_the_max_on_deadline);
+    RUN_TEST(test_refire_past_the_deadline_releases);
+    RUN_TEST(test_delayed_refire_drops_the_coil_until_its_kick);
+    RUN_TEST(test_thermal_model_throttles_then_refuses);
+    RUN_TEST(test_fire_after_a_long_idle_is_not_staggered);
+    RUN_TEST(test_long_rapid_fire_holds_every_limit);
+    return UNITY_END();
+}
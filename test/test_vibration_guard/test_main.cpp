@@ -0,0 +1,155 @@
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "VibrationGuard.hpp"
+
+// Replay of an accelerometer trace with coil fires. Samples are taken every
+// GUARD_BIN_US but reach the guard up to a period later (FIFO, poll phase),
+// while fire events arrive as they happen; the guard has to line both up
+// by acquisition time.
+
+static constexpr uint8_t COIL = 3;
+static constexpr float NUDGE = 0.3f;                        // m/s^2 a player would feel
+static const Vec3f REST(0.f, 0.f, 9.81f);
+
+struct Sample { uint32_t sampledUs, processedUs; Vec3f raw; };
+struct Fire { uint32_t us; uint8_t coil; };
+struct Trace { std::vector<Sample> samples; std::vector<Fire> fires; };
+
+// Cabinet ring after a kick: 10 Hz sway on X, a thump on Z
+static Vec3f ring(uint32_t ageUs) {
+    const float t = ageUs * 1e-6f;
+    if (t >= 0.3f) { return Vec3f(); }
+    return Vec3f(3.f * expf(-t / 0.05f) * sinf(TWO_PI * 10.f * t), 0.f, 2.f * expf(-t / 0.04f));
+}
+
+static float noise() { return (std::rand() % 2001 - 1000) * 2e-5f; }
+
+// One fire every `spacingMs`, at a random phase to the sample clock
+static Trace record(uint16_t fires, uint32_t spacingMs, uint32_t startUs) {
+    Trace trace;
+    const uint32_t samples = fires * spacingMs * 1000 / GUARD_BIN_US;
+    for (uint16_t f = 0; f < fires; f++) {
+        trace.fires.push_back(Fire{startUs + f * spacingMs * 1000 + 20000 + std::rand() % GUARD_BIN_US, COIL});
+    }
+    for (uint32_t k = 0; k < samples; k++) {
+        const uint32_t t = startUs + k * GUARD_BIN_US;
+        Vec3f raw = REST + Vec3f(noise(), noise(), noise());
+        for (const Fire& f : trace.fires) {
+            if (static_cast<int32_t>(t - f.us) >= 0) { raw += ring(t - f.us); }
+        }
+        trace.samples.push_back(Sample{t, t + std::rand() % GUARD_BIN_US, raw});
+    }
+    return trace;
+}
+
+// False nudges: samples passed on (not held or blanked) still off rest
+static uint32_t replay(const Trace& trace, VibrationGuard* guard, CoilEventQueue& events,
+                       bool stampAtProcessing = false, uint32_t* suppressed = nullptr) {
+    uint32_t falseNudges = 0;
+    size_t next = 0;
+    for (const Sample& s : trace.samples) {
+        while (next < trace.fires.size() && static_cast<int32_t>(s.processedUs - trace.fires[next].us) >= 0) {
+            events.push(trace.fires[next].coil, trace.fires[next].us);
+            next++;
+        }
+        Vec3f coords = s.raw;
+        GuardMode out = GuardMode::NONE;
+        if (guard) { out = guard->process(coords, stampAtProcessing ? s.processedUs : s.sampledUs); }
+        if (out != GuardMode::NONE) {
+            if (suppressed) { (*suppressed)++; }
+            continue;
+        }
+        if ((coords - REST).magnitude() > NUDGE) { falseNudges++; }
+    }
+    return falseNudges;
+}
+
+static void learn(VibrationGuard& guard, CoilEventQueue& events, bool stampAtProcessing = false) {
+    guard.beginCapture(COIL);
+    guard.setBaseline(REST);
+    replay(record(16, 400, 1000000), &guard, events, stampAtProcessing);
+    TEST_ASSERT_TRUE(guard.endCapture());
+}
+
+void setUp() {
+    native::resetClock(1000);
+    std::srand(35);
+}
+void tearDown() {}
+
+/****************************************************************************/
+void test_subtract_replay_cuts_false_nudges() {
+    const Trace trace = record(50, 400, 20000000);
+    CoilEventQueue unguarded;
+    const uint32_t before = replay(trace, nullptr, unguarded);
+
+    CoilEventQueue events;
+    VibrationGuard guard(events);
+    guard.configure(COIL, GuardMode::SUBTRACT);
+    learn(guard, events);
+    const uint32_t after = replay(trace, &guard, events);
+
+    // The same guard, stamping samples when they are processed
+    CoilEventQueue lateEvents;
+    VibrationGuard late(lateEvents);
+    late.configure(COIL, GuardMode::SUBTRACT);
+    learn(late, lateEvents, true);
+    const uint32_t stale = replay(trace, &late, lateEvents, true);
+
+    TEST_PRINTF("false nudges: %u unguarded, %u subtracted, %u stamped at processing\n", before, after, stale);
+    TEST_ASSERT_GREATER_THAN_UINT32(200, before);
+    TEST_ASSERT_LESS_THAN_UINT32(before / 20, after);
+    TEST_ASSERT_LESS_THAN_UINT32(stale, after);
+}
+
+void test_hold_covers_exactly_the_window_after_each_fire() {
+    const Trace trace = record(50, 400, 20000000);
+    CoilEventQueue events;
+    VibrationGuard guard(events);
+    guard.configure(COIL, GuardMode::HOLD, 300000);
+    uint32_t held = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, replay(trace, &guard, events, false, &held));
+
+    uint32_t expected = 0;
+    for (const Sample& s : trace.samples) {
+        for (const Fire& f : trace.fires) { expected += s.sampledUs - f.us < 300000; }
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, held);
+}
+
+// A sample that sat in the FIFO while the coil fired is from before the
+// kick: neither corrected nor held
+void test_sample_taken_before_the_fire_is_untouched() {
+    CoilEventQueue events;
+    VibrationGuard guard(events);
+    guard.configure(COIL, GuardMode::HOLD);
+    events.push(COIL, 50000);
+    Vec3f coords = REST;
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(GuardMode::NONE), static_cast<int>(guard.process(coords, 45000)));
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(GuardMode::HOLD), static_cast<int>(guard.process(coords, 55000)));
+    TEST_ASSERT_EQUAL_UINT32(1, guard.fires());
+}
+
+void test_capture_learns_the_ring() {
+    CoilEventQueue events;
+    VibrationGuard guard(events);
+    guard.configure(COIL, GuardMode::SUBTRACT);
+    learn(guard, events);
+    TEST_ASSERT_TRUE(guard.learned(COIL));
+    const Vec3f* response = guard.response(COIL);
+    for (uint8_t b = 1; b < GUARD_BINS; b++) {             // Bin 0 only sees one side of the kick
+        const Vec3f exact = ring(b * GUARD_BIN_US);
+        TEST_ASSERT_FLOAT_WITHIN(0.3f, exact[0], response[b][0]);
+        TEST_ASSERT_FLOAT_WITHIN(0.3f, exact[2], response[b][2]);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_subtract_replay_cuts_false_nudges);
+    RUN_TEST(test_hold_covers_exactly_the_window_after_each_fire);
+    RUN_TEST(test_sample_taken_before_the_fire_is_untouched);
+    RUN_TEST(test_capture_learns_the_ring);
+    return UNITY_END();
+}
@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""
+Host-side stand-in for a DOF/LedWiz sender.
+
+Streams HostOutput batch reports to the controller as fast as the USB stack
+accepts them and prints the achieved report and port-update rates. The
+controller side reports receipt-to-output latency via
+HostOutputHID::printStats(), and coil energise latency via
+CoilScheduler::printStats().
+
+    pip install hidapi
+    python tools/host_output_sender.py --ports 32 --seconds 5
+"""
+import argparse
+import time
+
+import hid
+
+REPORT_ID = 0x10
+REPORT_LEN = 63
+CMD_LEDWIZ = 0x01
+CMD_BATCH = 0x02
+MAX_BATCH = (REPORT_LEN - 2) // 2
+
+
+def batch_report(updates):
+    """updates: list of (port, level) -> HID output report bytes."""
+    payload = [CMD_BATCH, len(updates)]
+    for port, level in updates:
+        payload += [port, level]
+    payload += [0] * (REPORT_LEN - len(payload))
+    return bytes([REPORT_ID] + payload)
+
+
+def ledwiz_report(message):
+    """Wrap a raw 8-byte LedWiz SBA/PBA message."""
+    payload = [CMD_LEDWIZ] + list(message)
+    payload += [0] * (REPORT_LEN - len(payload))
+    return bytes([REPORT_ID] + payload)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--vid", type=lambda s: int(s, 0), default=0x303A)
+    parser.add_argument("--pid", type=lambda s: int(s, 0), default=0x1001)
+    parser.add_argument("--ports", type=int, default=32, help="ports updated per report (max %d)" % MAX_BATCH)
+    parser.add_argument("--seconds", type=float, default=5.0)
+    args = parser.parse_args()
+
+    ports = min(args.ports, MAX_BATCH)
+    dev = hid.device()
+    dev.open(args.vid, args.pid)
+
+    # Switch all LedWiz ports on at full brightness first
+    dev.write(ledwiz_report([64, 0xFF, 0xFF, 0xFF, 0xFF, 2, 0, 0]))
+
+    reports = 0
+    start = time.perf_counter()
+    while time.perf_counter() - start < args.seconds:
+        level = reports & 0xFF
+        dev.write(batch_report([(p, level) for p in range(ports)]))
+        reports += 1
+    elapsed = time.perf_counter() - start
+
+    dev.write(batch_report([(p, 0) for p in range(ports)]))
+    dev.close()
+    print("%d reports in %.2f s: %.0f reports/s, %.0f updates/s"
+          % (reports, elapsed, reports / elapsed, reports * ports / elapsed))
+
+
+if __name__ == "__main__":
+    main()